@@ -16,6 +16,13 @@
 # SKIP_STRIPPING=true
 #  Do not strip output binaries
 
+# WITH_LTO=true
+#  Enable link-time optimization
+
+# SKIP_CPU_DISPATCH=true
+#  Build only the generic ISA variant of functions marked for runtime CPU dispatch
+#  See distrho/extra/CpuDispatch.hpp for details
+
 # NVG_DISABLE_SKIPPING_WHITESPACE=true
 #  Tweak `nvgTextBreakLines` to allow space characters
 #  FIXME proper details
@@ -343,6 +350,10 @@ LINK_OPTS  += -Werror=lto-type-mismatch
 endif
 endif
 
+ifeq ($(SKIP_CPU_DISPATCH),true)
+BASE_FLAGS += -DDISTRHO_NO_CPU_DISPATCH
+endif
+
 BUILD_C_FLAGS   = $(BASE_FLAGS) -std=gnu99 $(CFLAGS)
 BUILD_CXX_FLAGS = $(BASE_FLAGS) -std=gnu++11 $(CXXFLAGS)
 LINK_FLAGS      = $(LINK_OPTS) $(LDFLAGS)
@@ -11,10 +11,22 @@
 # - DPF_TARGET_DIR: where to place final binary files
 # - UI_TYPE: one of cairo, external, gles2, gles3, opengl, opengl3 or webview, with opengl being default
 #            ("generic" is also allowed if only using basic DPF classes like image widgets)
+# - USE_STATIC_METADATA: set to true to generate plugin metadata at build time,
+#                        so that VST3 and CLAP host scans do not need to create a plugin instance
+#                        (ignored when cross-compiling without EXE_WRAPPER)
+# - DPF_TRACING: set to true to record a per-instance timeline of processing and parameter/state/UI events,
+#                written as Chrome trace JSON files into $DPF_TRACE_DIR (or the system temporary directory)
+# - DPF_RT_SAFETY_CHECKS: set to true to report memory allocations and mutex locks done from the audio thread,
+#                         printed to stderr together with a backtrace (debug builds only, adds overhead)
 
 # override the "all" target after including this file to define which plugin formats to build, like so:
 # all: au clap jack lv2_sep vst2 vst3
 
+# the "bench" target builds a headless tool that runs the plugin DSP with configurable sample rates, block sizes,
+# MIDI densities and automation patterns, reporting processing times and audio thread allocations as JSON.
+# it is not part of any plugin format, so it is meant to be built on demand, like so:
+# make bench && ./bin/$(NAME)-bench --block-sizes 64,512 --automation none,step
+
 # NOTE the "lv2" target refers to a monolithic build (dsp and ui combined),
 #      while "lv2_sep" target has dsp and ui in separate binaries.
 #      use of this target must match the definition of `DISTRHO_PLUGIN_WANT_DIRECT_ACCESS`
@@ -375,6 +387,7 @@ else
 jack       = $(TARGET_DIR)/$(NAME)$(APP_EXT)
 endif
 
+bench      = $(TARGET_DIR)/$(NAME)-bench$(APP_EXT)
 clap       = $(TARGET_DIR)/$(CLAP_FILENAME)
 dssi_dsp   = $(TARGET_DIR)/$(NAME)-dssi$(LIB_EXT)
 dssi_ui    = $(TARGET_DIR)/$(NAME)-dssi/$(NAME)_ui$(APP_EXT)
@@ -402,6 +415,28 @@ ifeq ($(WASM),true)
 jackfiles += $(TARGET_DIR)/$(NAME).html
 endif
 
+# files generated at build time by running the export tool, which needs an exe wrapper when cross-compiling
+ifneq ($(CROSS_COMPILING),true)
+CAN_RUN_EXPORT_TOOL = true
+else ifneq ($(EXE_WRAPPER),)
+CAN_RUN_EXPORT_TOOL = true
+endif
+
+# moduleinfo.json lets VST3 hosts scan the plugin without loading its binary
+ifeq ($(CAN_RUN_EXPORT_TOOL),true)
+ifneq ($(VST3_FILENAME),)
+vst3files += $(TARGET_DIR)/$(NAME).vst3/Contents/Resources/moduleinfo.json
+endif
+endif
+
+# without static metadata the plugin still works, host scans just need to create a plugin instance
+ifeq ($(USE_STATIC_METADATA),true)
+ifneq ($(CAN_RUN_EXPORT_TOOL),true)
+$(warning USE_STATIC_METADATA needs to run the export tool, which is not possible when cross-compiling without EXE_WRAPPER, disabling it)
+USE_STATIC_METADATA = false
+endif
+endif
+
 ifneq ($(HAVE_DGL),true)
 dssi_ui =
 lv2_ui =
@@ -466,6 +501,20 @@ ifeq ($(DPF_RUNTIME_TESTING),true)
 BUILD_CXX_FLAGS += -DDPF_RUNTIME_TESTING -Wno-pmf-conversions
 endif
 
+# ---------------------------------------------------------------------------------------------------------------------
+# Tracing build
+
+ifeq ($(DPF_TRACING),true)
+BUILD_CXX_FLAGS += -DDPF_TRACING
+endif
+
+# ---------------------------------------------------------------------------------------------------------------------
+# Realtime-safety checks build
+
+ifeq ($(DPF_RT_SAFETY_CHECKS),true)
+BUILD_CXX_FLAGS += -DDPF_RT_SAFETY_CHECKS
+endif
+
 # ---------------------------------------------------------------------------------------------------------------------
 # all needs to be first
 
@@ -560,7 +609,7 @@ $(BUILD_DIR)/DistrhoPluginMain_%_single_obj.cpp.o: $(DPF_PATH)/distrho/DistrhoPl
 $(BUILD_DIR)/DistrhoPluginMain_%.cpp.o: $(DPF_PATH)/distrho/DistrhoPluginMain.cpp $(EXTRA_DEPENDENCIES) $(EXTRA_DSP_DEPENDENCIES)
 	-@mkdir -p $(BUILD_DIR)
 	@echo "Compiling DistrhoPluginMain.cpp ($*)"
-	$(SILENT)$(CXX) $< $(BUILD_CXX_FLAGS) -DDISTRHO_PLUGIN_TARGET_$* -c -o $@
+	$(SILENT)$(CXX) $< $(BUILD_CXX_FLAGS) $(STATIC_METADATA_FLAGS_$*) -DDISTRHO_PLUGIN_TARGET_$* -c -o $@
 
 $(BUILD_DIR)/DistrhoUIMain_%_single_obj.cpp.o: $(DPF_PATH)/distrho/DistrhoUIMain.cpp $(EXTRA_DEPENDENCIES) $(EXTRA_UI_DEPENDENCIES)
 	-@mkdir -p $(BUILD_DIR)
@@ -604,6 +653,16 @@ endif
 	@echo "Creating JACK standalone for $(NAME)"
 	$(SILENT)$(CXX) $^ $(BUILD_CXX_FLAGS) $(LINK_FLAGS) $(EXTRA_LIBS) $(EXTRA_DSP_LIBS) $(EXTRA_UI_LIBS) $(DGL_LIBS) $(JACK_LIBS) -o $@
 
+# ---------------------------------------------------------------------------------------------------------------------
+# Benchmark
+
+bench: $(bench)
+
+$(bench): $(OBJS_DSP) $(BUILD_DIR)/DistrhoPluginMain_BENCH.cpp.o
+	-@mkdir -p $(shell dirname $@)
+	@echo "Creating benchmark tool for $(NAME)"
+	$(SILENT)$(CXX) $^ $(BUILD_CXX_FLAGS) $(LINK_FLAGS) $(EXTRA_LIBS) $(EXTRA_DSP_LIBS) -o $@
+
 # ---------------------------------------------------------------------------------------------------------------------
 # LADSPA
 
@@ -889,10 +948,28 @@ endif
 # ---------------------------------------------------------------------------------------------------------------------
 # auto-generated format-specific files
 
+ifeq ($(USE_STATIC_METADATA),true)
+$(BUILD_DIR)/DistrhoPluginMain_CLAP.cpp.o: $(BUILD_DIR)/DistrhoPluginStaticMetadata.h
+$(BUILD_DIR)/DistrhoPluginMain_VST3.cpp.o: $(BUILD_DIR)/DistrhoPluginStaticMetadata.h
+
+# not target-specific flags, as those would be inherited by the export tool needed to generate the header
+STATIC_METADATA_FLAGS_CLAP = -DDISTRHO_PLUGIN_HAS_STATIC_METADATA=1 -I$(BUILD_DIR)
+STATIC_METADATA_FLAGS_VST3 = -DDISTRHO_PLUGIN_HAS_STATIC_METADATA=1 -I$(BUILD_DIR)
+
+$(BUILD_DIR)/DistrhoPluginStaticMetadata.h: $(BUILD_DIR)/export$(APP_EXT)
+	-@mkdir -p $(shell dirname $@)
+	@echo "Generating static metadata for $(NAME)"
+	$(SILENT)$(EXE_WRAPPER) $(abspath $<) --static-metadata $@
+endif
+
 $(TARGET_DIR)/$(NAME).component/Contents/Info.plist: $(BUILD_DIR)/export$(APP_EXT)
 	-@mkdir -p $(shell dirname $@)
 	cd $(TARGET_DIR)/$(NAME).component/Contents && $(abspath $<) "$(NAME)"
 
+$(TARGET_DIR)/$(NAME).vst3/Contents/Resources/moduleinfo.json: $(BUILD_DIR)/export$(APP_EXT)
+	-@mkdir -p $(shell dirname $@)
+	cd $(TARGET_DIR)/$(NAME).vst3/Contents/Resources && $(EXE_WRAPPER) $(abspath $<) --vst3-moduleinfo "$(NAME)"
+
 # ---------------------------------------------------------------------------------------------------------------------
 
 -include $(OBJS_DSP:%.o=%.d)
@@ -901,6 +978,7 @@ ifneq ($(UI_TYPE),)
 endif
 
 -include $(BUILD_DIR)/DistrhoPluginMain_AU.cpp.d
+-include $(BUILD_DIR)/DistrhoPluginMain_BENCH.cpp.d
 -include $(BUILD_DIR)/DistrhoPluginMain_CLAP.cpp.d
 -include $(BUILD_DIR)/DistrhoPluginMain_DSSI.cpp.d
 -include $(BUILD_DIR)/DistrhoPluginMain_Export.cpp.d
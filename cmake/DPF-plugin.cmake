@@ -37,6 +37,20 @@
 # Important: note that properties, such as include directories, definitions,
 # and linked libraries *must* be marked with `PUBLIC` so they take effect and
 # propagate into all the plugin targets.
+#
+# Link-time optimization can be enabled for all DPF targets by setting the
+# `DPF_WITH_LTO` variable before adding plugins.
+#
+# Runtime CPU dispatch (see `distrho/extra/CpuDispatch.hpp`) is enabled by
+# default, set the `DPF_SKIP_CPU_DISPATCH` variable to build only the generic
+# ISA variant of dispatched functions.
+#
+# Set the `DPF_TRACING` variable to record a per-instance timeline of
+# processing and parameter/state/UI events, written as Chrome trace JSON files
+# into `$DPF_TRACE_DIR` (or the system temporary directory).
+#
+# Set the `DPF_RT_SAFETY_CHECKS` variable to report memory allocations and
+# mutex locks done from the audio thread, meant for debug builds only.
 
 include(CMakeParseArguments)
 
@@ -73,6 +87,7 @@ include(CMakeParseArguments)
 #   `TARGETS` <tgt1>...<tgtN>
 #       a list of one of more of the following target types:
 #       `jack`, `ladspa`, `dssi`, `lv2`, `vst2`, `vst3`, `clap`
+#       the `bench` target type builds a headless DSP benchmark tool, reporting results as JSON
 #
 #   `UI_TYPE` <type>
 #       the user interface type, can be one of the following:
@@ -116,8 +131,11 @@ include(CMakeParseArguments)
 #   `USE_WEB_VIEW`
 #       enable web browser view APIs
 #
+#   `STATIC_METADATA`
+#       generate plugin metadata at build time, so VST3 and CLAP host scans do not create a plugin instance
+#
 function(dpf_add_plugin NAME)
-  set(options MONOLITHIC NO_SHARED_RESOURCES FORCE_NATIVE_AUDIO_FALLBACK SKIP_NATIVE_AUDIO_FALLBACK USE_FILE_BROWSER USE_WEB_VIEW)
+  set(options MONOLITHIC NO_SHARED_RESOURCES FORCE_NATIVE_AUDIO_FALLBACK SKIP_NATIVE_AUDIO_FALLBACK USE_FILE_BROWSER USE_WEB_VIEW STATIC_METADATA)
   set(oneValueArgs MODGUI_CLASS_NAME UI_TYPE)
   set(multiValueArgs FILES_COMMON FILES_DSP FILES_UI TARGETS)
   cmake_parse_arguments(_dpf_plugin "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
@@ -245,6 +263,8 @@ function(dpf_add_plugin NAME)
                       "${_dpf_plugin_FORCE_NATIVE_AUDIO_FALLBACK}"
                       "${_dpf_plugin_SKIP_NATIVE_AUDIO_FALLBACK}"
                       "${_dpf_plugin_USE_FILE_BROWSER}")
+    elseif(_target STREQUAL "bench")
+      dpf__build_bench("${NAME}")
     elseif(_target STREQUAL "ladspa")
       dpf__build_ladspa("${NAME}")
     elseif(_target STREQUAL "dssi")
@@ -255,8 +275,14 @@ function(dpf_add_plugin NAME)
       dpf__build_vst2("${NAME}" "${_dgl_has_ui}" "${_dpf_plugin_shared_crt}")
     elseif(_target STREQUAL "vst3")
       dpf__build_vst3("${NAME}" "${_dgl_has_ui}" "${_dpf_plugin_shared_crt}")
+      if(_dpf_plugin_STATIC_METADATA)
+        dpf__add_static_metadata("${NAME}" "vst3" "${_dgl_has_ui}")
+      endif()
     elseif(_target STREQUAL "clap")
       dpf__build_clap("${NAME}" "${_dgl_has_ui}" "${_dpf_plugin_shared_crt}")
+      if(_dpf_plugin_STATIC_METADATA)
+        dpf__add_static_metadata("${NAME}" "clap" "${_dgl_has_ui}")
+      endif()
     elseif(_target STREQUAL "au")
       if (APPLE)
         dpf__build_au("${NAME}" "${_dgl_has_ui}")
@@ -496,6 +522,22 @@ function(dpf__build_jack NAME HAS_UI FORCE_NATIVE_AUDIO_FALLBACK SKIP_NATIVE_AUD
   endif()
 endfunction()
 
+# dpf__build_bench
+# ------------------------------------------------------------------------------
+#
+# Add build rules for the headless DSP benchmark tool.
+#
+function(dpf__build_bench NAME)
+  dpf__create_dummy_source_list(_no_srcs)
+
+  dpf__add_executable("${NAME}-bench" ${_no_srcs})
+  dpf__add_plugin_main("${NAME}-bench" "bench")
+  target_link_libraries("${NAME}-bench" PRIVATE "${NAME}-dsp")
+  set_target_properties("${NAME}-bench" PROPERTIES
+    RUNTIME_OUTPUT_DIRECTORY "${PROJECT_BINARY_DIR}/bin/$<0:>"
+    OUTPUT_NAME "${NAME}-bench")
+endfunction()
+
 # dpf__build_ladspa
 # ------------------------------------------------------------------------------
 #
@@ -726,6 +768,17 @@ function(dpf__build_vst3 NAME HAS_UI EXTRA_UI_LINK_OPTS)
       LIBRARY_OUTPUT_DIRECTORY "${PROJECT_BINARY_DIR}/bin/${NAME}.vst3/Contents/${vst3_arch}-linux/$<0:>")
   endif()
 
+  # moduleinfo.json lets VST3 hosts scan the plugin without loading its binary
+  dpf__add_export_tool("${NAME}" "${HAS_UI}")
+  add_dependencies("${NAME}-vst3" "${NAME}-export")
+
+  file(MAKE_DIRECTORY "${PROJECT_BINARY_DIR}/bin/${NAME}.vst3/Contents/Resources")
+  separate_arguments(CMAKE_CROSSCOMPILING_EMULATOR)
+
+  add_custom_command(TARGET "${NAME}-vst3" POST_BUILD
+    COMMAND ${CMAKE_CROSSCOMPILING_EMULATOR} "$<TARGET_FILE:${NAME}-export>" --vst3-moduleinfo "${NAME}"
+    WORKING_DIRECTORY "${PROJECT_BINARY_DIR}/bin/${NAME}.vst3/Contents/Resources")
+
   if(APPLE)
     # Uses the same macOS bundle template as VST2
     set(INFO_PLIST_PROJECT_NAME "${NAME}")
@@ -799,10 +852,7 @@ function(dpf__build_au NAME HAS_UI)
     PREFIX ""
     SUFFIX "")
 
-  dpf__add_executable("${NAME}-export" ${_no_srcs})
-  dpf__add_plugin_main("${NAME}-export" "export")
-  dpf__add_ui_main("${NAME}-export" "export" "${HAS_UI}")
-  target_link_libraries("${NAME}-export" PRIVATE "${NAME}-dsp" "${NAME}-ui")
+  dpf__add_export_tool("${NAME}" "${HAS_UI}")
 
   separate_arguments(CMAKE_CROSSCOMPILING_EMULATOR)
 
@@ -816,6 +866,59 @@ function(dpf__build_au NAME HAS_UI)
     DESTINATION "${PROJECT_BINARY_DIR}/bin/${NAME}.component/Contents")
 endfunction()
 
+# dpf__add_export_tool
+# ------------------------------------------------------------------------------
+#
+# Add build rules for the export tool, used to generate files at build time.
+# The tool is shared between all targets of the same plugin.
+#
+function(dpf__add_export_tool NAME HAS_UI)
+  if(TARGET "${NAME}-export")
+    return()
+  endif()
+
+  dpf__create_dummy_source_list(_no_srcs)
+
+  dpf__add_executable("${NAME}-export" ${_no_srcs})
+  dpf__add_plugin_main("${NAME}-export" "export")
+  dpf__add_ui_main("${NAME}-export" "export" "${HAS_UI}")
+  target_link_libraries("${NAME}-export" PRIVATE "${NAME}-dsp" "${NAME}-ui")
+endfunction()
+
+# dpf__add_static_metadata
+# ------------------------------------------------------------------------------
+#
+# Make a plugin target use metadata generated at build time by the export tool.
+#
+function(dpf__add_static_metadata NAME TARGET HAS_UI)
+  # the export tool needs to run on the build machine, without static metadata host scans just create a plugin instance
+  if(CMAKE_CROSSCOMPILING AND NOT CMAKE_CROSSCOMPILING_EMULATOR)
+    message(WARNING "STATIC_METADATA needs to run the export tool, which is not possible when cross-compiling without CMAKE_CROSSCOMPILING_EMULATOR, disabling it for ${NAME}-${TARGET}")
+    return()
+  endif()
+
+  dpf__add_export_tool("${NAME}" "${HAS_UI}")
+
+  set(_metadata_dir "${PROJECT_BINARY_DIR}/obj/${NAME}-metadata")
+
+  if(NOT TARGET "${NAME}-metadata")
+    separate_arguments(CMAKE_CROSSCOMPILING_EMULATOR)
+
+    add_custom_command(OUTPUT "${_metadata_dir}/DistrhoPluginStaticMetadata.h"
+      COMMAND "${CMAKE_COMMAND}" -E make_directory "${_metadata_dir}"
+      COMMAND ${CMAKE_CROSSCOMPILING_EMULATOR} "$<TARGET_FILE:${NAME}-export>" --static-metadata
+              "${_metadata_dir}/DistrhoPluginStaticMetadata.h"
+      DEPENDS "${NAME}-export")
+
+    add_custom_target("${NAME}-metadata"
+      DEPENDS "${_metadata_dir}/DistrhoPluginStaticMetadata.h")
+  endif()
+
+  add_dependencies("${NAME}-${TARGET}" "${NAME}-metadata")
+  target_compile_definitions("${NAME}-${TARGET}" PRIVATE "DISTRHO_PLUGIN_HAS_STATIC_METADATA=1")
+  target_include_directories("${NAME}-${TARGET}" PRIVATE "${_metadata_dir}")
+endfunction()
+
 # dpf__build_static
 # ------------------------------------------------------------------------------
 #
@@ -1640,6 +1743,19 @@ function(dpf__set_target_defaults NAME)
   if ((NOT APPLE) AND (NOT EMSCRIPTEN) AND (NOT MSVC))
     target_link_options("${NAME}" PUBLIC "-Wl,--no-undefined")
   endif()
+  if (DPF_WITH_LTO)
+    set_target_properties("${NAME}" PROPERTIES
+      INTERPROCEDURAL_OPTIMIZATION TRUE)
+  endif()
+  if (DPF_SKIP_CPU_DISPATCH)
+    target_compile_definitions("${NAME}" PUBLIC "DISTRHO_NO_CPU_DISPATCH")
+  endif()
+  if (DPF_TRACING)
+    target_compile_definitions("${NAME}" PUBLIC "DPF_TRACING")
+  endif()
+  if (DPF_RT_SAFETY_CHECKS)
+    target_compile_definitions("${NAME}" PUBLIC "DPF_RT_SAFETY_CHECKS")
+  endif()
 endfunction()
 
 # dpf__add_plugin_main
@@ -144,6 +144,16 @@ static constexpr const uint32_t kParameterIsTrigger = 0x20 | kParameterIsBoolean
  */
 static constexpr const uint32_t kParameterIsHidden = 0x40;
 
+/**
+   Parameter changes are smoothed by DPF.@n
+   Every change to the parameter value starts a linear ramp towards it, lasting Parameter::smoothingTime,
+   and the per-frame values of the ramp are available during run() through Plugin::getParameterRamp().@n
+   Cannot be used for output, boolean or integer parameters.
+
+   @note Only used when DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING is enabled.
+*/
+static constexpr const uint32_t kParameterIsSmoothed = 0x80;
+
 /** @} */
 
 /* --------------------------------------------------------------------------------------------------------------------
@@ -665,6 +675,12 @@ struct Parameter {
     */
     uint32_t groupId;
 
+   /**
+      Duration of the ramp to a new value, in seconds.@n
+      Only used for parameters with the @ref kParameterIsSmoothed hint, defaults to 20ms.
+    */
+    float smoothingTime;
+
    /**
       Default constructor for a null parameter.
     */
@@ -679,7 +695,8 @@ struct Parameter {
           enumValues(),
           designation(kParameterDesignationNull),
           midiCC(0),
-          groupId(kPortGroupNone) {}
+          groupId(kPortGroupNone),
+          smoothingTime(0.02f) {}
 
    /**
       Constructor using custom values.
@@ -695,7 +712,8 @@ struct Parameter {
           enumValues(),
           designation(kParameterDesignationNull),
           midiCC(0),
-          groupId(kPortGroupNone) {}
+          groupId(kPortGroupNone),
+          smoothingTime(0.02f) {}
 
 #ifdef DISTRHO_PROPER_CPP11_SUPPORT
    /**
@@ -714,7 +732,8 @@ struct Parameter {
           enumValues(evcount, true, ev),
           designation(kParameterDesignationNull),
           midiCC(0),
-          groupId(kPortGroupNone) {}
+          groupId(kPortGroupNone),
+          smoothingTime(0.02f) {}
 #endif
 
    /**
@@ -767,6 +786,7 @@ struct Parameter {
          designation = other.designation;
          midiCC = other.midiCC;
          groupId = other.groupId;
+         smoothingTime = other.smoothingTime;
 
          // enumValues needs special handling
          enumValues.count = other.enumValues.count;
@@ -792,6 +812,7 @@ struct Parameter {
          designation = other.designation;
          midiCC = other.midiCC;
          groupId = other.groupId;
+         smoothingTime = other.smoothingTime;
 
          // make sure to not delete data twice
          DISTRHO_SAFE_ASSERT_RETURN(other.enumValues.values == nullptr || !other.enumValues.deleteLater, *this);
@@ -1075,6 +1096,52 @@ struct TimePosition {
     }
 };
 
+/**
+   DSP load statistics.@n
+   Load values are a share of the real-time budget of each audio block, that is, the time spent in Plugin::run()
+   divided by the duration of the audio it processed. A value of 1.0 means the whole budget was used.
+
+   Statistics cover a rolling window of the most recent audio blocks.
+   @see DISTRHO_PLUGIN_WANT_DSP_LOAD
+ */
+struct DspLoad {
+   /**
+      Lowest load within the window.
+    */
+    float minimum;
+
+   /**
+      Average load within the window.
+    */
+    float average;
+
+   /**
+      99th percentile of the load within the window.
+    */
+    float p99;
+
+   /**
+      Highest load within the window.
+    */
+    float maximum;
+
+   /**
+      Number of audio blocks within the window.@n
+      All values are 0 when this is 0.
+    */
+    uint32_t blockCount;
+
+   /**
+      Default constructor for empty statistics.
+    */
+    DspLoad() noexcept
+        : minimum(0.0f),
+          average(0.0f),
+          p99(0.0f),
+          maximum(0.0f),
+          blockCount(0) {}
+};
+
 /** @} */
 
 // --------------------------------------------------------------------------------------------------------------------
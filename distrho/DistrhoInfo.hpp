@@ -505,6 +505,16 @@ START_NAMESPACE_DISTRHO
  */
 #define DISTRHO_PLUGIN_URI "urn:distrho:name"
 
+/**
+   Whether the plugin is built with metadata generated at build time.@n
+   This macro is not meant to be set in the "DistrhoPluginInfo.h" file, the build system defines it instead,
+   when using `USE_STATIC_METADATA=true` in Makefile-based builds or the `STATIC_METADATA` option of `dpf_add_plugin` in CMake.@n
+   The export tool then creates a plugin instance once during the build and writes its name, maker, version and unique id into a generated header.
+   The VST3 and CLAP entry points answer host scans from that data, without creating a dummy plugin instance when the binary is loaded.
+   @note Plugins whose metadata changes at runtime (for example depending on the environment) must not use this.
+ */
+#define DISTRHO_PLUGIN_HAS_STATIC_METADATA 1
+
 /**
    Whether the plugin has a custom %UI.
    @see DISTRHO_UI_USE_NANOVG
@@ -525,12 +535,55 @@ START_NAMESPACE_DISTRHO
  */
 #define DISTRHO_PLUGIN_IS_SYNTH 1
 
+/**
+   Number of frames the plugin always processes at once, or 0 (the default) to use whatever the host gives.@n
+   When set, DPF buffers audio and MIDI in a FIFO and calls run() only with blocks of exactly this size,
+   regardless of the host buffer size.@n
+   MIDI event frames are kept relative to the block passed to run(),
+   and MIDI output is delayed by the same amount as the audio.@n
+   The buffering adds a latency of this many frames, which DPF reports to the host together with the plugin's own.
+   For this reason setting this macro also enables @ref DISTRHO_PLUGIN_WANT_LATENCY.
+   @note Sample-accurate parameter changes are applied at the start of the next block to run,
+         and MIDI events with external data (bigger than MidiEvent::kDataSize) are dropped.
+ */
+#define DISTRHO_PLUGIN_FIXED_BLOCK_SIZE 256
+
 /**
    Request the minimum buffer size for the input and output event ports.@n
    Currently only used in LV2, with a default value of 2048 if unset.
  */
 #define DISTRHO_PLUGIN_MINIMUM_BUFFER_SIZE 2048
 
+/**
+   Maximum number of MIDI events the plugin can receive per audio block, with a default value of 2048 if unset.@n
+   This is the size of the buffer format wrappers collect host events into, events sent by the host past it are dropped.@n
+   Increase it if your plugin needs to handle very dense MIDI streams, such as MPE or high-resolution controllers.
+   @note Every plugin format wrapper keeps a fixed buffer of this size, so do not set it higher than needed.
+   @see DISTRHO_PLUGIN_MAX_MIDI_EVENTS_PER_RUN
+ */
+#define DISTRHO_PLUGIN_MAX_MIDI_EVENTS 2048
+
+/**
+   Maximum number of MIDI events passed to a single run() call, with a default value of 512 if unset
+   (or @ref DISTRHO_PLUGIN_MAX_MIDI_EVENTS if that is lower).@n
+   When a block contains more events than this, DPF splits it at event boundaries and calls run() multiple times,
+   with audio buffers, MIDI event frames and time position adjusted to each sub-block.@n
+   This lets plugins size their internal event buffers to a small value while still accepting dense MIDI input.@n
+   If more events than this share the same frame, DPF calls run() with 0 frames and only MIDI events
+   until the remaining ones fit, so no event is ever dropped or delayed.
+   @note Only used when @ref DISTRHO_PLUGIN_WANT_MIDI_INPUT is enabled.
+ */
+#define DISTRHO_PLUGIN_MAX_MIDI_EVENTS_PER_RUN 512
+
+/**
+   Number of temporary audio buffers the plugin can get from DPF during run(), or 0 (the default) for none.@n
+   DPF keeps a single block of cache-line aligned memory per instance, big enough for this many buffers of
+   Plugin::getBufferSize() frames, and hands it out with Plugin::getScratchBuffer(uint32_t).@n
+   This saves plugins from allocating their own temporary buffers in activate() or bufferSizeChanged().
+   The same memory is also used by format wrappers that need a temporary buffer of their own.
+ */
+#define DISTRHO_PLUGIN_SCRATCH_BUFFER_COUNT 2
+
 /**
    Whether the plugin has an LV2 modgui.
 
@@ -547,6 +600,27 @@ START_NAMESPACE_DISTRHO
  */
 #define DISTRHO_PLUGIN_WANT_DIRECT_ACCESS 0
 
+/**
+   Whether the plugin can process 64-bit (double precision) audio.@n
+   When enabled, the plugin must implement an extra run() function that takes double audio buffers,
+   which hosts with a 64-bit mixing engine can call directly without converting audio to float and back.
+   @note Only VST2, VST3 and CLAP formats support 64-bit audio processing,
+         other formats always use the regular float run() function.
+ */
+#define DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION 1
+
+/**
+   Whether the plugin wants DPF to measure its DSP load.@n
+   When enabled, every run() call is timed with a monotonic clock and compared against the real-time budget of the block,
+   that is, the number of frames divided by the host sample rate.@n
+   Minimum, average, 99th percentile and maximum load over the most recent blocks can then be read at any time,
+   without locking, from Plugin::getDspLoad() or, together with @ref DISTRHO_PLUGIN_WANT_DIRECT_ACCESS, UI::getDspLoad().@n
+   The JACK standalone prints these values when receiving the SIGUSR1 signal (not available on Windows).
+   @note The measurement includes work done by DPF around run(), like oversampling and fixed-size block buffering.
+   @see DspLoad
+ */
+#define DISTRHO_PLUGIN_WANT_DSP_LOAD 1
+
 /**
    Whether the plugin introduces latency during audio or midi processing.
    @see Plugin::setLatency(uint32_t)
@@ -571,6 +645,66 @@ START_NAMESPACE_DISTRHO
  */
 #define DISTRHO_PLUGIN_WANT_MIDI_OUTPUT 1
 
+/**
+   Whether the plugin wants to know about offline processing in LV2 hosts.@n
+   LV2 reports it through a control port, which DPF adds after all parameter ports when this is enabled.
+   It is opt-in so that existing plugins keep their LV2 port layout.@n
+   VST3 and CLAP hosts report the processing mode without extra ports, so Plugin::isOffline() works there regardless.
+   @note LV2 UIs need the host to provide ui:portMap to tell this port apart from parameters.
+   @see Plugin::isOffline()
+   @see Plugin::processModeChanged(bool)
+ */
+#define DISTRHO_PLUGIN_WANT_OFFLINE_MODE 1
+
+/**
+   Whether the plugin wants DPF to run it at a higher sample rate than the host.@n
+   When enabled, audio is upsampled before run() and downsampled after it, using polyphase half-band filters.@n
+   The plugin sees the oversampled rate and buffer size in Plugin::getSampleRate() and Plugin::getBufferSize(),
+   and MIDI event frames are scaled to match.@n
+   The filters add some latency, which is reported to the host together with the plugin's own.@n
+   Latency and tail length set by the plugin are in oversampled frames too, DPF converts them for the host.
+   For this reason enabling this macro also enables @ref DISTRHO_PLUGIN_WANT_LATENCY.
+   @note Factor changes made while the plugin is active are only applied once the host deactivates it.
+   @see DISTRHO_PLUGIN_OVERSAMPLING_FACTOR
+   @see Plugin::setOversamplingFactor(uint32_t)
+ */
+#define DISTRHO_PLUGIN_WANT_OVERSAMPLING 1
+
+/**
+   The oversampling factor used when the plugin is created, must be 1, 2, 4 or 8.@n
+   Defaults to 2 when @ref DISTRHO_PLUGIN_WANT_OVERSAMPLING is enabled.
+ */
+#define DISTRHO_PLUGIN_OVERSAMPLING_FACTOR 2
+
+/**
+   Whether the plugin wants to split its processing across multiple threads.@n
+   When enabled, the plugin can call Plugin::executeParallel() during run() to process independent tasks,
+   like voices or bands, concurrently.@n
+   CLAP uses the host-provided thread pool when available.
+   All other formats, and CLAP hosts without a thread pool, use a single DPF-managed pool of realtime threads
+   shared by every plugin instance in the process, created when the first instance is activated.@n
+   Tasks run one after the other on the calling thread while another instance is using that pool.
+   @see Plugin::executeParallel(uint32_t, ParallelTaskFunc, void*)
+ */
+#define DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION 1
+
+/**
+   Whether the plugin reports changes to its parameter outputs.@n
+   When enabled, the plugin must use Plugin::setOutputParameterValue(uint32_t, float) to update its outputs,
+   which lets DPF keep track of what changed since the last run() instead of checking every output and trigger each time.@n
+   The values are stored by DPF, so Plugin::getParameterValue(uint32_t) is never called for parameter outputs.
+ */
+#define DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING 1
+
+/**
+   Whether the plugin wants DPF to smooth changes of some of its parameter inputs.@n
+   When enabled, parameters with the @ref kParameterIsSmoothed hint get a linear ramp towards every new value,
+   lasting Parameter::smoothingTime, no matter if the change comes from the host, the %UI or a program.@n
+   During run() the plugin can read the per-frame values of the ramp with Plugin::getParameterRamp(uint32_t),
+   while Plugin::setParameterValue(uint32_t, float) still receives the target value as usual.
+ */
+#define DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING 1
+
 /**
    Whether the plugin wants to change its own parameter inputs.@n
    Not all hosts or plugin formats support this,
@@ -586,6 +720,45 @@ START_NAMESPACE_DISTRHO
  */
 #define DISTRHO_PLUGIN_WANT_PROGRAMS 1
 
+/**
+   Whether the plugin wants sample-accurate parameter changes.@n
+   When enabled, timestamped parameter changes from the host are applied at their exact frame,
+   by splitting the run() call into smaller blocks at each change point.@n
+   Audio buffers, MIDI events and the time position frame are adjusted for each split block,
+   so the plugin does not need to handle this in any special way.
+   @note Only VST3 and CLAP formats provide timestamped parameter changes,
+         other formats keep applying changes at the start of each block.
+ */
+#define DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS 1
+
+/**
+   Whether all plugin instances in the same process should share their parameter information.@n
+   Parameter names, symbols, units, ranges and enumeration values are the same for every instance of a plugin,
+   so when enabled they are kept in a single read-only list that is filled in by the first instance
+   and released together with the last one.
+   The ranges and hints used while processing, and the symbol lookup used when restoring state, are shared as well.
+   This saves memory and allocations in sessions with many instances of the same plugin.@n
+   Parameter values are not affected, each instance still keeps its own.
+   @note Plugin::initParameter(uint32_t, Parameter&) is only called for the first instance,
+         so it must not depend on or modify any instance data.
+         Instances are only matched by their parameter count, so a plugin whose parameter information depends on
+         constructor arguments or any other per-instance state must not enable this,
+         as every later instance would silently get the information of the first one.
+ */
+#define DISTRHO_PLUGIN_WANT_SHARED_PARAMETERS 1
+
+/**
+   Whether the plugin wants DPF to detect when it is silent.@n
+   When enabled, audio inputs and outputs are checked around each run() call,
+   so that hosts can be told when the plugin is idle and does not need processing until new input arrives.@n
+   The plugin only counts as idle once its input has been silent for at least its tail length and its outputs are silent,
+   so gaps of silence within a tail (like between delay echoes) do not stop processing early.@n
+   Plugins that generate sound on their own without any input (like oscillators or LFO-driven effects) should not enable this.
+   @note Only VST3 and CLAP formats can report silence to the host.
+   @see Plugin::getTailLength()
+ */
+#define DISTRHO_PLUGIN_WANT_SILENCE_DETECTION 1
+
 /**
    Whether the plugin uses internal non-parameter data.
    @see Plugin::initState(uint32_t, String&, String&)
@@ -603,12 +776,33 @@ START_NAMESPACE_DISTRHO
  */
 #define DISTRHO_PLUGIN_WANT_FULL_STATE 1
 
+/**
+   Whether DPF should only change plugin parameter inputs from the audio thread.@n
+   Hosts can set parameters from the main or %UI threads while run() is executing on the audio thread.
+   When enabled, DPF stores such changes in a lock-free list of pending values instead of calling
+   Plugin::setParameterValue(uint32_t, float) right away,
+   and passes them to the plugin in parameter order at the start of the next run() or on activation.@n
+   This way the plugin does not need any locking or atomics around its own parameter values.
+   @note Plugin::loadProgram(uint32_t) and Plugin::setState(const char*, const char*) are not deferred,
+         pending values are discarded when loading a program.
+ */
+#define DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS 1
+
 /**
    Whether the plugin wants time position information from the host.
    @see Plugin::getTimePosition()
  */
 #define DISTRHO_PLUGIN_WANT_TIMEPOS 1
 
+/**
+   Whether the plugin wants to offload non-realtime work from the audio thread.@n
+   When enabled, the plugin can call Plugin::scheduleWork() during run() and must implement Plugin::work().@n
+   LV2 uses the host-provided worker when available.
+   All other formats, and LV2 hosts without worker support, use a DPF-managed thread with lock-free queues.
+   @see Plugin::scheduleWork(const void*, uint32_t)
+ */
+#define DISTRHO_PLUGIN_WANT_WORKER 1
+
 /**
    Whether the %UI uses Cairo for drawing instead of the default OpenGL mode.@n
    When enabled your %UI instance will subclass @ref CairoTopLevelWidget instead of @ref TopLevelWidget.
@@ -714,6 +908,24 @@ START_NAMESPACE_DISTRHO
  */
 #define DISTRHO_PLUGIN_UNIQUE_ID test
 
+/**
+   The name of the plugin class, letting DPF call it directly instead of going through virtual functions.@n
+   The class must be declared as final and @ref DISTRHO_PLUGIN_CLASS_HEADER must be set to the header declaring it.
+   Calls from the plugin wrappers, such as run(), getParameterValue() and setParameterValue(),
+   are then bound at compile time and can be inlined into the per-block loops of each format.@n
+   Overridden functions are called through this class, so they must be accessible to DPF,
+   either by being public or by adding `friend class PluginExporter;` to the class.@n
+   Enabling link-time optimization (`WITH_LTO=true` in Makefile-based builds or `DPF_WITH_LTO` in CMake)
+   also allows inlining when the plugin code lives in a separate source file.
+   @note createPlugin() must return an instance of exactly this class.
+ */
+#define DISTRHO_PLUGIN_CLASS InfoExamplePlugin
+
+/**
+   The header file declaring @ref DISTRHO_PLUGIN_CLASS, included by DPF when building each plugin format.
+ */
+#define DISTRHO_PLUGIN_CLASS_HEADER "InfoExamplePlugin.hpp"
+
 /**
    Custom LV2 category for the plugin.@n
    This is a single string, and can be one of the following values:
@@ -897,6 +1109,18 @@ START_NAMESPACE_DISTRHO
  */
 #define DPF_RUNTIME_TESTING
 
+/**
+   Whether to enable realtime-safety checks.@n
+   This will report, on stderr and with a backtrace, any memory allocation or mutex lock done while processing audio.@n
+   Each offending call site is reported only once.@n
+   Under DPF makefiles this can be enabled by using `make DPF_RT_SAFETY_CHECKS=true`.
+
+   @note Memory allocation and pthread mutex calls are only intercepted on Linux with glibc, and only those done from the plugin binary.
+         Other systems only check DPF's own Mutex and RecursiveMutex classes.
+   @see ScopedRealtimeThread
+ */
+#define DPF_RT_SAFETY_CHECKS
+
 /**
    Whether to show parameter outputs in the VST2 plugins.@n
    This is disabled (unset) by default, as the VST2 format has no notion of read-only parameters.
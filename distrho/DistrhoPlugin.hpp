@@ -90,6 +90,47 @@ public:
     */
     double getSampleRate() const noexcept;
 
+   /**
+      Check if the host is currently rendering offline (bouncing/exporting) instead of processing in real-time.@n
+      Plugins can use this to enable higher-quality algorithms that would be too expensive for real-time use.
+      @note Only VST3, CLAP and LV2 formats can report offline processing, other formats always return false.
+            LV2 also requires @ref DISTRHO_PLUGIN_WANT_OFFLINE_MODE to be enabled.
+      @see processModeChanged(bool)
+    */
+    bool isOffline() const noexcept;
+
+#if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+   /**
+      Get the current oversampling factor.@n
+      The values returned by getBufferSize() and getSampleRate() already include this factor.
+      @note This function is only available if DISTRHO_PLUGIN_WANT_OVERSAMPLING is enabled.
+    */
+    uint32_t getOversamplingFactor() const noexcept;
+
+   /**
+      Change the oversampling factor, which must be 1, 2, 4 or 8.@n
+      This is typically called from setParameterValue(), letting users pick the factor through a parameter.@n
+      The change is applied by deactivating the plugin, calling bufferSizeChanged() and sampleRateChanged()
+      with the new values and activating it again.@n
+      This always happens from the host side, never on the audio thread.
+      While the plugin is inactive it happens on the next activation, buffer size or sample rate change.
+      While the plugin is active the current factor is kept until the host deactivates it.@n
+      Returns false if the factor is not valid.
+      @note This function is only available if DISTRHO_PLUGIN_WANT_OVERSAMPLING is enabled.
+      @see DISTRHO_PLUGIN_OVERSAMPLING_FACTOR
+    */
+    bool setOversamplingFactor(uint32_t factor) noexcept;
+#endif
+
+#if DISTRHO_PLUGIN_WANT_DSP_LOAD
+   /**
+      Get the DSP load statistics of this plugin instance over the most recent audio blocks.@n
+      This function is lock-free and can be called from any thread, including during run().
+      @note This function is only available if DISTRHO_PLUGIN_WANT_DSP_LOAD is enabled.
+    */
+    DspLoad getDspLoad() const noexcept;
+#endif
+
    /**
       Get the bundle path where the plugin resides.
       Can return null if the plugin is not available in a bundle (if it is a single binary).
@@ -162,6 +203,16 @@ public:
     bool requestParameterValueChange(uint32_t index, float value) noexcept;
 #endif
 
+#if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+   /**
+      Set the value of a parameter output.@n
+      Only outputs changed through this function are reported to the host and UI,
+      so it must be used for every parameter output update, typically during run().
+      @note This function is only available if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING is enabled.
+    */
+    void setOutputParameterValue(uint32_t index, float value) noexcept;
+#endif
+
 #if DISTRHO_PLUGIN_WANT_STATE
    /**
       Set state value and notify the host about the change.@n
@@ -175,6 +226,73 @@ public:
     bool updateStateValue(const char* key, const char* value) noexcept;
 #endif
 
+#if DISTRHO_PLUGIN_WANT_WORKER
+   /**
+      Schedule some non-realtime work, which will be received in work() on a separate thread.@n
+      The data is copied, so it can be stack memory or a reused buffer.@n
+      This function must only be called during run(), and @a size must not be higher than 4096 bytes.@n
+      Returns false when the work queue is full.
+      @note This function is only available if DISTRHO_PLUGIN_WANT_WORKER is enabled.
+      @see work(const void*, uint32_t)
+    */
+    bool scheduleWork(const void* data, uint32_t size) noexcept;
+
+   /**
+      Send a response back to the audio thread, which will be received in workResponse() before or after a run().@n
+      The data is copied, and follows the same size limit as scheduleWork().@n
+      This function must only be called during work().
+      @note This function is only available if DISTRHO_PLUGIN_WANT_WORKER is enabled.
+      @see workResponse(const void*, uint32_t)
+    */
+    bool sendWorkResponse(const void* data, uint32_t size) noexcept;
+#endif
+
+#if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+   /**
+      Function type used for parallel tasks, receiving the custom pointer given to executeParallel() and the task index.
+    */
+    typedef void (*ParallelTaskFunc)(void* ptr, uint32_t taskIndex);
+
+   /**
+      Run @a taskCount independent tasks concurrently, calling @a callback once for each task index.@n
+      This function blocks until all tasks are complete, and the calling thread takes part in the processing.@n
+      It must only be called during run(), and never from within a task.@n
+      Tasks are run one after the other on the calling thread when no thread pool is available.
+      @note This function is only available if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION is enabled.
+    */
+    void executeParallel(uint32_t taskCount, ParallelTaskFunc callback, void* ptr) noexcept;
+#endif
+
+#if DISTRHO_PLUGIN_SCRATCH_BUFFER_COUNT != 0
+   /**
+      Get a temporary buffer of @a size floats, aligned to a cache line.@n
+      This function must only be called during run(), and not from parallel tasks.@n
+      The buffer is valid until run() returns, after which its memory is reused, without being cleared first.@n
+      Returns null when not enough scratch memory is left,
+      there is enough for DISTRHO_PLUGIN_SCRATCH_BUFFER_COUNT buffers of getBufferSize() frames.
+      @note This function is only available if DISTRHO_PLUGIN_SCRATCH_BUFFER_COUNT is not 0.
+    */
+    float* getScratchBuffer(uint32_t size) noexcept;
+
+# if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+   /**
+      Same as getScratchBuffer(uint32_t), but for @a size doubles.
+      @note This function is only available if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION is enabled too.
+    */
+    double* getScratchBuffer64(uint32_t size) noexcept;
+# endif
+#endif
+
+#if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+   /**
+      Get the smoothed values of parameter @a index for the current run(), one for each frame.@n
+      This function must only be called during run(), the buffer is overwritten on the next one.@n
+      Returns null if the parameter does not have the @ref kParameterIsSmoothed hint.
+      @note This function is only available if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING is enabled.
+    */
+    const float* getParameterRamp(uint32_t index) const noexcept;
+#endif
+
 protected:
    /* --------------------------------------------------------------------------------------------------------
     * Information */
@@ -334,6 +452,15 @@ protected:
     */
     virtual void setParameterValue(uint32_t index, float value);
 
+   /**
+      Change several parameter values at once.@n
+      Used by the host wrappers when many parameters change together, like on state restore.@n
+      The default implementation calls setParameterValue() for each of the @a count parameters,
+      override it if applying a group of changes is cheaper than applying them one by one.
+      @note This function will only be called for parameter inputs.
+    */
+    virtual void setParameterValues(const uint32_t* indexes, const float* values, uint32_t count);
+
 #if DISTRHO_PLUGIN_WANT_PROGRAMS
    /**
       Load a program.@n
@@ -374,10 +501,21 @@ protected:
     */
     virtual void deactivate() {}
 
+   /**
+      Get the tail length of this plugin, in frames.@n
+      This is how long the plugin keeps producing sound after its input becomes silent,
+      for example the decay time of a reverb or the feedback time of a delay.@n
+      Return 0 for no tail, or UINT32_MAX for an infinite tail.@n
+      The host can call this function at any time, including during run().
+    */
+    virtual uint32_t getTailLength() const { return 0; }
+
 #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
    /**
       Run/process function for plugins with MIDI input.
       @note Some parameters might be null if there are no audio inputs/outputs or MIDI events.
+      @note @a frames can be 0 when more than @ref DISTRHO_PLUGIN_MAX_MIDI_EVENTS_PER_RUN events fall on the same frame,
+            the extra events are then passed in calls without audio, which must still handle every MIDI event.
     */
     virtual void run(const float** inputs, float** outputs, uint32_t frames,
                      const MidiEvent* midiEvents, uint32_t midiEventCount) = 0;
@@ -389,6 +527,44 @@ protected:
     virtual void run(const float** inputs, float** outputs, uint32_t frames) = 0;
 #endif
 
+#if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+# if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+   /**
+      Run/process function for plugins with MIDI input, using 64-bit audio buffers.
+      @note This function is only available if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION is enabled.
+      @note @a frames can be 0 in the same way as the regular run() function.
+    */
+    virtual void run(const double** inputs, double** outputs, uint32_t frames,
+                     const MidiEvent* midiEvents, uint32_t midiEventCount) = 0;
+# else
+   /**
+      Run/process function for plugins without MIDI input, using 64-bit audio buffers.
+      @note This function is only available if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION is enabled.
+    */
+    virtual void run(const double** inputs, double** outputs, uint32_t frames) = 0;
+# endif
+#endif
+
+#if DISTRHO_PLUGIN_WANT_WORKER
+   /* --------------------------------------------------------------------------------------------------------
+    * Worker */
+
+   /**
+      Perform some non-realtime work requested via scheduleWork().@n
+      This is called on a separate thread, never concurrently with itself.@n
+      Use sendWorkResponse() to pass results back to the audio thread.
+      @note This function is only available if DISTRHO_PLUGIN_WANT_WORKER is enabled.
+    */
+    virtual void work(const void* data, uint32_t size) = 0;
+
+   /**
+      Receive a response sent by sendWorkResponse() during work().@n
+      This is called on the audio thread, never concurrently with run().
+      @note This function is only available if DISTRHO_PLUGIN_WANT_WORKER is enabled.
+    */
+    virtual void workResponse(const void* data, uint32_t size);
+#endif
+
    /* --------------------------------------------------------------------------------------------------------
     * Callbacks (optional) */
 
@@ -408,6 +584,14 @@ protected:
     */
     virtual void sampleRateChanged(double newSampleRate);
 
+   /**
+      Optional callback to inform the plugin about a processing mode change, between real-time and offline.@n
+      This function is either called while the plugin is deactivated or from the audio thread right before run().
+      @note As it can run on the audio thread, this function must be realtime-safe, just like run().
+      @see isOffline()
+    */
+    virtual void processModeChanged(bool offline);
+
    /**
       Optional callback to inform the plugin about audio port IO changes.@n
       This function will only be called when the plugin is deactivated.@n
@@ -422,6 +606,9 @@ private:
     struct PrivateData;
     PrivateData* const pData;
     friend class PluginExporter;
+#if DISTRHO_PLUGIN_WANT_WORKER
+    friend class PluginWorker;
+#endif
 
     DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Plugin)
 };
@@ -14,10 +14,17 @@
  * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+// the benchmark tool counts allocations through the realtime-safety checks
+#if defined(DISTRHO_PLUGIN_TARGET_BENCH) && !defined(DPF_RT_SAFETY_CHECKS)
+# define DPF_RT_SAFETY_CHECKS
+#endif
+
 #include "src/DistrhoPlugin.cpp"
 
 #if defined(DISTRHO_PLUGIN_TARGET_AU)
 # include "src/DistrhoPluginAU.cpp"
+#elif defined(DISTRHO_PLUGIN_TARGET_BENCH)
+# include "src/DistrhoPluginBench.cpp"
 #elif defined(DISTRHO_PLUGIN_TARGET_CARLA)
 # include "src/DistrhoPluginCarla.cpp"
 #elif defined(DISTRHO_PLUGIN_TARGET_CLAP)
@@ -51,3 +58,7 @@ END_NAMESPACE_DISTRHO
 # define DISTRHO_IS_STANDALONE 0
 #endif
 #include "src/DistrhoUtils.cpp"
+
+#ifdef DPF_RT_SAFETY_CHECKS
+# include "src/DistrhoRealtimeSafety.cpp"
+#endif
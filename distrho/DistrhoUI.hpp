@@ -209,6 +209,15 @@ public:
       @TODO Document this.
     */
     void* getPluginInstancePointer() const noexcept;
+
+# if DISTRHO_PLUGIN_WANT_DSP_LOAD
+   /**
+      Get the DSP load statistics of the plugin instance this %UI belongs to.@n
+      This is the same as calling Plugin::getDspLoad() through getPluginInstancePointer().
+      @note This function is only available if DISTRHO_PLUGIN_WANT_DSP_LOAD is enabled too.
+    */
+    DspLoad getDspLoad() const noexcept;
+# endif
 #endif
 
 protected:
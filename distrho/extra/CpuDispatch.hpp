@@ -0,0 +1,128 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef DISTRHO_CPU_DISPATCH_HPP_INCLUDED
+#define DISTRHO_CPU_DISPATCH_HPP_INCLUDED
+
+#include "../DistrhoUtils.hpp"
+
+/**
+   Runtime CPU dispatch helpers.
+
+   Plugin binaries are built for a generic ISA level so they load on every machine,
+   which means AVX2 or AVX-512 capable CPUs end up running SSE2 code.
+   The macros and functions in this file allow DSP code to carry several ISA variants inside a single binary,
+   with the best one being selected on the user's machine.
+
+   Only plain functions should be multi-versioned, typically the DSP kernels called from Plugin::run().
+   Virtual methods cannot be multi-versioned, and compiling whole translation units with different ISA flags is unsafe,
+   because inline functions from shared headers would then be merged by the linker with their AVX variants.
+
+   There are 2 ways to use this:
+    - Automatic, by adding DISTRHO_CPU_DISPATCH before a function definition.
+      The compiler generates one variant per ISA level and the dynamic loader resolves the best one when the plugin binary is loaded.
+    - Manual, by adding DISTRHO_CPU_TARGET_AVX2 or DISTRHO_CPU_TARGET_AVX512 to specific kernels,
+      then selecting between them with d_getCpuDispatchLevel() when the plugin is instantiated.
+
+   Below is an example of the manual approach:
+   @code
+   DISTRHO_CPU_TARGET_AVX2
+   static void processAVX2(const float* in, float* out, uint32_t frames) { ... }
+
+   static void processGeneric(const float* in, float* out, uint32_t frames) { ... }
+
+   MyPlugin::MyPlugin()
+       : Plugin(kParameterCount, 0, 0),
+         fProcess(d_getCpuDispatchLevel() >= kCpuDispatchLevelAVX2 ? processAVX2 : processGeneric) {}
+   @endcode
+
+   All macros expand to nothing (and d_getCpuDispatchLevel() returns kCpuDispatchLevelGeneric)
+   on unsupported compilers and architectures, or when building with @c DISTRHO_NO_CPU_DISPATCH defined.
+   Always guard variant-specific code with @c DISTRHO_CPU_TARGETS_AVAILABLE when using the manual approach.
+ */
+
+// --------------------------------------------------------------------------------------------------------------------
+// Function target macros
+
+#if !defined(DISTRHO_NO_CPU_DISPATCH) && (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+# define DISTRHO_CPU_TARGETS_AVAILABLE 1
+# define DISTRHO_CPU_TARGET_AVX2 __attribute__((target("avx2,fma")))
+# define DISTRHO_CPU_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl,avx2,fma")))
+#else
+# define DISTRHO_CPU_TARGETS_AVAILABLE 0
+# define DISTRHO_CPU_TARGET_AVX2
+# define DISTRHO_CPU_TARGET_AVX512
+#endif
+
+// automatic dispatch relies on ifunc, which needs an ELF platform with loader support
+#if DISTRHO_CPU_TARGETS_AVAILABLE && defined(__x86_64__) && defined(__ELF__) && \
+    defined(__linux__) && !defined(__ANDROID__) && \
+    ((defined(__clang__) && __clang_major__ >= 14) || (!defined(__clang__) && __GNUC__ >= 6))
+# define DISTRHO_CPU_DISPATCH_AVAILABLE 1
+# define DISTRHO_CPU_DISPATCH __attribute__((target_clones("default","arch=haswell","arch=skylake-avx512")))
+#else
+# define DISTRHO_CPU_DISPATCH_AVAILABLE 0
+# define DISTRHO_CPU_DISPATCH
+#endif
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+// CPU dispatch level
+
+/**
+   ISA levels that DSP code can be specialized for.
+   Each level implies support for all previous ones.
+ */
+enum CpuDispatchLevel {
+   /** Baseline ISA level the binary was built for, always available. */
+    kCpuDispatchLevelGeneric = 0,
+
+   /** AVX2 and FMA, roughly matching x86-64-v3. */
+    kCpuDispatchLevelAVX2 = 1,
+
+   /** AVX-512 F, BW, DQ and VL, roughly matching x86-64-v4. */
+    kCpuDispatchLevelAVX512 = 2
+};
+
+/**
+   Get the highest ISA level supported by the running CPU.
+   Meant to be called once, typically in the plugin constructor, and not from the audio thread.
+ */
+static inline
+CpuDispatchLevel d_getCpuDispatchLevel() noexcept
+{
+   #if DISTRHO_CPU_TARGETS_AVAILABLE
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2") == 0 || __builtin_cpu_supports("fma") == 0)
+        return kCpuDispatchLevelGeneric;
+
+    if (__builtin_cpu_supports("avx512f") == 0 || __builtin_cpu_supports("avx512bw") == 0 ||
+        __builtin_cpu_supports("avx512dq") == 0 || __builtin_cpu_supports("avx512vl") == 0)
+        return kCpuDispatchLevelAVX2;
+
+    return kCpuDispatchLevelAVX512;
+   #else
+    return kCpuDispatchLevelGeneric;
+   #endif
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // DISTRHO_CPU_DISPATCH_HPP_INCLUDED
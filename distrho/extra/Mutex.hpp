@@ -35,6 +35,10 @@
 #include <pthread.h>
 #endif
 
+#ifdef DPF_RT_SAFETY_CHECKS
+# include "RealtimeSafety.hpp"
+#endif
+
 START_NAMESPACE_DISTRHO
 
 class Signal;
@@ -81,6 +85,9 @@ public:
      */
     bool lock() const noexcept
     {
+       #if defined(DPF_RT_SAFETY_CHECKS) && !DISTRHO_RT_SAFETY_HOOKS
+        DISTRHO_RT_SAFETY_CHECK("Mutex::lock")
+       #endif
        #ifdef DISTRHO_OS_WINDOWS__TODO
        #else
         return (pthread_mutex_lock(&fMutex) == 0);
@@ -164,6 +171,9 @@ public:
      */
     bool lock() const noexcept
     {
+       #if defined(DPF_RT_SAFETY_CHECKS) && !DISTRHO_RT_SAFETY_HOOKS
+        DISTRHO_RT_SAFETY_CHECK("RecursiveMutex::lock")
+       #endif
        #ifdef DISTRHO_OS_WINDOWS
         EnterCriticalSection(&fSection);
         return true;
@@ -0,0 +1,211 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef DISTRHO_REALTIME_SAFETY_HPP_INCLUDED
+#define DISTRHO_REALTIME_SAFETY_HPP_INCLUDED
+
+#include "../DistrhoUtils.hpp"
+
+/**
+   Realtime-safety checks, only available when building with @c DPF_RT_SAFETY_CHECKS defined.
+
+   Threads can be marked as realtime while running audio code, which DPF does automatically during Plugin::run().
+   Any memory allocation or mutex lock done by a realtime thread is then reported on stderr, together with a backtrace.
+   Each offending call site is only reported once.
+
+   On Linux with glibc, calls to malloc, calloc, realloc, posix_memalign, free, operator new/delete and pthread_mutex_lock
+   made from the plugin binary are intercepted.
+   On other systems only DPF's own Mutex and RecursiveMutex classes are checked.
+ */
+
+#ifdef DPF_RT_SAFETY_CHECKS
+
+#include <atomic>
+
+#if defined(DISTRHO_OS_LINUX) && defined(__GLIBC__) && !defined(STATIC_BUILD)
+# define DISTRHO_RT_SAFETY_HOOKS 1
+#else
+# define DISTRHO_RT_SAFETY_HOOKS 0
+#endif
+
+#if defined(__GLIBC__) || defined(DISTRHO_OS_MAC)
+# include <execinfo.h>
+# define DISTRHO_RT_SAFETY_BACKTRACE 1
+#else
+# define DISTRHO_RT_SAFETY_BACKTRACE 0
+#endif
+
+#ifdef __GNUC__
+# define DISTRHO_RT_SAFETY_CALLER __builtin_return_address(0)
+#else
+# define DISTRHO_RT_SAFETY_CALLER nullptr
+#endif
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+// Realtime thread state
+
+// NOTE: these are intentionally not static, so that all translation units share the same thread-local state
+
+/*
+ * Internal helper for the realtime thread state, do not use directly.
+ */
+inline bool& _d_realtimeThreadState() noexcept
+{
+    static thread_local bool realtime = false;
+    return realtime;
+}
+
+/**
+   Check if the calling thread is currently marked as realtime.
+ */
+inline bool d_isRealtimeThread() noexcept
+{
+    return _d_realtimeThreadState();
+}
+
+/**
+   Mark or unmark the calling thread as realtime.
+   Prefer to use ScopedRealtimeThread instead.
+ */
+inline void d_setRealtimeThread(const bool realtime) noexcept
+{
+    _d_realtimeThreadState() = realtime;
+}
+
+/*
+ * Internal helper for the realtime allocation counter, do not use directly.
+ */
+inline uint64_t& _d_realtimeAllocationCount() noexcept
+{
+    static thread_local uint64_t count = 0;
+    return count;
+}
+
+/**
+   Get the number of memory allocations done by the calling thread while marked as realtime.
+   Allocations are only counted when they are intercepted, that is, if DISTRHO_RT_SAFETY_HOOKS is 1.
+ */
+inline uint64_t d_getRealtimeAllocationCount() noexcept
+{
+    return _d_realtimeAllocationCount();
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Realtime violation reports
+
+/**
+   Report a realtime-safety violation, printing a message and a backtrace to stderr.
+   @a caller is used to only report each call site once, it can be null in which case all calls are reported.
+   @a isAllocation increments the realtime allocation counter, regardless of the call site having been reported before.
+ */
+inline void d_reportRealtimeViolation(const char* const what, const void* const caller,
+                                      const bool isAllocation = false) noexcept
+{
+    static constexpr const uint kMaxCallers = 256;
+    static std::atomic<const void*> reportedCallers[kMaxCallers];
+    static thread_local bool reporting = false;
+
+    // printing and backtraces might allocate too
+    if (reporting)
+        return;
+
+    if (isAllocation)
+        ++_d_realtimeAllocationCount();
+
+    if (caller != nullptr)
+    {
+        for (uint i = 0; i < kMaxCallers; ++i)
+        {
+            const void* expected = nullptr;
+
+            if (reportedCallers[i].compare_exchange_strong(expected, caller))
+                break;
+            if (expected == caller)
+                return;
+        }
+    }
+
+    reporting = true;
+    d_stderr2("realtime safety violation: %s called from the audio thread", what);
+
+   #if DISTRHO_RT_SAFETY_BACKTRACE
+    void* frames[32];
+    const int numFrames = backtrace(frames, 32);
+    // skip ourselves
+    backtrace_symbols_fd(frames + 1, numFrames - 1, fileno(stderr));
+   #endif
+
+    reporting = false;
+}
+
+/**
+   Report a realtime-safety violation if the calling thread is marked as realtime.
+ */
+#define DISTRHO_RT_SAFETY_CHECK(what) \
+    if (DISTRHO_NAMESPACE::d_isRealtimeThread()) \
+        DISTRHO_NAMESPACE::d_reportRealtimeViolation(what, DISTRHO_RT_SAFETY_CALLER);
+
+/**
+   Same as DISTRHO_RT_SAFETY_CHECK, but also counting the call as a realtime allocation.
+ */
+#define DISTRHO_RT_SAFETY_CHECK_ALLOCATION(what) \
+    if (DISTRHO_NAMESPACE::d_isRealtimeThread()) \
+        DISTRHO_NAMESPACE::d_reportRealtimeViolation(what, DISTRHO_RT_SAFETY_CALLER, true);
+
+// --------------------------------------------------------------------------------------------------------------------
+// ScopedRealtimeThread class
+
+/**
+   ScopedRealtimeThread marks the calling thread as realtime during a function scope.
+   The previous state is restored on destruction, so scopes can be nested.
+ */
+class ScopedRealtimeThread {
+public:
+    /*
+     * Constructor.
+     * Current thread state is saved, then the thread is marked as realtime.
+     */
+    ScopedRealtimeThread() noexcept
+        : wasRealtime(d_isRealtimeThread())
+    {
+        d_setRealtimeThread(true);
+    }
+
+    /*
+     * Destructor.
+     * Thread state is restored to the value obtained in the constructor.
+     */
+    ~ScopedRealtimeThread() noexcept
+    {
+        d_setRealtimeThread(wasRealtime);
+    }
+
+private:
+    const bool wasRealtime;
+
+    DISTRHO_DECLARE_NON_COPYABLE(ScopedRealtimeThread)
+    DISTRHO_PREVENT_HEAP_ALLOCATION
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // DPF_RT_SAFETY_CHECKS
+
+#endif // DISTRHO_REALTIME_SAFETY_HPP_INCLUDED
@@ -0,0 +1,127 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef DISTRHO_SEMAPHORE_HPP_INCLUDED
+#define DISTRHO_SEMAPHORE_HPP_INCLUDED
+
+#include "../DistrhoUtils.hpp"
+
+#if defined(DISTRHO_OS_MAC)
+# include <dispatch/dispatch.h>
+#elif defined(DISTRHO_OS_WINDOWS)
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <winsock2.h>
+# include <windows.h>
+# include <climits>
+#else
+# include <cerrno>
+# include <semaphore.h>
+#endif
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+// Semaphore class
+
+/*
+ * Counting semaphore, used to wake up a waiting thread from the audio thread.
+ * Unlike Signal, post() never takes a lock, which makes it safe to call from realtime code.
+ */
+class Semaphore
+{
+public:
+    /*
+     * Constructor.
+     */
+    Semaphore() noexcept
+        : fSemaphore()
+    {
+       #if defined(DISTRHO_OS_MAC)
+        fSemaphore = dispatch_semaphore_create(0);
+        DISTRHO_SAFE_ASSERT(fSemaphore != nullptr);
+       #elif defined(DISTRHO_OS_WINDOWS)
+        fSemaphore = ::CreateSemaphoreA(nullptr, 0, LONG_MAX, nullptr);
+        DISTRHO_SAFE_ASSERT(fSemaphore != nullptr);
+       #else
+        const int ret = sem_init(&fSemaphore, 0, 0);
+        DISTRHO_SAFE_ASSERT(ret == 0);
+       #endif
+    }
+
+    /*
+     * Destructor.
+     */
+    ~Semaphore() noexcept
+    {
+       #if defined(DISTRHO_OS_MAC)
+        if (fSemaphore != nullptr)
+            dispatch_release(fSemaphore);
+       #elif defined(DISTRHO_OS_WINDOWS)
+        if (fSemaphore != nullptr)
+            ::CloseHandle(fSemaphore);
+       #else
+        sem_destroy(&fSemaphore);
+       #endif
+    }
+
+    /*
+     * Wake up one waiting thread.
+     * Safe to call from the audio thread.
+     */
+    void post() noexcept
+    {
+       #if defined(DISTRHO_OS_MAC)
+        dispatch_semaphore_signal(fSemaphore);
+       #elif defined(DISTRHO_OS_WINDOWS)
+        ::ReleaseSemaphore(fSemaphore, 1, nullptr);
+       #else
+        sem_post(&fSemaphore);
+       #endif
+    }
+
+    /*
+     * Wait until post() is called.
+     */
+    void wait() noexcept
+    {
+       #if defined(DISTRHO_OS_MAC)
+        dispatch_semaphore_wait(fSemaphore, DISPATCH_TIME_FOREVER);
+       #elif defined(DISTRHO_OS_WINDOWS)
+        ::WaitForSingleObject(fSemaphore, INFINITE);
+       #else
+        while (sem_wait(&fSemaphore) != 0 && errno == EINTR) {}
+       #endif
+    }
+
+private:
+   #if defined(DISTRHO_OS_MAC)
+    dispatch_semaphore_t fSemaphore;
+   #elif defined(DISTRHO_OS_WINDOWS)
+    HANDLE fSemaphore;
+   #else
+    sem_t fSemaphore;
+   #endif
+
+    DISTRHO_DECLARE_NON_COPYABLE(Semaphore)
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // DISTRHO_SEMAPHORE_HPP_INCLUDED
@@ -56,7 +56,30 @@ Plugin::Plugin(uint32_t parameterCount, uint32_t programCount, uint32_t stateCou
     if (parameterCount > 0)
     {
         pData->parameterCount = parameterCount;
+       #if ! DISTRHO_PLUGIN_WANT_SHARED_PARAMETERS
         pData->parameters = new Parameter[parameterCount];
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+        pData->outputParameterValues = new float[parameterCount];
+        std::memset(pData->outputParameterValues, 0, sizeof(float)*parameterCount);
+
+        const uint32_t changedParameterWords = (parameterCount + 31) / 32;
+        pData->changedParameters = new std::atomic<uint32_t>[changedParameterWords];
+        for (uint32_t i=0; i < changedParameterWords; ++i)
+            pData->changedParameters[i].store(0, std::memory_order_relaxed);
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS
+        pData->pendingParameterValues = new std::atomic<float>[parameterCount];
+        for (uint32_t i=0; i < parameterCount; ++i)
+            pData->pendingParameterValues[i].store(0.f, std::memory_order_relaxed);
+
+        const uint32_t pendingParameterWords = (parameterCount + 31) / 32;
+        pData->pendingParameters = new std::atomic<uint32_t>[pendingParameterWords];
+        for (uint32_t i=0; i < pendingParameterWords; ++i)
+            pData->pendingParameters[i].store(0, std::memory_order_relaxed);
+       #endif
     }
 
     if (programCount > 0)
@@ -102,6 +125,35 @@ double Plugin::getSampleRate() const noexcept
     return pData->sampleRate;
 }
 
+bool Plugin::isOffline() const noexcept
+{
+    return pData->isOffline;
+}
+
+#if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+uint32_t Plugin::getOversamplingFactor() const noexcept
+{
+    return pData->oversamplingFactor;
+}
+
+bool Plugin::setOversamplingFactor(const uint32_t factor) noexcept
+{
+    DISTRHO_SAFE_ASSERT_UINT_RETURN(PluginOversampler<float>::isValidFactor(factor), factor, false);
+
+    pData->nextOversamplingFactor = factor;
+    return true;
+}
+#endif
+
+#if DISTRHO_PLUGIN_WANT_DSP_LOAD
+DspLoad Plugin::getDspLoad() const noexcept
+{
+    DspLoad dspLoad;
+    pData->dspLoadMeter.get(dspLoad);
+    return dspLoad;
+}
+#endif
+
 const char* Plugin::getBundlePath() const noexcept
 {
     return pData->bundlePath;
@@ -150,6 +202,20 @@ bool Plugin::requestParameterValueChange(const uint32_t index, const float value
 }
 #endif
 
+#if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+void Plugin::setOutputParameterValue(const uint32_t index, const float value) noexcept
+{
+    DISTRHO_SAFE_ASSERT_UINT2_RETURN(index < pData->parameterCount, index, pData->parameterCount,);
+    DISTRHO_SAFE_ASSERT_UINT_RETURN(pData->parameters[index].hints & kParameterIsOutput, index,);
+
+    if (d_isEqual(pData->outputParameterValues[index], value))
+        return;
+
+    pData->outputParameterValues[index] = value;
+    pData->markParameterChanged(index);
+}
+#endif
+
 #if DISTRHO_PLUGIN_WANT_STATE
 bool Plugin::updateStateValue(const char* const key, const char* const value) noexcept
 {
@@ -157,6 +223,52 @@ bool Plugin::updateStateValue(const char* const key, const char* const value) no
 }
 #endif
 
+#if DISTRHO_PLUGIN_WANT_WORKER
+bool Plugin::scheduleWork(const void* const data, const uint32_t size) noexcept
+{
+    return pData->scheduleWorkCallback(data, size);
+}
+
+bool Plugin::sendWorkResponse(const void* const data, const uint32_t size) noexcept
+{
+    return pData->sendWorkResponseCallback(data, size);
+}
+#endif
+
+#if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+void Plugin::executeParallel(const uint32_t taskCount, const ParallelTaskFunc callback, void* const ptr) noexcept
+{
+    pData->executeParallelCallback(taskCount, callback, ptr);
+}
+#endif
+
+#if DISTRHO_PLUGIN_SCRATCH_BUFFER_COUNT != 0
+float* Plugin::getScratchBuffer(const uint32_t size) noexcept
+{
+    DISTRHO_SAFE_ASSERT_RETURN(pData->isProcessing, nullptr);
+
+    return static_cast<float*>(pData->scratchArena.allocate(sizeof(float) * size));
+}
+
+# if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+double* Plugin::getScratchBuffer64(const uint32_t size) noexcept
+{
+    DISTRHO_SAFE_ASSERT_RETURN(pData->isProcessing, nullptr);
+
+    return static_cast<double*>(pData->scratchArena.allocate(sizeof(double) * size));
+}
+# endif
+#endif
+
+#if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+const float* Plugin::getParameterRamp(const uint32_t index) const noexcept
+{
+    DISTRHO_SAFE_ASSERT_UINT2_RETURN(index < pData->parameterCount, index, pData->parameterCount, nullptr);
+
+    return pData->parameterRamps != nullptr ? pData->parameterRamps[index] : nullptr;
+}
+#endif
+
 /* ------------------------------------------------------------------------------------------------------------
  * Init */
 
@@ -229,6 +341,12 @@ void Plugin::initState(const uint32_t index, State& state)
 float Plugin::getParameterValue(uint32_t) const { return 0.0f; }
 void Plugin::setParameterValue(uint32_t, float) {}
 
+void Plugin::setParameterValues(const uint32_t* const indexes, const float* const values, const uint32_t count)
+{
+    for (uint32_t i=0; i < count; ++i)
+        setParameterValue(indexes[i], values[i]);
+}
+
 #if DISTRHO_PLUGIN_WANT_PROGRAMS
 void Plugin::loadProgram(uint32_t) {}
 #endif
@@ -241,11 +359,19 @@ String Plugin::getState(const char*) const { return String(); }
 void Plugin::setState(const char*, const char*) {}
 #endif
 
+/* ------------------------------------------------------------------------------------------------------------
+ * Worker */
+
+#if DISTRHO_PLUGIN_WANT_WORKER
+void Plugin::workResponse(const void*, uint32_t) {}
+#endif
+
 /* ------------------------------------------------------------------------------------------------------------
  * Callbacks (optional) */
 
 void Plugin::bufferSizeChanged(uint32_t) {}
 void Plugin::sampleRateChanged(double) {}
+void Plugin::processModeChanged(bool) {}
 void Plugin::ioChanged(uint16_t, uint16_t) {}
 
 // -----------------------------------------------------------------------------------------------------------
@@ -2559,20 +2559,10 @@ private:
                     const String& value(cit->second);
 
                    #if DISTRHO_PLUGIN_WANT_DIRECT_ACCESS && ! DISTRHO_PLUGIN_HAS_UI
-                    bool wantStateKey = true;
+                    uint32_t stateIndex;
 
-                    for (uint32_t i=0; i<fStateCount; ++i)
-                    {
-                        if (fPlugin.getStateKey(i) == key)
-                        {
-                            if (fPlugin.getStateHints(i) & kStateIsOnlyForUI)
-                                wantStateKey = false;
-
-                            break;
-                        }
-                    }
-
-                    if (! wantStateKey)
+                    if (fPlugin.getStateIndexForKey(key, stateIndex)
+                        && (fPlugin.getStateHints(stateIndex) & kStateIsOnlyForUI) != 0x0)
                         continue;
                    #endif
 
@@ -2719,16 +2709,11 @@ private:
                 fStateMap[dkey] = value;
                 fPlugin.setState(key, value);
 
-                for (uint32_t j=0; j<fStateCount; ++j)
-                {
-                    if (fPlugin.getStateKey(j) == key)
-                    {
-                        if ((fPlugin.getStateHints(i) & kStateIsOnlyForDSP) == 0x0)
-                            notifyPropertyListeners('DPFs', kAudioUnitScope_Global, j);
+                uint32_t stateIndex;
 
-                        break;
-                    }
-                }
+                if (fPlugin.getStateIndexForKey(key, stateIndex)
+                    && (fPlugin.getStateHints(stateIndex) & kStateIsOnlyForDSP) == 0x0)
+                    notifyPropertyListeners('DPFs', kAudioUnitScope_Global, stateIndex);
             }
 
             std::free(key);
@@ -2769,22 +2754,17 @@ private:
                 }
                 DISTRHO_SAFE_ASSERT_BREAK(CFStringGetCString(keyRef, symbol, symbolLen + 1, kCFStringEncodingASCII));
 
-                for (uint32_t j=0; j<fParameterCount; ++j)
-                {
-                    if (fPlugin.isParameterOutputOrTrigger(j))
-                        continue;
-                    if (fPlugin.getParameterSymbol(j) != symbol)
-                        continue;
+                uint32_t j;
 
-                    fLastParameterValues[j] = value;
-                    fPlugin.setParameterValue(j, value);
-                    notifyPropertyListeners('DPFp', kAudioUnitScope_Global, j);
+                if (! fPlugin.getParameterIndexForSymbol(symbol, j) || fPlugin.isParameterOutputOrTrigger(j))
+                    continue;
 
-                    if (fBypassParameterIndex == j)
-                        notifyPropertyListeners(kAudioUnitProperty_BypassEffect, kAudioUnitScope_Global, 0);
+                fLastParameterValues[j] = value;
+                fPlugin.setParameterValue(j, value);
+                notifyPropertyListeners('DPFp', kAudioUnitScope_Global, j);
 
-                    break;
-                }
+                if (fBypassParameterIndex == j)
+                    notifyPropertyListeners(kAudioUnitProperty_BypassEffect, kAudioUnitScope_Global, 0);
             }
 
             std::free(symbol);
@@ -2849,22 +2829,21 @@ private:
     {
         fPlugin.setState(key, newValue);
 
-        for (uint32_t i=0; i<fStateCount; ++i)
+        uint32_t i;
+
+        if (! fPlugin.getStateIndexForKey(key, i))
         {
-            if (fPlugin.getStateKey(i) == key)
-            {
-                const String dkey(key);
-                fStateMap[dkey] = newValue;
+            d_stderr("Failed to find plugin state with key \"%s\"", key);
+            return false;
+        }
 
-                if ((fPlugin.getStateHints(i) & kStateIsOnlyForDSP) == 0x0)
-                    notifyPropertyListeners('DPFs', kAudioUnitScope_Global, i);
+        const String dkey(key);
+        fStateMap[dkey] = newValue;
 
-                return true;
-            }
-        }
+        if ((fPlugin.getStateHints(i) & kStateIsOnlyForDSP) == 0x0)
+            notifyPropertyListeners('DPFs', kAudioUnitScope_Global, i);
 
-        d_stderr("Failed to find plugin state with key \"%s\"", key);
-        return false;
+        return true;
     }
 
     static bool updateStateValueCallback(void* const ptr, const char* const key, const char* const newValue)
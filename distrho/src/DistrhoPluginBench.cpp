@@ -0,0 +1,517 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "DistrhoPluginInternal.hpp"
+#include "../extra/RealtimeSafety.hpp"
+#include "../extra/Time.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+// Benchmark options
+
+enum BenchAutomation {
+    // no parameter changes
+    kBenchAutomationNone,
+    // all automatable parameters jump to a new pseudo-random value on every block
+    kBenchAutomationStep,
+    // all automatable parameters follow a triangle sweep, 1 second per cycle
+    kBenchAutomationRamp,
+    kBenchAutomationCount
+};
+
+static const char* const kBenchAutomationNames[kBenchAutomationCount] = {
+    "none",
+    "step",
+    "ramp"
+};
+
+struct BenchOptions {
+    std::vector<double> sampleRates;
+    std::vector<uint32_t> blockSizes;
+    std::vector<uint32_t> midiDensities;
+    std::vector<BenchAutomation> automations;
+    double seconds;
+    double warmupSeconds;
+    const char* outputFilename;
+
+    BenchOptions()
+        : seconds(5.0),
+          warmupSeconds(0.5),
+          outputFilename(nullptr) {}
+};
+
+struct BenchResult {
+    double sampleRate;
+    uint32_t blockSize;
+    uint32_t midiDensity;
+    BenchAutomation automation;
+    uint32_t blocks;
+    double nsPerSample;
+    double meanBlockNs;
+    uint64_t p99BlockNs;
+    uint64_t maxBlockNs;
+    double dspLoad;
+    uint64_t allocations;
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+// Benchmark helpers
+
+// simple LCG, good enough for test signals and reproducible between runs
+static inline
+uint32_t nextRandom(uint32_t& state) noexcept
+{
+    state = state * 1664525u + 1013904223u;
+    return state;
+}
+
+static inline
+float nextRandomFloat(uint32_t& state) noexcept
+{
+    return static_cast<float>(nextRandom(state) >> 8) / static_cast<float>(1 << 24);
+}
+
+#if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
+static bool writeMidiCallback(void*, const MidiEvent&)
+{
+    return true;
+}
+#endif
+
+static void writeJsonString(FILE* const file, const char* str)
+{
+    std::fputc('"', file);
+
+    for (; *str != '\0'; ++str)
+    {
+        const uchar c = static_cast<uchar>(*str);
+
+        if (c == '"' || c == '\\')
+            std::fprintf(file, "\\%c", c);
+        else if (c < 0x20)
+            std::fprintf(file, "\\u%04x", c);
+        else
+            std::fputc(c, file);
+    }
+
+    std::fputc('"', file);
+}
+
+template<typename T>
+static bool parseList(const char* arg, std::vector<T>& values, const double minimum)
+{
+    values.clear();
+
+    while (*arg != '\0')
+    {
+        char* end = nullptr;
+        const double value = std::strtod(arg, &end);
+
+        if (end == arg || value < minimum)
+            return false;
+
+        values.push_back(static_cast<T>(value));
+
+        if (*end == ',')
+            ++end;
+        else if (*end != '\0')
+            return false;
+
+        arg = end;
+    }
+
+    return !values.empty();
+}
+
+static bool parseAutomationList(const char* arg, std::vector<BenchAutomation>& values)
+{
+    values.clear();
+
+    while (*arg != '\0')
+    {
+        const char* const end = std::strchr(arg, ',');
+        const size_t len = end != nullptr ? static_cast<size_t>(end - arg) : std::strlen(arg);
+        bool found = false;
+
+        for (uint i = 0; i < kBenchAutomationCount; ++i)
+        {
+            if (std::strlen(kBenchAutomationNames[i]) == len && std::strncmp(arg, kBenchAutomationNames[i], len) == 0)
+            {
+                values.push_back(static_cast<BenchAutomation>(i));
+                found = true;
+                break;
+            }
+        }
+
+        if (! found)
+            return false;
+
+        arg = end != nullptr ? end + 1 : arg + len;
+    }
+
+    return !values.empty();
+}
+
+static void printUsage(FILE* const file, const char* const program)
+{
+    std::fprintf(file, "usage: %s [options]\n"
+                       "\n"
+                       "Runs the plugin DSP without any host or audio device, reporting processing times as JSON.\n"
+                       "All combinations of the given values are benchmarked, each on a new plugin instance.\n"
+                       "\n"
+                       "options:\n"
+                       "  --sample-rates <list>   comma-separated sample rates (default: 48000)\n"
+                       "  --block-sizes <list>    comma-separated block sizes in frames (default: 64,256,1024)\n"
+                       "  --midi-densities <list> comma-separated MIDI input events per second (default: 0)\n"
+                       "  --automation <list>     comma-separated automation patterns: none, step or ramp (default: none)\n"
+                       "  --seconds <value>       audio duration processed per combination (default: 5)\n"
+                       "  --warmup <value>        audio duration processed before measuring (default: 0.5)\n"
+                       "  --output <file>         write JSON to a file instead of stdout\n",
+                       program);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Benchmark run
+
+static void runBenchmark(const BenchOptions& options, BenchResult& result)
+{
+    const double sampleRate = result.sampleRate;
+    const uint32_t blockSize = result.blockSize;
+
+    d_nextBufferSize = blockSize;
+    d_nextSampleRate = sampleRate;
+   #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
+    PluginExporter plugin(nullptr, writeMidiCallback, nullptr, nullptr);
+   #else
+    PluginExporter plugin(nullptr, nullptr, nullptr, nullptr);
+   #endif
+    d_nextBufferSize = 0;
+    d_nextSampleRate = 0.0;
+
+    uint32_t randomState = 0x12345678;
+
+    // audio buffers, inputs filled with noise
+    std::vector<float> inputBuffers[DISTRHO_PLUGIN_NUM_INPUTS > 0 ? DISTRHO_PLUGIN_NUM_INPUTS : 1];
+    std::vector<float> outputBuffers[DISTRHO_PLUGIN_NUM_OUTPUTS > 0 ? DISTRHO_PLUGIN_NUM_OUTPUTS : 1];
+    const float* inputs[DISTRHO_PLUGIN_NUM_INPUTS > 0 ? DISTRHO_PLUGIN_NUM_INPUTS : 1] = {};
+    float* outputs[DISTRHO_PLUGIN_NUM_OUTPUTS > 0 ? DISTRHO_PLUGIN_NUM_OUTPUTS : 1] = {};
+
+    for (uint32_t i = 0; i < DISTRHO_PLUGIN_NUM_INPUTS; ++i)
+    {
+        inputBuffers[i].resize(blockSize);
+        for (uint32_t j = 0; j < blockSize; ++j)
+            inputBuffers[i][j] = nextRandomFloat(randomState) * 0.5f - 0.25f;
+        inputs[i] = inputBuffers[i].data();
+    }
+
+    for (uint32_t i = 0; i < DISTRHO_PLUGIN_NUM_OUTPUTS; ++i)
+    {
+        outputBuffers[i].resize(blockSize);
+        outputs[i] = outputBuffers[i].data();
+    }
+
+    // automatable input parameters
+    std::vector<uint32_t> automationIndexes;
+    std::vector<float> automationValues;
+
+    if (result.automation != kBenchAutomationNone)
+    {
+        for (uint32_t i = 0, count = plugin.getParameterCount(); i < count; ++i)
+        {
+            if (plugin.isParameterOutputOrTrigger(i))
+                continue;
+            if ((plugin.getParameterHints(i) & kParameterIsAutomatable) == 0x0)
+                continue;
+
+            automationIndexes.push_back(i);
+        }
+
+        automationValues.resize(automationIndexes.size());
+    }
+
+    const uint32_t automationCount = static_cast<uint32_t>(automationIndexes.size());
+
+   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+    MidiEvent midiEvents[kMaxMidiEvents];
+    std::memset(midiEvents, 0, sizeof(midiEvents));
+    const double midiEventsPerBlock = result.midiDensity * blockSize / sampleRate;
+    double midiEventsPending = 0.0;
+    uint32_t midiEventIndex = 0;
+   #endif
+
+    const uint32_t warmupBlocks = static_cast<uint32_t>(options.warmupSeconds * sampleRate / blockSize + 0.5);
+    const uint32_t blocks = std::max(1u, static_cast<uint32_t>(options.seconds * sampleRate / blockSize + 0.5));
+    std::vector<uint64_t> blockTimes(blocks);
+    uint64_t allocations = 0;
+
+    plugin.activate();
+
+    for (uint32_t b = 0, totalBlocks = warmupBlocks + blocks; b < totalBlocks; ++b)
+    {
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        // note on/off pairs, evenly spread across the block
+        midiEventsPending += midiEventsPerBlock;
+        const uint32_t midiEventCount = std::min(static_cast<uint32_t>(midiEventsPending), kMaxMidiEvents);
+        midiEventsPending -= midiEventCount;
+
+        for (uint32_t i = 0; i < midiEventCount; ++i, ++midiEventIndex)
+        {
+            MidiEvent& midiEvent(midiEvents[i]);
+            midiEvent.frame = i * blockSize / midiEventCount;
+            midiEvent.size = 3;
+            midiEvent.data[0] = (midiEventIndex % 2) == 0 ? 0x90 : 0x80;
+            midiEvent.data[1] = 36 + (midiEventIndex / 2) % 48;
+            midiEvent.data[2] = (midiEventIndex % 2) == 0 ? 100 : 0;
+        }
+       #endif
+
+        // prepare automation values before timing, it is not part of the plugin work
+        if (automationCount != 0)
+        {
+            float normalized = 0.0f;
+
+            if (result.automation == kBenchAutomationRamp)
+            {
+                const double phase = std::fmod(static_cast<double>(b) * blockSize / sampleRate, 1.0);
+                normalized = static_cast<float>(phase < 0.5 ? phase * 2.0 : 2.0 - phase * 2.0);
+            }
+
+            for (uint32_t i = 0; i < automationCount; ++i)
+            {
+                if (result.automation == kBenchAutomationStep)
+                    normalized = nextRandomFloat(randomState);
+
+                const uint32_t index = automationIndexes[i];
+                float value = plugin.getParameterRanges(index).getUnnormalizedValue(normalized);
+
+                if (plugin.isParameterInteger(index))
+                    value = std::round(value);
+
+                automationValues[i] = value;
+            }
+        }
+
+        const uint64_t allocationsBefore = d_getRealtimeAllocationCount();
+        const uint64_t startTime = d_gettime_ns();
+
+        {
+            // include parameter changes in the realtime scope, as hosts do them from the audio thread
+            const ScopedRealtimeThread srt;
+
+            if (automationCount != 0)
+                plugin.setParameterValues(automationIndexes.data(), automationValues.data(), automationCount);
+
+           #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+            plugin.run(inputs, outputs, blockSize, midiEvents, midiEventCount);
+           #else
+            plugin.run(inputs, outputs, blockSize);
+           #endif
+        }
+
+        const uint64_t endTime = d_gettime_ns();
+
+        if (b < warmupBlocks)
+            continue;
+
+        blockTimes[b - warmupBlocks] = endTime - startTime;
+        allocations += d_getRealtimeAllocationCount() - allocationsBefore;
+    }
+
+    plugin.deactivate();
+
+    uint64_t totalTime = 0;
+    for (uint32_t b = 0; b < blocks; ++b)
+        totalTime += blockTimes[b];
+
+    std::vector<uint64_t>::iterator p99 = blockTimes.begin() + std::min(blocks - 1, blocks * 99 / 100);
+    std::nth_element(blockTimes.begin(), p99, blockTimes.end());
+
+    result.blocks = blocks;
+    result.nsPerSample = static_cast<double>(totalTime) / (static_cast<double>(blocks) * blockSize);
+    result.meanBlockNs = static_cast<double>(totalTime) / blocks;
+    result.p99BlockNs = *p99;
+    result.maxBlockNs = *std::max_element(blockTimes.begin(), blockTimes.end());
+    result.dspLoad = result.nsPerSample * sampleRate / 1e9;
+    result.allocations = allocations;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// JSON output
+
+static void writeResults(FILE* const file, const std::vector<BenchResult>& results)
+{
+    // dummy instance for plugin information
+    d_nextBufferSize = 512;
+    d_nextSampleRate = 48000.0;
+    d_nextPluginIsDummy = true;
+    const PluginExporter plugin(nullptr, nullptr, nullptr, nullptr);
+    d_nextBufferSize = 0;
+    d_nextSampleRate = 0.0;
+    d_nextPluginIsDummy = false;
+
+    const uint32_t version = plugin.getVersion();
+
+    std::fprintf(file, "{\n");
+    std::fprintf(file, "  \"plugin\": {\n");
+    std::fprintf(file, "    \"name\": "); writeJsonString(file, plugin.getName()); std::fprintf(file, ",\n");
+    std::fprintf(file, "    \"label\": "); writeJsonString(file, plugin.getLabel()); std::fprintf(file, ",\n");
+    std::fprintf(file, "    \"maker\": "); writeJsonString(file, plugin.getMaker()); std::fprintf(file, ",\n");
+    std::fprintf(file, "    \"version\": \"%u.%u.%u\",\n", (version & 0xFF0000) >> 16, (version & 0x00FF00) >> 8, version & 0x0000FF);
+    std::fprintf(file, "    \"inputs\": %u,\n", DISTRHO_PLUGIN_NUM_INPUTS);
+    std::fprintf(file, "    \"outputs\": %u,\n", DISTRHO_PLUGIN_NUM_OUTPUTS);
+    std::fprintf(file, "    \"parameters\": %u\n", plugin.getParameterCount());
+    std::fprintf(file, "  },\n");
+    std::fprintf(file, "  \"results\": [");
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchResult& result(results[i]);
+
+        std::fprintf(file, "%s\n    {\n", i != 0 ? "," : "");
+        std::fprintf(file, "      \"sampleRate\": %g,\n", result.sampleRate);
+        std::fprintf(file, "      \"blockSize\": %u,\n", result.blockSize);
+        std::fprintf(file, "      \"midiDensity\": %u,\n", result.midiDensity);
+        std::fprintf(file, "      \"automation\": \"%s\",\n", kBenchAutomationNames[result.automation]);
+        std::fprintf(file, "      \"blocks\": %u,\n", result.blocks);
+        std::fprintf(file, "      \"nsPerSample\": %.3f,\n", result.nsPerSample);
+        std::fprintf(file, "      \"meanBlockNs\": %.1f,\n", result.meanBlockNs);
+        std::fprintf(file, "      \"p99BlockNs\": %llu,\n", static_cast<unsigned long long>(result.p99BlockNs));
+        std::fprintf(file, "      \"maxBlockNs\": %llu,\n", static_cast<unsigned long long>(result.maxBlockNs));
+        std::fprintf(file, "      \"dspLoad\": %.6f,\n", result.dspLoad);
+       #if DISTRHO_RT_SAFETY_HOOKS
+        std::fprintf(file, "      \"allocations\": %llu\n", static_cast<unsigned long long>(result.allocations));
+       #else
+        // allocations cannot be intercepted on this system
+        std::fprintf(file, "      \"allocations\": null\n");
+       #endif
+        std::fprintf(file, "    }");
+    }
+
+    std::fprintf(file, "\n  ]\n}\n");
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+int main(int argc, char* argv[])
+{
+    USE_NAMESPACE_DISTRHO;
+
+    BenchOptions options;
+    options.sampleRates.push_back(48000.0);
+    options.blockSizes.push_back(64);
+    options.blockSizes.push_back(256);
+    options.blockSizes.push_back(1024);
+    options.midiDensities.push_back(0);
+    options.automations.push_back(kBenchAutomationNone);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* const arg = argv[i];
+
+        if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0)
+        {
+            printUsage(stdout, argv[0]);
+            return 0;
+        }
+
+        if (i + 1 >= argc)
+        {
+            d_stderr2("Missing value for argument '%s'", arg);
+            return 1;
+        }
+
+        const char* const value = argv[++i];
+        bool ok;
+
+        /**/ if (std::strcmp(arg, "--sample-rates") == 0)
+            ok = parseList(value, options.sampleRates, 1.0);
+        else if (std::strcmp(arg, "--block-sizes") == 0)
+            ok = parseList(value, options.blockSizes, 1.0);
+        else if (std::strcmp(arg, "--midi-densities") == 0)
+            ok = parseList(value, options.midiDensities, 0.0);
+        else if (std::strcmp(arg, "--automation") == 0)
+            ok = parseAutomationList(value, options.automations);
+        else if (std::strcmp(arg, "--seconds") == 0)
+            ok = (options.seconds = std::atof(value)) > 0.0;
+        else if (std::strcmp(arg, "--warmup") == 0)
+            ok = (options.warmupSeconds = std::atof(value)) >= 0.0;
+        else if (std::strcmp(arg, "--output") == 0)
+            ok = (options.outputFilename = value)[0] != '\0';
+        else
+        {
+            d_stderr2("Unknown argument '%s'", arg);
+            printUsage(stderr, argv[0]);
+            return 1;
+        }
+
+        if (! ok)
+        {
+            d_stderr2("Invalid value '%s' for argument '%s'", value, arg);
+            return 1;
+        }
+    }
+
+   #if ! DISTRHO_PLUGIN_WANT_MIDI_INPUT
+    // plugin takes no MIDI, avoid duplicated results
+    options.midiDensities.assign(1, 0);
+   #endif
+
+    std::vector<BenchResult> results;
+
+    for (size_t sr = 0; sr < options.sampleRates.size(); ++sr)
+    {
+        for (size_t bs = 0; bs < options.blockSizes.size(); ++bs)
+        {
+            for (size_t md = 0; md < options.midiDensities.size(); ++md)
+            {
+                for (size_t au = 0; au < options.automations.size(); ++au)
+                {
+                    BenchResult result;
+                    std::memset(&result, 0, sizeof(result));
+                    result.sampleRate = options.sampleRates[sr];
+                    result.blockSize = options.blockSizes[bs];
+                    result.midiDensity = options.midiDensities[md];
+                    result.automation = options.automations[au];
+
+                    runBenchmark(options, result);
+                    results.push_back(result);
+                }
+            }
+        }
+    }
+
+    FILE* const file = options.outputFilename != nullptr ? std::fopen(options.outputFilename, "w") : stdout;
+
+    if (file == nullptr)
+    {
+        d_stderr2("Failed to open '%s' for writing", options.outputFilename);
+        return 1;
+    }
+
+    writeResults(file, results);
+
+    if (file != stdout)
+        std::fclose(file);
+
+    return 0;
+}
@@ -43,6 +43,7 @@
 # include "../extra/RingBuffer.hpp"
 #endif
 
+#include <atomic>
 #include <map>
 #include <vector>
 
@@ -53,8 +54,11 @@
 #include "clap/ext/gui.h"
 #include "clap/ext/note-ports.h"
 #include "clap/ext/params.h"
+#include "clap/ext/render.h"
 #include "clap/ext/state.h"
+#include "clap/ext/tail.h"
 #include "clap/ext/thread-check.h"
+#include "clap/ext/thread-pool.h"
 #include "clap/ext/timer-support.h"
 
 #if defined(DISTRHO_OS_MAC) || defined(DISTRHO_OS_WINDOWS)
@@ -73,6 +77,69 @@ START_NAMESPACE_DISTRHO
 
 typedef std::map<const String, String> StringMap;
 
+// --------------------------------------------------------------------------------------------------------------------
+// get the channel buffers of an audio port matching the requested sample size
+
+template<typename T>
+static inline
+T** getChannelBuffers(const clap_audio_buffer_t& buffer) noexcept;
+
+template<>
+inline
+float** getChannelBuffers<float>(const clap_audio_buffer_t& buffer) noexcept
+{
+    return buffer.data32;
+}
+
+#if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+template<>
+inline
+double** getChannelBuffers<double>(const clap_audio_buffer_t& buffer) noexcept
+{
+    return buffer.data64;
+}
+
+// check if the host provides 64-bit audio, all our ports are required to use the same sample size
+static inline
+bool isProcessingDoublePrecision(const clap_process_t* const process) noexcept
+{
+    if (process->audio_outputs_count != 0)
+        return process->audio_outputs[0].data32 == nullptr && process->audio_outputs[0].data64 != nullptr;
+    if (process->audio_inputs_count != 0)
+        return process->audio_inputs[0].data32 == nullptr && process->audio_inputs[0].data64 != nullptr;
+    return false;
+}
+#endif
+
+#if DISTRHO_PLUGIN_WANT_SILENCE_DETECTION && DISTRHO_PLUGIN_NUM_OUTPUTS != 0
+// get the constant_mask for an audio buffer, CLAP requires every sample of a constant channel to be equal,
+// so only channels made of exact zeros count, not those that are merely silent
+template<typename T>
+static inline
+uint64_t getZeroChannelMask(const clap_audio_buffer_t& buffer, const uint32_t frames) noexcept
+{
+    T** const channels = getChannelBuffers<T>(buffer);
+    uint64_t mask = 0;
+
+    if (channels == nullptr)
+        return mask;
+
+    for (uint32_t c=0; c<buffer.channel_count && c<64; ++c)
+    {
+        if (channels[c] == nullptr)
+            continue;
+
+        uint32_t i=0;
+        for (; i<frames && channels[c][i] == 0; ++i) {}
+
+        if (i == frames)
+            mask |= 1ULL << c;
+    }
+
+    return mask;
+}
+#endif
+
 struct ClapEventQueue
 {
   #if DISTRHO_PLUGIN_HAS_UI
@@ -143,16 +210,22 @@ struct ClapEventQueue
         uint numParams;
         bool* changed;
         float* values;
+        uint32_t* batchIndexes;
+        float* batchValues;
 
         CachedParameters()
             : numParams(0),
               changed(nullptr),
-              values(nullptr) {}
+              values(nullptr),
+              batchIndexes(nullptr),
+              batchValues(nullptr) {}
 
         ~CachedParameters()
         {
             delete[] changed;
             delete[] values;
+            delete[] batchIndexes;
+            delete[] batchValues;
         }
 
         void setup(const uint numParameters)
@@ -163,6 +236,8 @@ struct ClapEventQueue
             numParams = numParameters;
             changed = new bool[numParameters];
             values = new float[numParameters];
+            batchIndexes = new uint32_t[numParameters];
+            batchValues = new float[numParameters];
 
             std::memset(changed, 0, sizeof(bool)*numParameters);
             std::memset(values, 0, sizeof(float)*numParameters);
@@ -648,6 +723,10 @@ private:
 
     void setParameterValue(const uint32_t rindex, const float value)
     {
+       #ifdef DPF_TRACING
+        fPlugin.traceUiMessage("parameter");
+       #endif
+
         const ClapEventQueue::Event ev = {
             ClapEventQueue::kEventParamSet,
             rindex, value
@@ -685,6 +764,10 @@ private:
    #if DISTRHO_PLUGIN_WANT_STATE
     void setState(const char* const key, const char* const value)
     {
+       #ifdef DPF_TRACING
+        fPlugin.traceUiMessage("state");
+       #endif
+
         fPluginEventQueue->setStateFromUI(key, value);
     }
 
@@ -701,6 +784,11 @@ private:
         midiData[0] = (velocity != 0 ? 0x90 : 0x80) | channel;
         midiData[1] = note;
         midiData[2] = velocity;
+
+       #ifdef DPF_TRACING
+        fPlugin.traceUiMessage("note");
+       #endif
+
         fNotesRingBuffer.writeCustomData(midiData, 3);
         fNotesRingBuffer.commitWrite();
     }
@@ -754,6 +842,11 @@ public:
           fHost(host),
           fOutputEvents(nullptr),
           fResetParameterIndex(UINT32_MAX),
+          fOfflineRendering(false),
+         #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+          fParallelTaskFunc(nullptr),
+          fParallelTaskPtr(nullptr),
+         #endif
          #if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS != 0
           fUsingCV(false),
          #endif
@@ -817,11 +910,20 @@ public:
         if (!clap_version_is_compatible(fHost->clap_version))
             return false;
 
-        return fHostExtensions.init();
+        if (! fHostExtensions.init())
+            return false;
+
+       #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+        if (fHostExtensions.threadPool != nullptr && fHostExtensions.threadPool->request_exec != nullptr)
+            fPlugin.setThreadPoolCallback(this, executeParallelCallback);
+       #endif
+
+        return true;
     }
 
     void activate(const double sampleRate, const uint32_t maxFramesCount)
     {
+        fPlugin.setOffline(fOfflineRendering.load(), true);
         fPlugin.setSampleRate(sampleRate, true);
         fPlugin.setBufferSize(maxFramesCount, true);
         fPlugin.activate();
@@ -858,6 +960,9 @@ public:
         fMidiEventCount = 0;
        #endif
 
+        // render mode changed while active, apply it before running
+        fPlugin.setOffline(fOfflineRendering.load(), true);
+
        #if DISTRHO_PLUGIN_HAS_UI
         if (const clap_output_events_t* const outputEvents = process->out_events)
         {
@@ -1006,7 +1111,15 @@ public:
                         DISTRHO_SAFE_ASSERT_UINT2_BREAK(event->size == sizeof(clap_event_param_value_t),
                                                         event->size, sizeof(clap_event_param_value_t));
                         if (event->space_id == 0)
+                        {
+                           #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+                            // late events keep their order, changes past the end of the block are applied after it
+                            setParameterValueFromEvent(reinterpret_cast<const clap_event_param_value_t*>(event),
+                                                       event->time);
+                           #else
                             setParameterValueFromEvent(reinterpret_cast<const clap_event_param_value_t*>(event));
+                           #endif
+                        }
                         break;
                     case CLAP_EVENT_PARAM_MOD:
                     case CLAP_EVENT_PARAM_GESTURE_BEGIN:
@@ -1052,71 +1165,16 @@ public:
 
         if (const uint32_t frames = process->frames_count)
         {
-           #if DISTRHO_PLUGIN_NUM_INPUTS != 0
-            const float** const audioInputs = fAudioInputs;
-
-            uint32_t in=0;
-            for (uint32_t i=0; i<process->audio_inputs_count; ++i)
-            {
-                const clap_audio_buffer_t& inputs(process->audio_inputs[i]);
-                DISTRHO_SAFE_ASSERT_CONTINUE(inputs.channel_count != 0);
-
-                for (uint32_t j=0; j<inputs.channel_count; ++j, ++in)
-                    audioInputs[in] = const_cast<const float*>(inputs.data32[j]);
-            }
-
-            if (fUsingCV)
-            {
-                for (; in<DISTRHO_PLUGIN_NUM_INPUTS; ++in)
-                    audioInputs[in] = nullptr;
-            }
-            else
-            {
-                DISTRHO_SAFE_ASSERT_UINT2_RETURN(in == DISTRHO_PLUGIN_NUM_INPUTS,
-                                                 in, process->audio_inputs_count, false);
-            }
-           #else
-            constexpr const float** const audioInputs = nullptr;
-           #endif
-
-           #if DISTRHO_PLUGIN_NUM_OUTPUTS != 0
-            float** const audioOutputs = fAudioOutputs;
-
-            uint32_t out=0;
-            for (uint32_t i=0; i<process->audio_outputs_count; ++i)
+           #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+            if (isProcessingDoublePrecision(process))
             {
-                const clap_audio_buffer_t& outputs(process->audio_outputs[i]);
-                DISTRHO_SAFE_ASSERT_CONTINUE(outputs.channel_count != 0);
-
-                for (uint32_t j=0; j<outputs.channel_count; ++j, ++out)
-                    audioOutputs[out] = outputs.data32[j];
-            }
-
-            if (fUsingCV)
-            {
-                for (; out<DISTRHO_PLUGIN_NUM_OUTPUTS; ++out)
-                    audioOutputs[out] = nullptr;
+                if (! runWithAudioBuffers<double>(process, frames))
+                    return false;
             }
             else
-            {
-                DISTRHO_SAFE_ASSERT_UINT2_RETURN(out == DISTRHO_PLUGIN_NUM_OUTPUTS,
-                                                 out, DISTRHO_PLUGIN_NUM_OUTPUTS, false);
-            }
-           #else
-            constexpr float** const audioOutputs = nullptr;
-           #endif
-
-            fOutputEvents = process->out_events;
-
-           #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-            fPlugin.run(audioInputs, audioOutputs, frames, fMidiEvents, fMidiEventCount);
-           #else
-            fPlugin.run(audioInputs, audioOutputs, frames);
            #endif
-
-            flushParameters(nullptr, process->out_events, frames - 1);
-
-            fOutputEvents = nullptr;
+            if (! runWithAudioBuffers<float>(process, frames))
+                return false;
         }
 
        #if DISTRHO_PLUGIN_WANT_LATENCY
@@ -1289,7 +1347,11 @@ public:
             };
 
             float value;
+           #if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+            for (uint32_t i=0; fPlugin.getNextChangedParameter(i); ++i)
+           #else
             for (uint i=0; i<fCachedParameters.numParams; ++i)
+           #endif
             {
                 if (fPlugin.isParameterOutputOrTrigger(i))
                 {
@@ -1346,11 +1408,17 @@ public:
     }
    #endif
 
-    void setParameterValueFromEvent(const clap_event_param_value_t* const event)
+    void setParameterValueFromEvent(const clap_event_param_value_t* const event, const uint32_t frame = 0)
     {
         fCachedParameters.values[event->param_id] = event->value;
         fCachedParameters.changed[event->param_id] = true;
+       #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+        fPlugin.setParameterValueAtFrame(frame, event->param_id, event->value);
+       #else
         fPlugin.setParameterValue(event->param_id, event->value);
+        // unused
+        (void)frame;
+       #endif
     }
 
     // ----------------------------------------------------------------------------------------------------------------
@@ -1375,6 +1443,11 @@ public:
         d_strncpy(info->name, busInfo.name, CLAP_NAME_SIZE);
 
         info->flags = busInfo.isMain ? CLAP_AUDIO_PORT_IS_MAIN : 0x0;
+       #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+        info->flags |= CLAP_AUDIO_PORT_SUPPORTS_64BITS
+                    |  CLAP_AUDIO_PORT_PREFERS_64BITS
+                    |  CLAP_AUDIO_PORT_REQUIRES_COMMON_SAMPLE_SIZE;
+       #endif
         info->channel_count = busInfo.numChannels;
 
         switch (busInfo.groupId)
@@ -1395,6 +1468,50 @@ public:
     }
    #endif
 
+    // ----------------------------------------------------------------------------------------------------------------
+    // render
+
+    bool setRenderMode(const clap_plugin_render_mode mode)
+    {
+        DISTRHO_SAFE_ASSERT_INT_RETURN(mode == CLAP_RENDER_REALTIME || mode == CLAP_RENDER_OFFLINE, mode, false);
+
+        const bool offline = mode == CLAP_RENDER_OFFLINE;
+        fOfflineRendering = offline;
+
+        // if active, this is applied on the next process call instead
+        if (! fPlugin.isActive())
+            fPlugin.setOffline(offline, true);
+
+        return true;
+    }
+
+   #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+    // ----------------------------------------------------------------------------------------------------------------
+    // thread pool
+
+    void execParallelTask(const uint32_t taskIndex)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fParallelTaskFunc != nullptr,);
+
+        fParallelTaskFunc(fParallelTaskPtr, taskIndex);
+    }
+   #endif
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // tail
+
+    uint32_t getTailLength() const
+    {
+        return fPlugin.getTailLength();
+    }
+
+   #if DISTRHO_PLUGIN_WANT_SILENCE_DETECTION
+    bool isIdle() const
+    {
+        return fPlugin.isIdle();
+    }
+   #endif
+
     // ----------------------------------------------------------------------------------------------------------------
     // latency
 
@@ -1565,6 +1682,7 @@ public:
         bool hasValue = false;
         bool fillingKey = true; // if filling key or value
         char queryingType = 'i'; // can be 'n', 's' or 'p' (none, states, parameters)
+        uint32_t parameterBatchCount = 0;
 
         char buffer[512], orig;
         buffer[sizeof(buffer)-1] = '\xff';
@@ -1575,7 +1693,10 @@ public:
             DISTRHO_SAFE_ASSERT_INT_RETURN(read >= 0, read, false);
 
             if (read == 0)
+            {
+                fPlugin.setParameterValues(fCachedParameters.batchIndexes, fCachedParameters.batchValues, parameterBatchCount);
                 return !empty;
+            }
 
             empty = false;
             for (int32_t i = 0; i < read; ++i)
@@ -1701,15 +1822,11 @@ public:
                     {
                         d_debug("found parameter '%s' '%s'", key.buffer(), value.buffer());
                         float fvalue;
+                        uint32_t j;
 
                         // find parameter with this symbol, and set its value
-                        for (uint32_t j=0; j<fCachedParameters.numParams; ++j)
+                        if (fPlugin.getParameterIndexForSymbol(key, j) && ! fPlugin.isParameterOutputOrTrigger(j))
                         {
-                            if (fPlugin.isParameterOutputOrTrigger(j))
-                                continue;
-                            if (fPlugin.getParameterSymbol(j) != key)
-                                continue;
-
                             if (fPlugin.getParameterHints(j) & kParameterIsInteger)
                             {
                                 fvalue = std::atoi(value.buffer());
@@ -1728,8 +1845,14 @@ public:
                                 fCachedParameters.changed[j] = true;
                             }
                            #endif
-                            fPlugin.setParameterValue(j, fvalue);
-                            break;
+
+                            // plugin parameter updates are also handled outside the read loop, as a single batch
+                            if (parameterBatchCount < fCachedParameters.numParams)
+                            {
+                                fCachedParameters.batchIndexes[parameterBatchCount] = j;
+                                fCachedParameters.batchValues[parameterBatchCount] = fvalue;
+                                ++parameterBatchCount;
+                            }
                         }
                     }
 
@@ -1740,6 +1863,8 @@ public:
             }
         }
 
+        fPlugin.setParameterValues(fCachedParameters.batchIndexes, fCachedParameters.batchValues, parameterBatchCount);
+
         if (fHostExtensions.params != nullptr)
             fHostExtensions.params->rescan(fHost, CLAP_PARAM_RESCAN_VALUES|CLAP_PARAM_RESCAN_TEXT);
 
@@ -1824,11 +1949,11 @@ private:
     const clap_output_events_t* fOutputEvents;
 
     uint32_t fResetParameterIndex;
-   #if DISTRHO_PLUGIN_NUM_INPUTS != 0
-    const float* fAudioInputs[DISTRHO_PLUGIN_NUM_INPUTS];
-   #endif
-   #if DISTRHO_PLUGIN_NUM_OUTPUTS != 0
-    float* fAudioOutputs[DISTRHO_PLUGIN_NUM_OUTPUTS];
+    // written by setRenderMode on the main thread, read by process on the audio thread
+    std::atomic<bool> fOfflineRendering;
+   #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+    Plugin::ParallelTaskFunc fParallelTaskFunc;
+    void* fParallelTaskPtr;
    #endif
    #if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS != 0
     bool fUsingCV;
@@ -1851,6 +1976,9 @@ private:
     struct HostExtensions {
         const clap_host_t* const host;
         const clap_host_params_t* params;
+       #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+        const clap_host_thread_pool_t* threadPool;
+       #endif
        #if DISTRHO_PLUGIN_WANT_LATENCY
         const clap_host_latency_t* latency;
         const clap_host_thread_check_t* threadCheck;
@@ -1859,6 +1987,9 @@ private:
         HostExtensions(const clap_host_t* const host)
             : host(host),
               params(nullptr)
+           #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+            , threadPool(nullptr)
+           #endif
            #if DISTRHO_PLUGIN_WANT_LATENCY
             , latency(nullptr)
             , threadCheck(nullptr)
@@ -1868,6 +1999,9 @@ private:
         bool init()
         {
             params = static_cast<const clap_host_params_t*>(host->get_extension(host, CLAP_EXT_PARAMS));
+           #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+            threadPool = static_cast<const clap_host_thread_pool_t*>(host->get_extension(host, CLAP_EXT_THREAD_POOL));
+           #endif
            #if DISTRHO_PLUGIN_WANT_LATENCY
             DISTRHO_SAFE_ASSERT_RETURN(host->request_restart != nullptr, false);
             DISTRHO_SAFE_ASSERT_RETURN(host->request_callback != nullptr, false);
@@ -2040,6 +2174,94 @@ private:
     }
    #endif
 
+    // ----------------------------------------------------------------------------------------------------------------
+    // helper functions called during process
+
+    // collect the host audio buffers and run the plugin, T matches the sample size provided by the host
+    template<typename T>
+    bool runWithAudioBuffers(const clap_process_t* const process, const uint32_t frames)
+    {
+       #if DISTRHO_PLUGIN_NUM_INPUTS != 0
+        const T* audioInputs[DISTRHO_PLUGIN_NUM_INPUTS];
+
+        uint32_t in=0;
+        for (uint32_t i=0; i<process->audio_inputs_count; ++i)
+        {
+            const clap_audio_buffer_t& inputs(process->audio_inputs[i]);
+            DISTRHO_SAFE_ASSERT_CONTINUE(inputs.channel_count != 0);
+
+            for (uint32_t j=0; j<inputs.channel_count; ++j, ++in)
+                audioInputs[in] = const_cast<const T*>(getChannelBuffers<T>(inputs)[j]);
+        }
+
+        if (fUsingCV)
+        {
+            for (; in<DISTRHO_PLUGIN_NUM_INPUTS; ++in)
+                audioInputs[in] = nullptr;
+        }
+        else
+        {
+            DISTRHO_SAFE_ASSERT_UINT2_RETURN(in == DISTRHO_PLUGIN_NUM_INPUTS,
+                                             in, process->audio_inputs_count, false);
+        }
+       #else
+        constexpr const T** const audioInputs = nullptr;
+       #endif
+
+       #if DISTRHO_PLUGIN_NUM_OUTPUTS != 0
+        T* audioOutputs[DISTRHO_PLUGIN_NUM_OUTPUTS];
+
+        uint32_t out=0;
+        for (uint32_t i=0; i<process->audio_outputs_count; ++i)
+        {
+            const clap_audio_buffer_t& outputs(process->audio_outputs[i]);
+            DISTRHO_SAFE_ASSERT_CONTINUE(outputs.channel_count != 0);
+
+            for (uint32_t j=0; j<outputs.channel_count; ++j, ++out)
+                audioOutputs[out] = getChannelBuffers<T>(outputs)[j];
+        }
+
+        if (fUsingCV)
+        {
+            for (; out<DISTRHO_PLUGIN_NUM_OUTPUTS; ++out)
+                audioOutputs[out] = nullptr;
+        }
+        else
+        {
+            DISTRHO_SAFE_ASSERT_UINT2_RETURN(out == DISTRHO_PLUGIN_NUM_OUTPUTS,
+                                             out, DISTRHO_PLUGIN_NUM_OUTPUTS, false);
+        }
+       #else
+        constexpr T** const audioOutputs = nullptr;
+       #endif
+
+        fOutputEvents = process->out_events;
+
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        fPlugin.run(audioInputs, audioOutputs, frames, fMidiEvents, fMidiEventCount);
+       #else
+        fPlugin.run(audioInputs, audioOutputs, frames);
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_SILENCE_DETECTION && DISTRHO_PLUGIN_NUM_OUTPUTS != 0
+        // let the host know about outputs that are all zeros, silent ones can still have tiny values
+        {
+            const bool silent = fPlugin.isOutputSilent();
+
+            for (uint32_t i=0; i<process->audio_outputs_count; ++i)
+                process->audio_outputs[i].constant_mask = silent
+                                                        ? getZeroChannelMask<T>(process->audio_outputs[i], frames)
+                                                        : 0;
+        }
+       #endif
+
+        flushParameters(nullptr, process->out_events, frames - 1);
+
+        fOutputEvents = nullptr;
+
+        return true;
+    }
+
     // ----------------------------------------------------------------------------------------------------------------
     // DPF callbacks
 
@@ -2089,11 +2311,36 @@ private:
         return static_cast<PluginCLAP*>(ptr)->updateState(key, value);
     }
    #endif
+
+   #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+    bool executeParallel(const uint32_t taskCount, const Plugin::ParallelTaskFunc callback, void* const ptr)
+    {
+        fParallelTaskFunc = callback;
+        fParallelTaskPtr = ptr;
+
+        const bool ok = fHostExtensions.threadPool->request_exec(fHost, taskCount);
+
+        fParallelTaskFunc = nullptr;
+        fParallelTaskPtr = nullptr;
+        return ok;
+    }
+
+    static bool executeParallelCallback(void* const ptr, const uint32_t taskCount,
+                                        const Plugin::ParallelTaskFunc callback, void* const callbackPtr)
+    {
+        return static_cast<PluginCLAP*>(ptr)->executeParallel(taskCount, callback, callbackPtr);
+    }
+   #endif
 };
 
 // --------------------------------------------------------------------------------------------------------------------
+// Dummy plugin to get data from (or build-time metadata if available)
 
+#if DISTRHO_PLUGIN_HAS_STATIC_METADATA
+static constexpr const PluginStaticMetadata* const sPlugin = &kPluginStaticMetadata;
+#else
 static ScopedPointer<PluginExporter> sPlugin;
+#endif
 
 // --------------------------------------------------------------------------------------------------------------------
 // plugin gui
@@ -2408,6 +2655,53 @@ static const clap_plugin_params_t clap_plugin_params = {
     clap_plugin_params_flush
 };
 
+// --------------------------------------------------------------------------------------------------------------------
+// plugin render
+
+static bool CLAP_ABI clap_plugin_render_has_hard_realtime_requirement(const clap_plugin_t*)
+{
+    return false;
+}
+
+static bool CLAP_ABI clap_plugin_render_set(const clap_plugin_t* const plugin, const clap_plugin_render_mode mode)
+{
+    PluginCLAP* const instance = static_cast<PluginCLAP*>(plugin->plugin_data);
+    return instance->setRenderMode(mode);
+}
+
+static const clap_plugin_render_t clap_plugin_render = {
+    clap_plugin_render_has_hard_realtime_requirement,
+    clap_plugin_render_set
+};
+
+#if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+// --------------------------------------------------------------------------------------------------------------------
+// plugin thread pool
+
+static void CLAP_ABI clap_plugin_thread_pool_exec(const clap_plugin_t* const plugin, const uint32_t task_index)
+{
+    PluginCLAP* const instance = static_cast<PluginCLAP*>(plugin->plugin_data);
+    instance->execParallelTask(task_index);
+}
+
+static const clap_plugin_thread_pool_t clap_plugin_thread_pool = {
+    clap_plugin_thread_pool_exec
+};
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+// plugin tail
+
+static uint32_t CLAP_ABI clap_plugin_tail_get(const clap_plugin_t* const plugin)
+{
+    PluginCLAP* const instance = static_cast<PluginCLAP*>(plugin->plugin_data);
+    return instance->getTailLength();
+}
+
+static const clap_plugin_tail_t clap_plugin_tail = {
+    clap_plugin_tail_get
+};
+
 #if DISTRHO_PLUGIN_WANT_LATENCY
 // --------------------------------------------------------------------------------------------------------------------
 // plugin latency
@@ -2497,7 +2791,17 @@ static void CLAP_ABI clap_plugin_reset(const clap_plugin_t* const plugin)
 static clap_process_status CLAP_ABI clap_plugin_process(const clap_plugin_t* const plugin, const clap_process_t* const process)
 {
     PluginCLAP* const instance = static_cast<PluginCLAP*>(plugin->plugin_data);
-    return instance->process(process) ? CLAP_PROCESS_CONTINUE : CLAP_PROCESS_ERROR;
+
+    if (! instance->process(process))
+        return CLAP_PROCESS_ERROR;
+
+   #if DISTRHO_PLUGIN_WANT_SILENCE_DETECTION
+    // the tail has played out, nothing to do until new input arrives
+    if (instance->isIdle())
+        return CLAP_PROCESS_SLEEP;
+   #endif
+
+    return CLAP_PROCESS_CONTINUE;
 }
 
 static const void* CLAP_ABI clap_plugin_get_extension(const clap_plugin_t*, const char* const id)
@@ -2506,6 +2810,10 @@ static const void* CLAP_ABI clap_plugin_get_extension(const clap_plugin_t*, cons
         return &clap_plugin_params;
     if (std::strcmp(id, CLAP_EXT_STATE) == 0)
         return &clap_plugin_state;
+    if (std::strcmp(id, CLAP_EXT_RENDER) == 0)
+        return &clap_plugin_render;
+    if (std::strcmp(id, CLAP_EXT_TAIL) == 0)
+        return &clap_plugin_tail;
    #if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS != 0
     if (std::strcmp(id, CLAP_EXT_AUDIO_PORTS) == 0)
         return &clap_plugin_audio_ports;
@@ -2518,6 +2826,10 @@ static const void* CLAP_ABI clap_plugin_get_extension(const clap_plugin_t*, cons
     if (std::strcmp(id, CLAP_EXT_LATENCY) == 0)
         return &clap_plugin_latency;
    #endif
+   #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+    if (std::strcmp(id, CLAP_EXT_THREAD_POOL) == 0)
+        return &clap_plugin_thread_pool;
+   #endif
   #if DISTRHO_PLUGIN_HAS_UI
     if (std::strcmp(id, CLAP_EXT_GUI) == 0)
         return &clap_plugin_gui;
@@ -2631,6 +2943,7 @@ static bool CLAP_ABI clap_plugin_entry_init(const char* const plugin_path)
     bundlePath = plugin_path;
     d_nextBundlePath = bundlePath.buffer();
 
+   #if ! DISTRHO_PLUGIN_HAS_STATIC_METADATA
     // init dummy plugin
     if (sPlugin == nullptr)
     {
@@ -2649,13 +2962,16 @@ static bool CLAP_ABI clap_plugin_entry_init(const char* const plugin_path)
         d_nextPluginIsDummy = false;
         d_nextCanRequestParameterValueChanges = false;
     }
+   #endif
 
     return true;
 }
 
 static void CLAP_ABI clap_plugin_entry_deinit(void)
 {
+   #if ! DISTRHO_PLUGIN_HAS_STATIC_METADATA
     sPlugin = nullptr;
+   #endif
 }
 
 static const void* CLAP_ABI clap_plugin_entry_get_factory(const char* const factory_id)
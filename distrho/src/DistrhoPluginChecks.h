@@ -45,6 +45,14 @@
 // --------------------------------------------------------------------------------------------------------------------
 // Define optional macros if not done yet
 
+#ifndef DISTRHO_PLUGIN_FIXED_BLOCK_SIZE
+# define DISTRHO_PLUGIN_FIXED_BLOCK_SIZE 0
+#endif
+
+#ifndef DISTRHO_PLUGIN_HAS_STATIC_METADATA
+# define DISTRHO_PLUGIN_HAS_STATIC_METADATA 0
+#endif
+
 #ifndef DISTRHO_PLUGIN_HAS_UI
 # define DISTRHO_PLUGIN_HAS_UI 0
 #endif
@@ -57,10 +65,34 @@
 # define DISTRHO_PLUGIN_IS_SYNTH 0
 #endif
 
+#ifndef DISTRHO_PLUGIN_MAX_MIDI_EVENTS
+# define DISTRHO_PLUGIN_MAX_MIDI_EVENTS 2048
+#endif
+
+#ifndef DISTRHO_PLUGIN_MAX_MIDI_EVENTS_PER_RUN
+# if DISTRHO_PLUGIN_MAX_MIDI_EVENTS < 512
+#  define DISTRHO_PLUGIN_MAX_MIDI_EVENTS_PER_RUN DISTRHO_PLUGIN_MAX_MIDI_EVENTS
+# else
+#  define DISTRHO_PLUGIN_MAX_MIDI_EVENTS_PER_RUN 512
+# endif
+#endif
+
+#ifndef DISTRHO_PLUGIN_SCRATCH_BUFFER_COUNT
+# define DISTRHO_PLUGIN_SCRATCH_BUFFER_COUNT 0
+#endif
+
 #ifndef DISTRHO_PLUGIN_WANT_DIRECT_ACCESS
 # define DISTRHO_PLUGIN_WANT_DIRECT_ACCESS 0
 #endif
 
+#ifndef DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+# define DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION 0
+#endif
+
+#ifndef DISTRHO_PLUGIN_WANT_DSP_LOAD
+# define DISTRHO_PLUGIN_WANT_DSP_LOAD 0
+#endif
+
 #ifndef DISTRHO_PLUGIN_WANT_LATENCY
 # define DISTRHO_PLUGIN_WANT_LATENCY 0
 #endif
@@ -73,6 +105,34 @@
 # define DISTRHO_PLUGIN_WANT_MIDI_OUTPUT 0
 #endif
 
+#ifndef DISTRHO_PLUGIN_WANT_OFFLINE_MODE
+# define DISTRHO_PLUGIN_WANT_OFFLINE_MODE 0
+#endif
+
+#ifndef DISTRHO_PLUGIN_WANT_OVERSAMPLING
+# define DISTRHO_PLUGIN_WANT_OVERSAMPLING 0
+#endif
+
+#ifndef DISTRHO_PLUGIN_OVERSAMPLING_FACTOR
+# if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+#  define DISTRHO_PLUGIN_OVERSAMPLING_FACTOR 2
+# else
+#  define DISTRHO_PLUGIN_OVERSAMPLING_FACTOR 1
+# endif
+#endif
+
+#ifndef DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+# define DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION 0
+#endif
+
+#ifndef DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+# define DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING 0
+#endif
+
+#ifndef DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+# define DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING 0
+#endif
+
 #ifndef DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST
 # define DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST 0
 #endif
@@ -81,6 +141,18 @@
 # define DISTRHO_PLUGIN_WANT_PROGRAMS 0
 #endif
 
+#ifndef DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+# define DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS 0
+#endif
+
+#ifndef DISTRHO_PLUGIN_WANT_SHARED_PARAMETERS
+# define DISTRHO_PLUGIN_WANT_SHARED_PARAMETERS 0
+#endif
+
+#ifndef DISTRHO_PLUGIN_WANT_SILENCE_DETECTION
+# define DISTRHO_PLUGIN_WANT_SILENCE_DETECTION 0
+#endif
+
 #ifndef DISTRHO_PLUGIN_WANT_STATE
 # define DISTRHO_PLUGIN_WANT_STATE 0
 #endif
@@ -90,10 +162,18 @@
 # define DISTRHO_PLUGIN_WANT_FULL_STATE_WAS_NOT_SET
 #endif
 
+#ifndef DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS
+# define DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS 0
+#endif
+
 #ifndef DISTRHO_PLUGIN_WANT_TIMEPOS
 # define DISTRHO_PLUGIN_WANT_TIMEPOS 0
 #endif
 
+#ifndef DISTRHO_PLUGIN_WANT_WORKER
+# define DISTRHO_PLUGIN_WANT_WORKER 0
+#endif
+
 #ifndef DISTRHO_UI_FILE_BROWSER
 # define DISTRHO_UI_FILE_BROWSER 0
 #endif
@@ -175,6 +255,13 @@
 # error invalid build config: web view requested but `USE_WEB_VIEW` build option is not set
 #endif
 
+// --------------------------------------------------------------------------------------------------------------------
+// Test if plugin class is given without its header
+
+#if defined(DISTRHO_PLUGIN_CLASS) && !defined(DISTRHO_PLUGIN_CLASS_HEADER)
+# error DISTRHO_PLUGIN_CLASS requires DISTRHO_PLUGIN_CLASS_HEADER to be set too
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 // Test if synth has audio outputs
 
@@ -219,6 +306,14 @@
 # define DISTRHO_PLUGIN_WANT_FULL_STATE 1
 #endif
 
+// --------------------------------------------------------------------------------------------------------------------
+// Enable latency if plugin wants oversampling or a fixed block size, as both add some
+
+#if (DISTRHO_PLUGIN_WANT_OVERSAMPLING || DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0) && ! DISTRHO_PLUGIN_WANT_LATENCY
+# undef DISTRHO_PLUGIN_WANT_LATENCY
+# define DISTRHO_PLUGIN_WANT_LATENCY 1
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 // Disable UI if DGL is not available
 
@@ -238,6 +333,36 @@
 # error DISTRHO_UI_DEFAULT_HEIGHT is defined but DISTRHO_UI_DEFAULT_WIDTH is not
 #endif
 
+// --------------------------------------------------------------------------------------------------------------------
+// Make sure MIDI event limits are sane
+
+#if DISTRHO_PLUGIN_MAX_MIDI_EVENTS < 1 || DISTRHO_PLUGIN_MAX_MIDI_EVENTS_PER_RUN < 1
+# error DISTRHO_PLUGIN_MAX_MIDI_EVENTS and DISTRHO_PLUGIN_MAX_MIDI_EVENTS_PER_RUN must be at least 1
+#endif
+
+#if DISTRHO_PLUGIN_MAX_MIDI_EVENTS_PER_RUN > DISTRHO_PLUGIN_MAX_MIDI_EVENTS
+# error DISTRHO_PLUGIN_MAX_MIDI_EVENTS_PER_RUN cannot be higher than DISTRHO_PLUGIN_MAX_MIDI_EVENTS
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+// Make sure oversampling factor is valid
+
+#if DISTRHO_PLUGIN_OVERSAMPLING_FACTOR != 1 && DISTRHO_PLUGIN_OVERSAMPLING_FACTOR != 2 && \
+    DISTRHO_PLUGIN_OVERSAMPLING_FACTOR != 4 && DISTRHO_PLUGIN_OVERSAMPLING_FACTOR != 8
+# error DISTRHO_PLUGIN_OVERSAMPLING_FACTOR must be 1, 2, 4 or 8
+#endif
+
+#if DISTRHO_PLUGIN_OVERSAMPLING_FACTOR != 1 && ! DISTRHO_PLUGIN_WANT_OVERSAMPLING
+# error DISTRHO_PLUGIN_OVERSAMPLING_FACTOR requires DISTRHO_PLUGIN_WANT_OVERSAMPLING
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+// Make sure fixed block size is valid
+
+#if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0 && (DISTRHO_PLUGIN_FIXED_BLOCK_SIZE < 16 || DISTRHO_PLUGIN_FIXED_BLOCK_SIZE > 8192)
+# error DISTRHO_PLUGIN_FIXED_BLOCK_SIZE must be 0 or between 16 and 8192
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 // Define DISTRHO_PLUGIN_AU_TYPE if needed
 
@@ -15,16 +15,17 @@
  */
 
 #include "DistrhoPluginInternal.hpp"
+#include "DistrhoPluginVST.hpp"
 #include "../DistrhoPluginUtils.hpp"
 
-#ifndef DISTRHO_PLUGIN_BRAND_ID
-# error DISTRHO_PLUGIN_BRAND_ID undefined!
-#endif
-
-#ifndef DISTRHO_PLUGIN_UNIQUE_ID
-# error DISTRHO_PLUGIN_UNIQUE_ID undefined!
+// AU Info.plist generation needs both brand and unique ids, static metadata does not
+#if defined(DISTRHO_PLUGIN_BRAND_ID) && defined(DISTRHO_PLUGIN_UNIQUE_ID)
+# define DISTRHO_EXPORT_AU_PLIST 1
+#else
+# define DISTRHO_EXPORT_AU_PLIST 0
 #endif
 
+#include <cstring>
 #include <fstream>
 #include <iostream>
 
@@ -32,6 +33,200 @@ USE_NAMESPACE_DISTRHO
 
 // --------------------------------------------------------------------------------------------------------------------
 
+static void writeCString(std::fstream& outputFile, const char* str)
+{
+    char escaped[5];
+
+    outputFile << '"';
+
+    for (; *str != '\0'; ++str)
+    {
+        const uchar c = static_cast<uchar>(*str);
+
+        if (c == '"' || c == '\\')
+        {
+            outputFile << '\\' << *str;
+        }
+        else if (c < 0x20 || c >= 0x7f)
+        {
+            // always 3 octal digits, so the next character is never taken as part of the escape
+            std::snprintf(escaped, sizeof(escaped), "\\%03o", c);
+            outputFile << escaped;
+        }
+        else
+        {
+            outputFile << *str;
+        }
+    }
+
+    outputFile << '"';
+}
+
+void generate_static_metadata(const PluginExporter& plugin, const char* const filename)
+{
+    std::cout << "Writing " << filename << "..."; std::cout.flush();
+    std::fstream outputFile(filename, std::ios::out);
+
+    outputFile << "// auto-generated by the DPF export tool, do not edit\n";
+    outputFile << "\n";
+    outputFile << "#ifndef DISTRHO_PLUGIN_STATIC_METADATA_H_INCLUDED\n";
+    outputFile << "#define DISTRHO_PLUGIN_STATIC_METADATA_H_INCLUDED\n";
+    outputFile << "\n";
+    outputFile << "#define DISTRHO_PLUGIN_STATIC_METADATA { \\\n";
+    outputFile << "    "; writeCString(outputFile, plugin.getName()); outputFile << ", \\\n";
+    outputFile << "    "; writeCString(outputFile, plugin.getLabel()); outputFile << ", \\\n";
+    outputFile << "    "; writeCString(outputFile, plugin.getDescription()); outputFile << ", \\\n";
+    outputFile << "    "; writeCString(outputFile, plugin.getMaker()); outputFile << ", \\\n";
+    outputFile << "    "; writeCString(outputFile, plugin.getHomePage()); outputFile << ", \\\n";
+    outputFile << "    "; writeCString(outputFile, plugin.getLicense()); outputFile << ", \\\n";
+    outputFile << "    " << plugin.getVersion() << "U, \\\n";
+    outputFile << "    " << static_cast<long long>(plugin.getUniqueId()) << "LL \\\n";
+    outputFile << "}\n";
+    outputFile << "\n";
+    outputFile << "#endif // DISTRHO_PLUGIN_STATIC_METADATA_H_INCLUDED\n";
+
+    outputFile.close();
+    std::cout << " done!" << std::endl;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static void writeJsonString(std::fstream& outputFile, const char* str)
+{
+    char escaped[7];
+
+    outputFile << '"';
+
+    for (; *str != '\0'; ++str)
+    {
+        const uchar c = static_cast<uchar>(*str);
+
+        if (c == '"' || c == '\\')
+        {
+            outputFile << '\\' << *str;
+        }
+        else if (c < 0x20)
+        {
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            outputFile << escaped;
+        }
+        else
+        {
+            outputFile << *str;
+        }
+    }
+
+    outputFile << '"';
+}
+
+// matches the class ids set during VST3 plugin init, written as raw bytes like the host reads them
+static void writeVST3ClassId(std::fstream& outputFile, const uint32_t id, const long uniqueId)
+{
+    const uint32_t tuid[4] = { dpf_id_entry, id, static_cast<uint32_t>(uniqueId), dpf_id_brand };
+    uint8_t bytes[sizeof(tuid)];
+    char hex[sizeof(tuid) * 2 + 1];
+
+    std::memcpy(bytes, tuid, sizeof(tuid));
+
+    for (uint i = 0; i < sizeof(tuid); ++i)
+        std::snprintf(hex + i * 2, 3, "%02X", bytes[i]);
+
+    outputFile << '"' << hex << '"';
+}
+
+void generate_vst3_moduleinfo(const PluginExporter& plugin, const char* const moduleName)
+{
+    std::cout << "Writing moduleinfo.json..."; std::cout.flush();
+    std::fstream outputFile("moduleinfo.json", std::ios::out);
+
+    const uint32_t version = plugin.getVersion();
+
+    char versionBuf[64];
+    std::snprintf(versionBuf, sizeof(versionBuf)-1, "%d.%d.%d",
+                  (version >> 16) & 0xff,
+                  (version >>  8) & 0xff,
+                  (version >>  0) & 0xff);
+    versionBuf[sizeof(versionBuf)-1] = '\0';
+
+   #ifdef DISTRHO_PLUGIN_VST3_CATEGORIES
+    const char* const categories = DISTRHO_PLUGIN_VST3_CATEGORIES;
+   #elif DISTRHO_PLUGIN_IS_SYNTH
+    const char* const categories = "Instrument";
+   #else
+    const char* const categories = "Fx";
+   #endif
+
+   #if DPF_VST3_USES_SEPARATE_CONTROLLER || !DISTRHO_PLUGIN_HAS_UI
+    const int classFlags = 1; // V3_DISTRIBUTABLE
+   #else
+    const int classFlags = 0;
+   #endif
+
+   #if DPF_VST3_USES_SEPARATE_CONTROLLER
+    const uint numClasses = 2;
+   #else
+    const uint numClasses = 1;
+   #endif
+
+    outputFile << "{\n";
+    outputFile << "  \"Name\": "; writeJsonString(outputFile, moduleName); outputFile << ",\n";
+    outputFile << "  \"Version\": \"" << versionBuf << "\",\n";
+    outputFile << "  \"Factory Info\": {\n";
+    outputFile << "    \"Vendor\": "; writeJsonString(outputFile, plugin.getMaker()); outputFile << ",\n";
+    outputFile << "    \"URL\": "; writeJsonString(outputFile, plugin.getHomePage()); outputFile << ",\n";
+    outputFile << "    \"E-Mail\": \"\",\n";
+    outputFile << "    \"Flags\": {\n";
+    outputFile << "      \"Unicode\": true,\n";
+    outputFile << "      \"Classes Discardable\": false,\n";
+    outputFile << "      \"Component Non Discardable\": false\n";
+    outputFile << "    }\n";
+    outputFile << "  },\n";
+    outputFile << "  \"Compatibility\": [],\n";
+    outputFile << "  \"Classes\": [\n";
+
+    for (uint i = 0; i < numClasses; ++i)
+    {
+        outputFile << "    {\n";
+        outputFile << "      \"CID\": "; writeVST3ClassId(outputFile, i == 0 ? dpf_id_clas : dpf_id_ctrl, plugin.getUniqueId());
+        outputFile << ",\n";
+        outputFile << "      \"Category\": \"" << (i == 0 ? "Audio Module Class" : "Component Controller Class") << "\",\n";
+        outputFile << "      \"Name\": "; writeJsonString(outputFile, plugin.getName()); outputFile << ",\n";
+        outputFile << "      \"Vendor\": "; writeJsonString(outputFile, plugin.getMaker()); outputFile << ",\n";
+        outputFile << "      \"Version\": \"" << versionBuf << "\",\n";
+        outputFile << "      \"SDKVersion\": \"VST 3.7.4\",\n";
+        outputFile << "      \"Sub Categories\": [";
+
+        for (const char* category = categories;; outputFile << ", ")
+        {
+            const char* const separator = std::strchr(category, '|');
+
+            if (separator == nullptr)
+            {
+                writeJsonString(outputFile, category);
+                break;
+            }
+
+            writeJsonString(outputFile, String(category).truncate(static_cast<size_t>(separator - category)).buffer());
+            category = separator + 1;
+        }
+
+        outputFile << "],\n";
+        outputFile << "      \"Class Flags\": " << classFlags << ",\n";
+        outputFile << "      \"Cardinality\": 2147483647,\n";
+        outputFile << "      \"Snapshots\": []\n";
+        outputFile << (i + 1 == numClasses ? "    }\n" : "    },\n");
+    }
+
+    outputFile << "  ]\n";
+    outputFile << "}\n";
+
+    outputFile.close();
+    std::cout << " done!" << std::endl;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#if DISTRHO_EXPORT_AU_PLIST
 void generate_au_plist(const PluginExporter& plugin,
                        const char* const basename,
                        const char* const license)
@@ -106,6 +301,7 @@ void generate_au_plist(const PluginExporter& plugin,
     outputFile.close();
     std::cout << " done!" << std::endl;
 }
+#endif
 
 // --------------------------------------------------------------------------------------------------------------------
 
@@ -123,6 +319,25 @@ int main(int argc, char* argv[])
     d_nextSampleRate = 0.0;
     d_nextPluginIsDummy = false;
 
+    if (std::strcmp(argv[1], "--static-metadata") == 0)
+    {
+        if (argc <= 2)
+            return 1;
+
+        generate_static_metadata(plugin, argv[2]);
+        return 0;
+    }
+
+    if (std::strcmp(argv[1], "--vst3-moduleinfo") == 0)
+    {
+        if (argc <= 2)
+            return 1;
+
+        generate_vst3_moduleinfo(plugin, argv[2]);
+        return 0;
+    }
+
+   #if DISTRHO_EXPORT_AU_PLIST
     String license(plugin.getLicense());
 
     if (license.isEmpty())
@@ -276,6 +491,10 @@ int main(int argc, char* argv[])
     generate_au_plist(plugin, argv[1], license);
 
     return 0;
+   #else
+    d_stderr("Cannot generate AU Info.plist, DISTRHO_PLUGIN_BRAND_ID and DISTRHO_PLUGIN_UNIQUE_ID are required");
+    return 1;
+   #endif
 }
 
 // --------------------------------------------------------------------------------------------------------------------
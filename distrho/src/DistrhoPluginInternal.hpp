@@ -23,14 +23,103 @@
 # include "DistrhoPluginVST.hpp"
 #endif
 
+#include <algorithm>
 #include <set>
 
+#if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING || DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION || \
+    DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS || DISTRHO_PLUGIN_WANT_DSP_LOAD
+# include <atomic>
+#endif
+
+#if DISTRHO_PLUGIN_WANT_DSP_LOAD
+# include "../extra/Time.hpp"
+#endif
+
+#ifdef DPF_TRACING
+# include "DistrhoPluginTrace.hpp"
+#endif
+
+#ifdef DPF_RT_SAFETY_CHECKS
+# include "../extra/RealtimeSafety.hpp"
+#endif
+
+#if DISTRHO_PLUGIN_WANT_WORKER
+# include "../extra/RingBuffer.hpp"
+#endif
+
+#if DISTRHO_PLUGIN_WANT_WORKER || DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+# include "../extra/Semaphore.hpp"
+#endif
+
+#if DISTRHO_PLUGIN_WANT_WORKER || DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+# include "../extra/Thread.hpp"
+#elif DISTRHO_PLUGIN_WANT_SHARED_PARAMETERS
+# include "../extra/Mutex.hpp"
+#endif
+
+#if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+# include "DistrhoPluginOversampling.hpp"
+#endif
+
+#ifdef DISTRHO_PLUGIN_CLASS
+// declaration of the final plugin class, see DISTRHO_PLUGIN_CLASS
+# include DISTRHO_PLUGIN_CLASS_HEADER
+#endif
+
+#if DISTRHO_PLUGIN_HAS_STATIC_METADATA
+// generated by the export tool, see DistrhoPluginExport.cpp
+# include "DistrhoPluginStaticMetadata.h"
+#endif
+
+#if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION && ! defined(DISTRHO_OS_WINDOWS)
+# include <unistd.h>
+#endif
+
 START_NAMESPACE_DISTRHO
 
 // -----------------------------------------------------------------------
 // Maxmimum values
 
-static const uint32_t kMaxMidiEvents = 512;
+static const uint32_t kMaxMidiEvents = DISTRHO_PLUGIN_MAX_MIDI_EVENTS;
+static const uint32_t kMaxMidiEventsPerRun = DISTRHO_PLUGIN_MAX_MIDI_EVENTS_PER_RUN;
+
+#if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+static const uint32_t kMaxParameterEvents = 512;
+#endif
+
+#if DISTRHO_PLUGIN_WANT_WORKER
+static const uint32_t kMaxWorkSize = 4096;
+#endif
+
+#if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+static const uint32_t kMaxParallelThreads = 16;
+#endif
+
+#if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+static const uint32_t kFixedBlockSize = DISTRHO_PLUGIN_FIXED_BLOCK_SIZE;
+#endif
+
+#ifdef DISTRHO_PLUGIN_TARGET_VST3
+// dummy audio buffer for disabled busses
+static const uint32_t kWrapperScratchBufferCount = 1;
+#else
+static const uint32_t kWrapperScratchBufferCount = 0;
+#endif
+
+// -----------------------------------------------------------------------
+// Whether run() calls might need to be split into smaller blocks
+
+#if DISTRHO_PLUGIN_WANT_MIDI_INPUT && DISTRHO_PLUGIN_MAX_MIDI_EVENTS_PER_RUN < DISTRHO_PLUGIN_MAX_MIDI_EVENTS
+# define DPF_PLUGIN_SPLIT_MIDI_EVENTS 1
+#else
+# define DPF_PLUGIN_SPLIT_MIDI_EVENTS 0
+#endif
+
+#if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS || DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING || DPF_PLUGIN_SPLIT_MIDI_EVENTS
+# define DPF_PLUGIN_RUN_IN_BLOCKS 1
+#else
+# define DPF_PLUGIN_RUN_IN_BLOCKS 0
+#endif
 
 // -----------------------------------------------------------------------
 // Static data, see DistrhoPlugin.cpp
@@ -42,12 +131,55 @@ extern bool        d_nextPluginIsDummy;
 extern bool        d_nextPluginIsSelfTest;
 extern bool        d_nextCanRequestParameterValueChanges;
 
+#if DISTRHO_PLUGIN_HAS_STATIC_METADATA
+// -----------------------------------------------------------------------
+// Plugin metadata resolved at build time, used for host scans without creating a plugin instance
+
+struct PluginStaticMetadata {
+    const char* name;
+    const char* label;
+    const char* description;
+    const char* maker;
+    const char* homePage;
+    const char* license;
+    uint32_t version;
+    int64_t uniqueId;
+
+    constexpr const char* getName() const noexcept { return name; }
+    constexpr const char* getLabel() const noexcept { return label; }
+    constexpr const char* getDescription() const noexcept { return description; }
+    constexpr const char* getMaker() const noexcept { return maker; }
+    constexpr const char* getHomePage() const noexcept { return homePage; }
+    constexpr const char* getLicense() const noexcept { return license; }
+    constexpr uint32_t getVersion() const noexcept { return version; }
+    constexpr long getUniqueId() const noexcept { return static_cast<long>(uniqueId); }
+};
+
+static constexpr const PluginStaticMetadata kPluginStaticMetadata = DISTRHO_PLUGIN_STATIC_METADATA;
+#endif
+
+// -----------------------------------------------------------------------
+// Plugin class as seen by the exporter, calls through a final class are resolved at compile time
+
+#ifdef DISTRHO_PLUGIN_CLASS
+typedef DISTRHO_PLUGIN_CLASS PluginClass;
+# ifdef DISTRHO_PROPER_CPP11_SUPPORT
+static_assert(__is_final(PluginClass), "DISTRHO_PLUGIN_CLASS must be declared as final");
+# endif
+#else
+typedef Plugin PluginClass;
+#endif
+
 // -----------------------------------------------------------------------
 // DSP callbacks
 
 typedef bool (*writeMidiFunc) (void* ptr, const MidiEvent& midiEvent);
 typedef bool (*requestParameterValueChangeFunc) (void* ptr, uint32_t index, float value);
 typedef bool (*updateStateValueFunc) (void* ptr, const char* key, const char* value);
+typedef bool (*workerFunc) (void* ptr, const void* data, uint32_t size);
+#if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+typedef bool (*executeParallelFunc) (void* ptr, uint32_t taskCount, Plugin::ParallelTaskFunc callback, void* callbackPtr);
+#endif
 
 // -----------------------------------------------------------------------
 // Helpers
@@ -137,960 +269,3629 @@ void snprintf_u32(char* const dst, const uint32_t value, const size_t size)
     return snprintf_t<uint32_t>(dst, value, "%u", size);
 }
 
-// -----------------------------------------------------------------------
-// Plugin private data
-
-struct Plugin::PrivateData {
-    const bool canRequestParameterValueChanges;
-    const bool isDummy;
-    const bool isSelfTest;
-    bool isProcessing;
-
-#if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
-    AudioPortWithBusId* audioPorts;
-#endif
-
-    uint32_t   parameterCount;
-    uint32_t   parameterOffset;
-    Parameter* parameters;
+#if DISTRHO_PLUGIN_WANT_SILENCE_DETECTION
+template<typename T>
+static inline
+bool isAudioSilent(const T* const* const buffers, const uint32_t numChannels, const uint32_t frames) noexcept
+{
+    if (buffers == nullptr)
+        return true;
 
-    uint32_t         portGroupCount;
-    PortGroupWithId* portGroups;
+    for (uint32_t c=0; c < numChannels; ++c)
+    {
+        if (buffers[c] == nullptr)
+            continue;
 
-#if DISTRHO_PLUGIN_WANT_PROGRAMS
-    uint32_t programCount;
-    String*  programNames;
-#endif
+        for (uint32_t i=0; i < frames; ++i)
+        {
+            if (d_isNotZero(buffers[c][i]))
+                return false;
+        }
+    }
 
-#if DISTRHO_PLUGIN_WANT_STATE
-    uint32_t stateCount;
-    State*   states;
+    return true;
+}
 #endif
 
-#if DISTRHO_PLUGIN_WANT_LATENCY
-    uint32_t latency;
-#endif
+// -----------------------------------------------------------------------
+// Realtime scratch memory, shared by the plugin and the format wrapper.
+// The wrapper gets a fixed region at the start, the plugin allocates from the rest.
 
-#if DISTRHO_PLUGIN_WANT_TIMEPOS
-    TimePosition timePosition;
-#endif
+class PluginScratchArena
+{
+public:
+    static const std::size_t kAlignment = 64; // cache line
 
-    // Callbacks
-    void*         callbacksPtr;
-    writeMidiFunc writeMidiCallbackFunc;
-    requestParameterValueChangeFunc requestParameterValueChangeCallbackFunc;
-    updateStateValueFunc updateStateValueCallbackFunc;
+    PluginScratchArena() noexcept
+        : fMemory(nullptr),
+          fData(nullptr),
+          fWrapperSize(0),
+          fSize(0),
+          fUsed(0) {}
 
-    uint32_t bufferSize;
-    double   sampleRate;
-    char*    bundlePath;
+    ~PluginScratchArena()
+    {
+        delete[] fMemory;
+    }
 
-    PrivateData() noexcept
-        : canRequestParameterValueChanges(d_nextCanRequestParameterValueChanges),
-          isDummy(d_nextPluginIsDummy),
-          isSelfTest(d_nextPluginIsSelfTest),
-          isProcessing(false),
-#if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
-          audioPorts(nullptr),
-#endif
-          parameterCount(0),
-          parameterOffset(0),
-          parameters(nullptr),
-          portGroupCount(0),
-          portGroups(nullptr),
-#if DISTRHO_PLUGIN_WANT_PROGRAMS
-          programCount(0),
-          programNames(nullptr),
-#endif
-#if DISTRHO_PLUGIN_WANT_STATE
-          stateCount(0),
-          states(nullptr),
-#endif
-#if DISTRHO_PLUGIN_WANT_LATENCY
-          latency(0),
-#endif
-          callbacksPtr(nullptr),
-          writeMidiCallbackFunc(nullptr),
-          requestParameterValueChangeCallbackFunc(nullptr),
-          updateStateValueCallbackFunc(nullptr),
-          bufferSize(d_nextBufferSize),
-          sampleRate(d_nextSampleRate),
-          bundlePath(d_nextBundlePath != nullptr ? strdup(d_nextBundlePath) : nullptr)
+    // not realtime safe, must not be called while processing
+    void resize(const std::size_t wrapperSize, const std::size_t pluginSize)
     {
-        DISTRHO_SAFE_ASSERT(bufferSize != 0);
-        DISTRHO_SAFE_ASSERT(d_isNotZero(sampleRate));
+        const std::size_t alignedWrapperSize = align(wrapperSize);
+        const std::size_t size = alignedWrapperSize + align(pluginSize);
 
-#if defined(DISTRHO_PLUGIN_TARGET_DSSI) || defined(DISTRHO_PLUGIN_TARGET_LV2)
-        parameterOffset += DISTRHO_PLUGIN_NUM_INPUTS + DISTRHO_PLUGIN_NUM_OUTPUTS;
-# if DISTRHO_PLUGIN_WANT_LATENCY
-        parameterOffset += 1;
-# endif
-#endif
+        fUsed = alignedWrapperSize;
 
-#ifdef DISTRHO_PLUGIN_TARGET_LV2
-# if (DISTRHO_PLUGIN_WANT_MIDI_INPUT || DISTRHO_PLUGIN_WANT_STATE || DISTRHO_PLUGIN_WANT_TIMEPOS)
-        parameterOffset += 1;
-# endif
-# if (DISTRHO_PLUGIN_WANT_MIDI_OUTPUT || DISTRHO_PLUGIN_WANT_STATE)
-        parameterOffset += 1;
-# endif
-#endif
+        if (fWrapperSize == alignedWrapperSize && fSize == size)
+            return;
 
-#ifdef DISTRHO_PLUGIN_TARGET_VST3
-        parameterOffset += kVst3InternalParameterCount;
-#endif
-    }
+        delete[] fMemory;
+        fWrapperSize = alignedWrapperSize;
+        fSize = size;
 
-    ~PrivateData() noexcept
-    {
-#if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
-        if (audioPorts != nullptr)
+        if (size == 0)
         {
-            delete[] audioPorts;
-            audioPorts = nullptr;
+            fMemory = fData = nullptr;
+            return;
         }
-#endif
 
-        if (parameters != nullptr)
-        {
-            delete[] parameters;
-            parameters = nullptr;
-        }
+        fMemory = new uint8_t[size + kAlignment];
+        fData = fMemory + (kAlignment - reinterpret_cast<uintptr_t>(fMemory) % kAlignment) % kAlignment;
+        std::memset(fData, 0, size);
+    }
 
-        if (portGroups != nullptr)
-        {
-            delete[] portGroups;
-            portGroups = nullptr;
-        }
+    void* getWrapperBuffer() const noexcept
+    {
+        return fWrapperSize != 0 ? fData : nullptr;
+    }
 
-#if DISTRHO_PLUGIN_WANT_PROGRAMS
-        if (programNames != nullptr)
-        {
-            delete[] programNames;
-            programNames = nullptr;
-        }
-#endif
+    void* allocate(const std::size_t size) noexcept
+    {
+        const std::size_t alignedSize = align(size);
 
-#if DISTRHO_PLUGIN_WANT_STATE
-        if (states != nullptr)
-        {
-            delete[] states;
-            states = nullptr;
-        }
-#endif
+        if (alignedSize == 0 || alignedSize > fSize - fUsed)
+            return nullptr;
 
-        if (bundlePath != nullptr)
-        {
-            std::free(bundlePath);
-            bundlePath = nullptr;
-        }
+        void* const ptr = fData + fUsed;
+        fUsed += alignedSize;
+        return ptr;
     }
 
-#if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
-    bool writeMidiCallback(const MidiEvent& midiEvent)
+    // make all plugin memory available again, called before each run
+    void reset() noexcept
     {
-        if (writeMidiCallbackFunc != nullptr)
-            return writeMidiCallbackFunc(callbacksPtr, midiEvent);
-
-        return false;
+        fUsed = fWrapperSize;
     }
-#endif
 
-#if DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST
-    bool requestParameterValueChangeCallback(const uint32_t index, const float value)
+private:
+    uint8_t* fMemory;
+    uint8_t* fData;
+    std::size_t fWrapperSize;
+    std::size_t fSize;
+    std::size_t fUsed;
+
+    static std::size_t align(const std::size_t size) noexcept
     {
-        if (requestParameterValueChangeCallbackFunc != nullptr)
-            return requestParameterValueChangeCallbackFunc(callbacksPtr, index, value);
+        return (size + kAlignment - 1) & ~(kAlignment - 1);
+    }
 
-        return false;
+    DISTRHO_DECLARE_NON_COPYABLE(PluginScratchArena)
+};
+
+// -----------------------------------------------------------------------
+// Parameter data used while processing, kept in compact arrays away from the names and other strings
+
+struct PluginParameterTable {
+    uint32_t* hints;
+    float* minimums;
+    float* maximums;
+    float* defaults;
+    double* normScales; // 1 / (max - min), 0 for empty ranges
+
+    PluginParameterTable() noexcept
+        : hints(nullptr),
+          minimums(nullptr),
+          maximums(nullptr),
+          defaults(nullptr),
+          normScales(nullptr) {}
+
+    ~PluginParameterTable()
+    {
+        delete[] hints;
+        delete[] minimums;
+        delete[] maximums;
+        delete[] defaults;
+        delete[] normScales;
     }
-#endif
 
-#if DISTRHO_PLUGIN_WANT_STATE
-    bool updateStateValueCallback(const char* const key, const char* const value)
+    void init(const Parameter* const parameters, const uint32_t count)
     {
-        DISTRHO_SAFE_ASSERT_RETURN(key != nullptr && key[0] != '\0', false);
-        DISTRHO_SAFE_ASSERT_RETURN(value != nullptr, false);
+        DISTRHO_SAFE_ASSERT_RETURN(hints == nullptr,);
 
-        d_stdout("updateStateValueCallback %p", updateStateValueCallbackFunc);
-        if (updateStateValueCallbackFunc != nullptr)
-            return updateStateValueCallbackFunc(callbacksPtr, key, value);
+        if (count == 0)
+            return;
 
-        return false;
+        hints = new uint32_t[count];
+        minimums = new float[count];
+        maximums = new float[count];
+        defaults = new float[count];
+        normScales = new double[count];
+
+        for (uint32_t i=0; i < count; ++i)
+        {
+            const ParameterRanges& ranges(parameters[i].ranges);
+
+            hints[i] = parameters[i].hints;
+            minimums[i] = ranges.min;
+            maximums[i] = ranges.max;
+            defaults[i] = ranges.def;
+            normScales[i] = ranges.max > ranges.min ? 1.0 / (static_cast<double>(ranges.max) - ranges.min) : 0.0;
+        }
     }
-#endif
+
+    DISTRHO_DECLARE_NON_COPYABLE(PluginParameterTable)
 };
 
 // -----------------------------------------------------------------------
-// Plugin exporter class
+// Name to index lookup, sorted once after init so that restoring state does not need linear searches
 
-class PluginExporter
+class PluginSymbolIndex
 {
 public:
-    PluginExporter(void* const callbacksPtr,
-                   const writeMidiFunc writeMidiCall,
-                   const requestParameterValueChangeFunc requestParameterValueChangeCall,
-                   const updateStateValueFunc updateStateValueCall)
-        : fPlugin(createPlugin()),
-          fData((fPlugin != nullptr) ? fPlugin->pData : nullptr),
-          fIsActive(false)
+    PluginSymbolIndex() noexcept
+        : fEntries(nullptr),
+          fCount(0) {}
+
+    ~PluginSymbolIndex()
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
+        delete[] fEntries;
+    }
 
-#if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+    // names are referenced, not copied, they must not change after this call
+    template<typename T>
+    void build(const T* const items, const uint32_t count, String T::*const name)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fEntries == nullptr,);
+
+        if (count == 0)
+            return;
+
+        fEntries = new Entry[count];
+        fCount = count;
+
+        for (uint32_t i=0; i < count; ++i)
         {
-            uint32_t j=0;
-# if DISTRHO_PLUGIN_NUM_INPUTS > 0
-            for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_INPUTS; ++i, ++j)
-                fPlugin->initAudioPort(true, i, fData->audioPorts[j]);
-# endif
-# if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
-            for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_OUTPUTS; ++i, ++j)
-                fPlugin->initAudioPort(false, i, fData->audioPorts[j]);
-# endif
+            fEntries[i].name = (items[i].*name).buffer();
+            fEntries[i].index = i;
         }
-#endif // DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
 
-        for (uint32_t i=0, count=fData->parameterCount; i < count; ++i)
-            fPlugin->initParameter(i, fData->parameters[i]);
+        // stable, so duplicated names resolve to the lowest index like a linear search would
+        std::stable_sort(fEntries, fEntries + count, compareEntries);
+    }
+
+    bool find(const char* const name, uint32_t& index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(name != nullptr, false);
+
+        const Entry* const begin = fEntries;
+        const Entry* const end = fEntries + fCount;
+        const Entry* const entry = std::lower_bound(begin, end, name, compareEntryName);
+
+        if (entry == end || std::strcmp(entry->name, name) != 0)
+            return false;
+
+        index = entry->index;
+        return true;
+    }
+
+private:
+    struct Entry {
+        const char* name;
+        uint32_t index;
+    };
+
+    Entry* fEntries;
+    uint32_t fCount;
+
+    static bool compareEntries(const Entry& a, const Entry& b) noexcept
+    {
+        return std::strcmp(a.name, b.name) < 0;
+    }
+
+    static bool compareEntryName(const Entry& entry, const char* const name) noexcept
+    {
+        return std::strcmp(entry.name, name) < 0;
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(PluginSymbolIndex)
+};
+
+#if DISTRHO_PLUGIN_WANT_SHARED_PARAMETERS
+// -----------------------------------------------------------------------
+// Parameter information shared by all plugin instances in the process, together with its processing table and symbol index.
+// The first instance fills it in, the last one to release it deletes it.
+
+class PluginSharedParameters
+{
+public:
+    // must be kept locked while acquiring and filling in the parameters
+    static Mutex& getMutex() noexcept
+    {
+        return getInstance().fMutex;
+    }
+
+    // table and symbolIndex are set to the shared ones, or to null if this instance cannot share
+    static Parameter* acquire(const uint32_t count, bool& needsInit,
+                              PluginParameterTable*& table, PluginSymbolIndex*& symbolIndex)
+    {
+        PluginSharedParameters& shared(getInstance());
 
+        if (shared.fRefCount == 0)
         {
-            std::set<uint32_t> portGroupIndices;
+            shared.fParameters = new Parameter[count];
+            shared.fTable = new PluginParameterTable;
+            shared.fSymbolIndex = new PluginSymbolIndex;
+            shared.fCount = count;
+        }
+        else if (shared.fCount != count)
+        {
+            // cannot share with a different parameter count, give this instance its own list
+            d_stderr2("DPF warning: Plugin instances have different parameter counts, %u vs %u", shared.fCount, count);
+            needsInit = true;
+            table = nullptr;
+            symbolIndex = nullptr;
+            return new Parameter[count];
+        }
 
-#if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
-            for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS; ++i)
-                portGroupIndices.insert(fData->audioPorts[i].groupId);
+        needsInit = shared.fRefCount++ == 0;
+        table = shared.fTable;
+        symbolIndex = shared.fSymbolIndex;
+        return shared.fParameters;
+    }
+
+    static void release(Parameter* const parameters) noexcept
+    {
+        PluginSharedParameters& shared(getInstance());
+        const MutexLocker cml(shared.fMutex);
+
+        if (parameters != shared.fParameters)
+        {
+            delete[] parameters;
+            return;
+        }
+
+        DISTRHO_SAFE_ASSERT_RETURN(shared.fRefCount != 0,);
+
+        if (--shared.fRefCount != 0)
+            return;
+
+        delete[] shared.fParameters;
+        delete shared.fTable;
+        delete shared.fSymbolIndex;
+        shared.fParameters = nullptr;
+        shared.fTable = nullptr;
+        shared.fSymbolIndex = nullptr;
+        shared.fCount = 0;
+    }
+
+private:
+    Mutex fMutex;
+    Parameter* fParameters;
+    PluginParameterTable* fTable;
+    PluginSymbolIndex* fSymbolIndex;
+    uint32_t fCount;
+    uint32_t fRefCount;
+
+    PluginSharedParameters() noexcept
+        : fMutex(),
+          fParameters(nullptr),
+          fTable(nullptr),
+          fSymbolIndex(nullptr),
+          fCount(0),
+          fRefCount(0) {}
+
+    // created on first use, so it is always valid even for instances created during static initialization
+    static PluginSharedParameters& getInstance() noexcept
+    {
+        static PluginSharedParameters shared;
+        return shared;
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(PluginSharedParameters)
+};
 #endif
-            for (uint32_t i=0, count=fData->parameterCount; i < count; ++i)
-                portGroupIndices.insert(fData->parameters[i].groupId);
 
-            portGroupIndices.erase(kPortGroupNone);
+#if DISTRHO_PLUGIN_WANT_DSP_LOAD
+// -----------------------------------------------------------------------
+// Rolling DSP load statistics, written by the audio thread and read lock-free from any other
 
-            if (const uint32_t portGroupSize = static_cast<uint32_t>(portGroupIndices.size()))
-            {
-                fData->portGroups = new PortGroupWithId[portGroupSize];
-                fData->portGroupCount = portGroupSize;
+class PluginDspLoadMeter
+{
+public:
+    // number of most recent blocks used for the statistics
+    static constexpr const uint32_t kWindowSize = 1024;
 
-                uint32_t index = 0;
-                for (std::set<uint32_t>::iterator it = portGroupIndices.begin(); it != portGroupIndices.end(); ++it, ++index)
-                {
-                    PortGroupWithId& portGroup(fData->portGroups[index]);
-                    portGroup.groupId = *it;
+    // loads are kept as integers, in units of 0.01% of the block budget, clamped to 10000%
+    static constexpr const uint32_t kLoadScale = 10000;
+    static constexpr const uint32_t kMaxLoad = 100 * kLoadScale;
 
-                    if (portGroup.groupId < portGroupSize)
-                        fPlugin->initPortGroup(portGroup.groupId, portGroup);
-                    else
-                        fillInPredefinedPortGroupData(portGroup.groupId, portGroup);
-                }
+    // histogram buckets of 0.25% each, with the last one also holding everything above 256%
+    static constexpr const uint32_t kBucketWidth = 25;
+    static constexpr const uint32_t kBucketCount = 1024;
+
+    PluginDspLoadMeter() noexcept
+    {
+        reset();
+    }
+
+    // must not be called concurrently with addBlock()
+    void reset() noexcept
+    {
+        fCount.store(0, std::memory_order_release);
+        fWindowPos = 0;
+
+        for (uint32_t i=0; i < kWindowSize; ++i)
+            fWindow[i].store(0, std::memory_order_relaxed);
+
+        for (uint32_t i=0; i < kBucketCount; ++i)
+            fBuckets[i].store(0, std::memory_order_relaxed);
+    }
+
+    // called by the audio thread after each block, there is only ever a single writer
+    void addBlock(const uint64_t elapsedNanoseconds, const uint32_t frames, const double sampleRate) noexcept
+    {
+        if (frames == 0 || sampleRate <= 0.0)
+            return;
+
+        const double budgetNanoseconds = static_cast<double>(frames) * 1000000000.0 / sampleRate;
+        const double load = static_cast<double>(elapsedNanoseconds) * kLoadScale / budgetNanoseconds;
+        const uint32_t value = load < kMaxLoad ? static_cast<uint32_t>(load + 0.5) : kMaxLoad;
+
+        const uint32_t pos = fWindowPos;
+        const uint32_t count = fCount.load(std::memory_order_relaxed);
+
+        // single writer, so plain load + store is enough and avoids locked instructions
+        if (count == kWindowSize)
+            decrement(fBuckets[getBucket(fWindow[pos].load(std::memory_order_relaxed))]);
+
+        fWindow[pos].store(value, std::memory_order_relaxed);
+        increment(fBuckets[getBucket(value)]);
+
+        fWindowPos = (pos + 1) % kWindowSize;
+
+        if (count != kWindowSize)
+            fCount.store(count + 1, std::memory_order_release);
+    }
+
+    // can be called from any thread, values might be off by a block or two while the audio thread is running
+    void get(DspLoad& dspLoad) const noexcept
+    {
+        const uint32_t count = fCount.load(std::memory_order_acquire);
+
+        if (count == 0)
+        {
+            dspLoad = DspLoad();
+            return;
+        }
+
+        uint32_t minimum = kMaxLoad;
+        uint32_t maximum = 0;
+        uint64_t sum = 0;
+
+        for (uint32_t i=0; i < count; ++i)
+        {
+            const uint32_t value = fWindow[i].load(std::memory_order_relaxed);
+
+            minimum = std::min(minimum, value);
+            maximum = std::max(maximum, value);
+            sum += value;
+        }
+
+        // walk the histogram until 99% of the blocks are covered, using the upper edge of that bucket
+        const uint32_t target = count - count / 100;
+        uint32_t p99 = maximum;
+
+        for (uint32_t i=0, seen=0; i < kBucketCount - 1; ++i)
+        {
+            seen += fBuckets[i].load(std::memory_order_relaxed);
+
+            if (seen >= target)
+            {
+                p99 = std::min(maximum, (i + 1) * kBucketWidth);
+                break;
             }
         }
 
+        dspLoad.minimum = static_cast<float>(minimum) / kLoadScale;
+        dspLoad.average = static_cast<float>(static_cast<double>(sum) / count / kLoadScale);
+        dspLoad.p99 = static_cast<float>(std::max(minimum, p99)) / kLoadScale;
+        dspLoad.maximum = static_cast<float>(maximum) / kLoadScale;
+        dspLoad.blockCount = count;
+    }
+
+private:
+    std::atomic<uint32_t> fWindow[kWindowSize];
+    std::atomic<uint32_t> fBuckets[kBucketCount];
+    std::atomic<uint32_t> fCount;
+    uint32_t fWindowPos; // audio thread only
+
+    static uint32_t getBucket(const uint32_t value) noexcept
+    {
+        return std::min(value / kBucketWidth, kBucketCount - 1);
+    }
+
+    static void increment(std::atomic<uint32_t>& bucket) noexcept
+    {
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    static void decrement(std::atomic<uint32_t>& bucket) noexcept
+    {
+        bucket.store(bucket.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(PluginDspLoadMeter)
+};
+#endif
+
+// -----------------------------------------------------------------------
+// Plugin private data
+
+struct Plugin::PrivateData {
+    const bool canRequestParameterValueChanges;
+    const bool isDummy;
+    const bool isSelfTest;
+    bool isProcessing;
+
+#if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+    AudioPortWithBusId* audioPorts;
+#endif
+
+    uint32_t   parameterCount;
+    uint32_t   parameterOffset;
+    Parameter* parameters;
+
+    uint32_t         portGroupCount;
+    PortGroupWithId* portGroups;
+
+#if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+    float* outputParameterValues;
+    std::atomic<uint32_t>* changedParameters; // 1 bit per parameter
+#endif
+
+#if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+    float** parameterRamps; // null for parameters without smoothing
+#endif
+
+#if DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS
+    // latest values set from any thread, handed to the plugin at the start of the next run
+    std::atomic<float>* pendingParameterValues;
+    std::atomic<uint32_t>* pendingParameters; // 1 bit per parameter
+#endif
+
+#if DISTRHO_PLUGIN_WANT_PROGRAMS
+    uint32_t programCount;
+    String*  programNames;
+#endif
+
+#if DISTRHO_PLUGIN_WANT_STATE
+    uint32_t stateCount;
+    State*   states;
+#endif
+
+#if DISTRHO_PLUGIN_WANT_LATENCY
+    uint32_t latency;
+#endif
+
+#if DISTRHO_PLUGIN_WANT_TIMEPOS
+    TimePosition timePosition;
+#endif
+
+#if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT && DPF_PLUGIN_RUN_IN_BLOCKS
+    // offset added to MIDI output events while running split blocks
+    uint32_t midiOutputFrameOffset;
+#endif
+
+#if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT && DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+    // MIDI output of the last fixed-size block
+    uint32_t  blockMidiOutputCount;
+    MidiEvent blockMidiOutputEvents[kMaxMidiEvents];
+#endif
+
+    // Callbacks
+    void*         callbacksPtr;
+    writeMidiFunc writeMidiCallbackFunc;
+    requestParameterValueChangeFunc requestParameterValueChangeCallbackFunc;
+    updateStateValueFunc updateStateValueCallbackFunc;
+
+#if DISTRHO_PLUGIN_WANT_WORKER
+    // Worker callbacks, either from the host or DPF's own worker thread
+    void*      workerPtr;
+    workerFunc scheduleWorkCallbackFunc;
+    workerFunc sendWorkResponseCallbackFunc;
+#endif
+
+#if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+    // Thread pool callback, either from the host or DPF's own thread pool
+    void*               threadPoolPtr;
+    executeParallelFunc executeParallelCallbackFunc;
+#endif
+
+#if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+    // buffer size and sample rate below are already multiplied by the current factor
+    uint32_t oversamplingFactor;
+    uint32_t nextOversamplingFactor;
+#endif
+
+    PluginScratchArena scratchArena;
+
+#if DISTRHO_PLUGIN_WANT_DSP_LOAD
+    PluginDspLoadMeter dspLoadMeter;
+#endif
+
+    uint32_t bufferSize;
+    double   sampleRate;
+    bool     isOffline;
+    char*    bundlePath;
+
+    PrivateData() noexcept
+        : canRequestParameterValueChanges(d_nextCanRequestParameterValueChanges),
+          isDummy(d_nextPluginIsDummy),
+          isSelfTest(d_nextPluginIsSelfTest),
+          isProcessing(false),
+#if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+          audioPorts(nullptr),
+#endif
+          parameterCount(0),
+          parameterOffset(0),
+          parameters(nullptr),
+          portGroupCount(0),
+          portGroups(nullptr),
+#if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+          outputParameterValues(nullptr),
+          changedParameters(nullptr),
+#endif
+#if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+          parameterRamps(nullptr),
+#endif
+#if DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS
+          pendingParameterValues(nullptr),
+          pendingParameters(nullptr),
+#endif
+#if DISTRHO_PLUGIN_WANT_PROGRAMS
+          programCount(0),
+          programNames(nullptr),
+#endif
+#if DISTRHO_PLUGIN_WANT_STATE
+          stateCount(0),
+          states(nullptr),
+#endif
+#if DISTRHO_PLUGIN_WANT_LATENCY
+          latency(0),
+#endif
+#if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT && DPF_PLUGIN_RUN_IN_BLOCKS
+          midiOutputFrameOffset(0),
+#endif
+#if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT && DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+          blockMidiOutputCount(0),
+#endif
+          callbacksPtr(nullptr),
+          writeMidiCallbackFunc(nullptr),
+          requestParameterValueChangeCallbackFunc(nullptr),
+          updateStateValueCallbackFunc(nullptr),
+#if DISTRHO_PLUGIN_WANT_WORKER
+          workerPtr(nullptr),
+          scheduleWorkCallbackFunc(nullptr),
+          sendWorkResponseCallbackFunc(nullptr),
+#endif
+#if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+          threadPoolPtr(nullptr),
+          executeParallelCallbackFunc(nullptr),
+#endif
+#if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+          oversamplingFactor(DISTRHO_PLUGIN_OVERSAMPLING_FACTOR),
+          nextOversamplingFactor(DISTRHO_PLUGIN_OVERSAMPLING_FACTOR),
+#endif
+#if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+          bufferSize(DISTRHO_PLUGIN_FIXED_BLOCK_SIZE * DISTRHO_PLUGIN_OVERSAMPLING_FACTOR),
+#else
+          bufferSize(d_nextBufferSize * DISTRHO_PLUGIN_OVERSAMPLING_FACTOR),
+#endif
+          sampleRate(d_nextSampleRate * DISTRHO_PLUGIN_OVERSAMPLING_FACTOR),
+          isOffline(false),
+          bundlePath(d_nextBundlePath != nullptr ? strdup(d_nextBundlePath) : nullptr)
+    {
+        DISTRHO_SAFE_ASSERT(bufferSize != 0);
+        DISTRHO_SAFE_ASSERT(d_isNotZero(sampleRate));
+
+#if defined(DISTRHO_PLUGIN_TARGET_DSSI) || defined(DISTRHO_PLUGIN_TARGET_LV2)
+        parameterOffset += DISTRHO_PLUGIN_NUM_INPUTS + DISTRHO_PLUGIN_NUM_OUTPUTS;
+# if DISTRHO_PLUGIN_WANT_LATENCY
+        parameterOffset += 1;
+# endif
+#endif
+
+#ifdef DISTRHO_PLUGIN_TARGET_LV2
+# if (DISTRHO_PLUGIN_WANT_MIDI_INPUT || DISTRHO_PLUGIN_WANT_STATE || DISTRHO_PLUGIN_WANT_TIMEPOS)
+        parameterOffset += 1;
+# endif
+# if (DISTRHO_PLUGIN_WANT_MIDI_OUTPUT || DISTRHO_PLUGIN_WANT_STATE)
+        parameterOffset += 1;
+# endif
+#endif
+
+#ifdef DISTRHO_PLUGIN_TARGET_VST3
+        parameterOffset += kVst3InternalParameterCount;
+#endif
+    }
+
+    ~PrivateData() noexcept
+    {
+#if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+        if (audioPorts != nullptr)
+        {
+            delete[] audioPorts;
+            audioPorts = nullptr;
+        }
+#endif
+
+        if (parameters != nullptr)
+        {
+           #if DISTRHO_PLUGIN_WANT_SHARED_PARAMETERS
+            PluginSharedParameters::release(parameters);
+           #else
+            delete[] parameters;
+           #endif
+            parameters = nullptr;
+        }
+
+        if (portGroups != nullptr)
+        {
+            delete[] portGroups;
+            portGroups = nullptr;
+        }
+
+#if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+        if (outputParameterValues != nullptr)
+        {
+            delete[] outputParameterValues;
+            outputParameterValues = nullptr;
+        }
+
+        if (changedParameters != nullptr)
+        {
+            delete[] changedParameters;
+            changedParameters = nullptr;
+        }
+#endif
+
+#if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+        if (parameterRamps != nullptr)
+        {
+            for (uint32_t i=0; i < parameterCount; ++i)
+                delete[] parameterRamps[i];
+
+            delete[] parameterRamps;
+            parameterRamps = nullptr;
+        }
+#endif
+
+#if DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS
+        if (pendingParameterValues != nullptr)
+        {
+            delete[] pendingParameterValues;
+            pendingParameterValues = nullptr;
+        }
+
+        if (pendingParameters != nullptr)
+        {
+            delete[] pendingParameters;
+            pendingParameters = nullptr;
+        }
+#endif
+
+#if DISTRHO_PLUGIN_WANT_PROGRAMS
+        if (programNames != nullptr)
+        {
+            delete[] programNames;
+            programNames = nullptr;
+        }
+#endif
+
+#if DISTRHO_PLUGIN_WANT_STATE
+        if (states != nullptr)
+        {
+            delete[] states;
+            states = nullptr;
+        }
+#endif
+
+        if (bundlePath != nullptr)
+        {
+            std::free(bundlePath);
+            bundlePath = nullptr;
+        }
+    }
+
+#if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
+    bool writeMidiCallback(const MidiEvent& midiEvent)
+    {
+        if (writeMidiCallbackFunc == nullptr)
+            return false;
+
+       #if DPF_PLUGIN_RUN_IN_BLOCKS
+        if (midiOutputFrameOffset != 0)
+        {
+            MidiEvent offsetMidiEvent;
+            std::memcpy(&offsetMidiEvent, &midiEvent, sizeof(MidiEvent));
+            offsetMidiEvent.frame += midiOutputFrameOffset;
+           #if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+            offsetMidiEvent.frame /= oversamplingFactor;
+           #endif
+            return sendMidiEvent(offsetMidiEvent);
+        }
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+        if (oversamplingFactor != 1)
+        {
+            MidiEvent hostMidiEvent;
+            std::memcpy(&hostMidiEvent, &midiEvent, sizeof(MidiEvent));
+            hostMidiEvent.frame /= oversamplingFactor;
+            return sendMidiEvent(hostMidiEvent);
+        }
+       #endif
+
+        return sendMidiEvent(midiEvent);
+    }
+
+    bool sendMidiEvent(const MidiEvent& midiEvent)
+    {
+       #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+        // held back until the audio of this block is played, see PluginExporter::runInFixedBlocks
+        if (blockMidiOutputCount == kMaxMidiEvents || midiEvent.size > MidiEvent::kDataSize)
+            return false;
+
+        std::memcpy(&blockMidiOutputEvents[blockMidiOutputCount++], &midiEvent, sizeof(MidiEvent));
+        return true;
+       #else
+        return writeMidiCallbackFunc(callbacksPtr, midiEvent);
+       #endif
+    }
+#endif
+
+#if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+    void markParameterChanged(const uint32_t index) noexcept
+    {
+        changedParameters[index / 32].fetch_or(1u << (index % 32), std::memory_order_release);
+    }
+#endif
+
+#if DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS
+    void setPendingParameterValue(const uint32_t index, const float value) noexcept
+    {
+        pendingParameterValues[index].store(value, std::memory_order_relaxed);
+        pendingParameters[index / 32].fetch_or(1u << (index % 32), std::memory_order_release);
+    }
+
+    bool isParameterPending(const uint32_t index) const noexcept
+    {
+        return pendingParameters[index / 32].load(std::memory_order_acquire) & (1u << (index % 32));
+    }
+#endif
+
+#if DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST
+    bool requestParameterValueChangeCallback(const uint32_t index, const float value)
+    {
+        if (requestParameterValueChangeCallbackFunc != nullptr)
+            return requestParameterValueChangeCallbackFunc(callbacksPtr, index, value);
+
+        return false;
+    }
+#endif
+
+#if DISTRHO_PLUGIN_WANT_STATE
+    bool updateStateValueCallback(const char* const key, const char* const value)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(key != nullptr && key[0] != '\0', false);
+        DISTRHO_SAFE_ASSERT_RETURN(value != nullptr, false);
+
+        d_stdout("updateStateValueCallback %p", updateStateValueCallbackFunc);
+        if (updateStateValueCallbackFunc != nullptr)
+            return updateStateValueCallbackFunc(callbacksPtr, key, value);
+
+        return false;
+    }
+#endif
+
+#if DISTRHO_PLUGIN_WANT_WORKER
+    bool scheduleWorkCallback(const void* const data, const uint32_t size)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(data != nullptr, false);
+        DISTRHO_SAFE_ASSERT_UINT_RETURN(size != 0 && size <= kMaxWorkSize, size, false);
+
+        if (scheduleWorkCallbackFunc != nullptr)
+            return scheduleWorkCallbackFunc(workerPtr, data, size);
+
+        return false;
+    }
+
+    bool sendWorkResponseCallback(const void* const data, const uint32_t size)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(data != nullptr, false);
+        DISTRHO_SAFE_ASSERT_UINT_RETURN(size != 0 && size <= kMaxWorkSize, size, false);
+
+        if (sendWorkResponseCallbackFunc != nullptr)
+            return sendWorkResponseCallbackFunc(workerPtr, data, size);
+
+        return false;
+    }
+#endif
+
+#if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+    void executeParallelCallback(const uint32_t taskCount, const Plugin::ParallelTaskFunc callback, void* const ptr)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(callback != nullptr,);
+
+        if (taskCount > 1 && isProcessing && executeParallelCallbackFunc != nullptr)
+        {
+            if (executeParallelCallbackFunc(threadPoolPtr, taskCount, callback, ptr))
+                return;
+        }
+
+        // no thread pool, or the host rejected the request
+        for (uint32_t i=0; i<taskCount; ++i)
+            callback(ptr, i);
+    }
+#endif
+};
+
+#if DISTRHO_PLUGIN_WANT_WORKER
+// -----------------------------------------------------------------------
+// Worker thread used when the host does not provide one
+
+class PluginWorker : public Thread
+{
+public:
+    PluginWorker(Plugin* const plugin) noexcept
+        : Thread("DPF Worker"),
+          fPlugin(plugin)
+    {
+        fRequests.setRingBuffer(&fRequestsBuffer, true);
+        fResponses.setRingBuffer(&fResponsesBuffer, true);
+    }
+
+    ~PluginWorker() override
+    {
+        stop();
+    }
+
+    void stop()
+    {
+        signalThreadShouldExit();
+        fWorkSemaphore.post();
+        stopThread(-1);
+    }
+
+    // called from the audio thread
+    bool scheduleWork(const void* const data, const uint32_t size) noexcept
+    {
+        fRequests.writeUInt(size);
+        fRequests.writeCustomData(data, size);
+
+        if (! fRequests.commitWrite())
+            return false;
+
+        fWorkSemaphore.post();
+        return true;
+    }
+
+    // called from the worker thread, during Plugin::work
+    bool sendWorkResponse(const void* const data, const uint32_t size) noexcept
+    {
+        fResponses.writeUInt(size);
+        fResponses.writeCustomData(data, size);
+        return fResponses.commitWrite();
+    }
+
+    // called from the audio thread, right before run
+    void dispatchResponses()
+    {
+        while (fResponses.isDataAvailableForReading())
+        {
+            const uint32_t size = fResponses.readUInt();
+
+            if (size == 0 || size > kMaxWorkSize || ! fResponses.readCustomData(fResponseData, size))
+                break;
+
+            fPlugin->workResponse(fResponseData, size);
+        }
+    }
+
+    static bool scheduleWorkCallback(void* const ptr, const void* const data, const uint32_t size)
+    {
+        return static_cast<PluginWorker*>(ptr)->scheduleWork(data, size);
+    }
+
+    static bool sendWorkResponseCallback(void* const ptr, const void* const data, const uint32_t size)
+    {
+        return static_cast<PluginWorker*>(ptr)->sendWorkResponse(data, size);
+    }
+
+protected:
+    void run() override
+    {
+        while (! shouldThreadExit())
+        {
+            fWorkSemaphore.wait();
+
+            while (fRequests.isDataAvailableForReading() && ! shouldThreadExit())
+            {
+                const uint32_t size = fRequests.readUInt();
+
+                if (size == 0 || size > kMaxWorkSize || ! fRequests.readCustomData(fRequestData, size))
+                    break;
+
+                fPlugin->work(fRequestData, size);
+            }
+        }
+    }
+
+private:
+    Plugin* const fPlugin;
+    Semaphore fWorkSemaphore;
+
+    BigStackBuffer fRequestsBuffer;
+    BigStackBuffer fResponsesBuffer;
+    RingBufferControl<BigStackBuffer> fRequests;
+    RingBufferControl<BigStackBuffer> fResponses;
+
+    uint8_t fRequestData[kMaxWorkSize];
+    uint8_t fResponseData[kMaxWorkSize];
+
+    DISTRHO_DECLARE_NON_COPYABLE(PluginWorker)
+};
+#endif
+
+#if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+// -----------------------------------------------------------------------
+// Thread pool used when the host does not provide one, shared by all plugin instances
+
+class PluginThreadPool
+{
+    static constexpr const uint32_t kNoMoreTasks = 0xffffffff;
+
+public:
+    // called from the host side, never from the audio thread
+    static PluginThreadPool* acquire()
+    {
+        SharedPool& shared(getSharedPool());
+        const MutexLocker cml(shared.mutex);
+
+        if (shared.refCount++ == 0)
+            shared.pool = new PluginThreadPool();
+
+        return shared.pool;
+    }
+
+    static void release()
+    {
+        SharedPool& shared(getSharedPool());
+        const MutexLocker cml(shared.mutex);
+
+        DISTRHO_SAFE_ASSERT_RETURN(shared.refCount != 0,);
+
+        if (--shared.refCount == 0)
+        {
+            delete shared.pool;
+            shared.pool = nullptr;
+        }
+    }
+
+    // called from the audio thread, during Plugin::run
+    bool execute(const uint32_t taskCount, const Plugin::ParallelTaskFunc callback, void* const ptr) noexcept
+    {
+        if (fWorkerCount == 0)
+            return false;
+
+        // another instance is using the pool, let the caller run its tasks serially instead of waiting
+        bool expected = false;
+        if (! fBusy.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            return false;
+
+        const uint32_t wakeCount = std::min(taskCount - 1, fWorkerCount);
+        const uint64_t epoch = (fTaskState.load(std::memory_order_relaxed) >> 32) + 1;
+
+        // close the new epoch before changing the task data, so late workers can no longer claim any task
+        fTaskState.store(epoch << 32 | kNoMoreTasks, std::memory_order_seq_cst);
+        fCallback.store(callback, std::memory_order_release);
+        fCallbackPtr.store(ptr, std::memory_order_release);
+        fTaskCount.store(taskCount, std::memory_order_release);
+        fPendingTasks.store(taskCount, std::memory_order_relaxed);
+        fTaskState.store(epoch << 32, std::memory_order_release);
+
+        for (uint32_t i=0; i<wakeCount; ++i)
+            fWorkers[i]->wake();
+
+        runTasks();
+
+        // only wait for the tasks to be done,
+        // workers that wake up late find no task left for this epoch and go back to sleep
+        while (fPendingTasks.load(std::memory_order_acquire) != 0)
+            cpuPause();
+
+        fBusy.store(false, std::memory_order_release);
+        return true;
+    }
+
+    static bool executeParallelCallback(void* const ptr, const uint32_t taskCount,
+                                        const Plugin::ParallelTaskFunc callback, void* const callbackPtr)
+    {
+        return static_cast<PluginThreadPool*>(ptr)->execute(taskCount, callback, callbackPtr);
+    }
+
+private:
+    PluginThreadPool() noexcept
+        : fWorkerCount(0),
+          fCallback(nullptr),
+          fCallbackPtr(nullptr),
+          fTaskCount(0),
+          fBusy(false),
+          fTaskState(0),
+          fPendingTasks(0)
+    {
+        // the calling thread also processes tasks, so leave 1 CPU for it
+        const uint32_t cpuCount = getCpuCount();
+        const uint32_t workerCount = std::min(cpuCount > 1 ? cpuCount - 1 : 0U, kMaxParallelThreads - 1);
+
+        for (uint32_t i=0; i<workerCount; ++i)
+        {
+            Worker* const worker = new Worker(this);
+
+            if (! worker->startThread(true))
+            {
+                delete worker;
+                break;
+            }
+
+            fWorkers[fWorkerCount++] = worker;
+        }
+    }
+
+    ~PluginThreadPool()
+    {
+        for (uint32_t i=0; i<fWorkerCount; ++i)
+        {
+            fWorkers[i]->stop();
+            delete fWorkers[i];
+        }
+    }
+
+    class Worker : public Thread
+    {
+    public:
+        Worker(PluginThreadPool* const pool) noexcept
+            : Thread("DPF Thread Pool"),
+              fPool(pool) {}
+
+        void stop()
+        {
+            signalThreadShouldExit();
+            fSemaphore.post();
+            stopThread(-1);
+        }
+
+        void wake() noexcept
+        {
+            fSemaphore.post();
+        }
+
+    protected:
+        void run() override
+        {
+            for (;;)
+            {
+                fSemaphore.wait();
+
+                if (shouldThreadExit())
+                    break;
+
+                fPool->runTasks();
+            }
+        }
+
+    private:
+        PluginThreadPool* const fPool;
+        Semaphore fSemaphore;
+
+        DISTRHO_DECLARE_NON_COPYABLE(Worker)
+    };
+
+    struct SharedPool {
+        Mutex mutex;
+        PluginThreadPool* pool;
+        uint32_t refCount;
+
+        SharedPool() noexcept
+            : mutex(),
+              pool(nullptr),
+              refCount(0) {}
+    };
+
+    static SharedPool& getSharedPool() noexcept
+    {
+        static SharedPool shared;
+        return shared;
+    }
+
+    // tasks are taken from a shared counter, so idle threads keep picking up whatever work is left.
+    // the task data is read before claiming a task, the claim fails if a new epoch was started meanwhile
+    void runTasks() noexcept
+    {
+        uint64_t state = fTaskState.load(std::memory_order_acquire);
+
+        for (;;)
+        {
+            const uint32_t task = static_cast<uint32_t>(state);
+            const Plugin::ParallelTaskFunc callback = fCallback.load(std::memory_order_acquire);
+            void* const callbackPtr = fCallbackPtr.load(std::memory_order_acquire);
+
+            if (task >= fTaskCount.load(std::memory_order_acquire))
+                break;
+
+            if (! fTaskState.compare_exchange_weak(state, state + 1,
+                                                   std::memory_order_acq_rel, std::memory_order_acquire))
+                continue;
+
+            callback(callbackPtr, task);
+            fPendingTasks.fetch_sub(1, std::memory_order_release);
+
+            state = fTaskState.load(std::memory_order_acquire);
+        }
+    }
+
+    // tell the CPU we are busy-waiting, so the other hardware thread on the core is not starved
+    static inline void cpuPause() noexcept
+    {
+       #if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+       #elif defined(__aarch64__) || (defined(__ARM_ARCH) && __ARM_ARCH >= 7)
+        __asm__ __volatile__("yield");
+       #endif
+    }
+
+    static uint32_t getCpuCount() noexcept
+    {
+       #ifdef DISTRHO_OS_WINDOWS
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwNumberOfProcessors;
+       #else
+        const long count = sysconf(_SC_NPROCESSORS_ONLN);
+        return count > 0 ? static_cast<uint32_t>(count) : 1;
+       #endif
+    }
+
+    Worker* fWorkers[kMaxParallelThreads];
+    uint32_t fWorkerCount;
+
+    std::atomic<Plugin::ParallelTaskFunc> fCallback;
+    std::atomic<void*> fCallbackPtr;
+    std::atomic<uint32_t> fTaskCount;
+
+    std::atomic<bool> fBusy;
+    // execute epoch in the upper 32 bits, next task to run in the lower 32 bits
+    std::atomic<uint64_t> fTaskState;
+    std::atomic<uint32_t> fPendingTasks;
+
+    DISTRHO_DECLARE_NON_COPYABLE(PluginThreadPool)
+};
+#endif
+
+#if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+// -----------------------------------------------------------------------
+// Linear ramp towards the last value of a smoothed parameter
+
+struct PluginParameterSmoother {
+    float current;
+    float target;
+    float step;
+    uint32_t length;    // full ramp duration, in frames
+    uint32_t remaining; // frames until target is reached
+
+    PluginParameterSmoother() noexcept
+        : current(0.f),
+          target(0.f),
+          step(0.f),
+          length(0),
+          remaining(0) {}
+
+    void setTargetValue(const float value) noexcept
+    {
+        if (d_isEqual(target, value))
+            return;
+
+        target = value;
+
+        if (length == 0)
+        {
+            current = value;
+            remaining = 0;
+            return;
+        }
+
+        // each change restarts a full-length ramp from where we are now
+        step = (value - current) / static_cast<float>(length);
+        remaining = length;
+    }
+
+    void clearToTargetValue() noexcept
+    {
+        current = target;
+        remaining = 0;
+    }
+
+    // write the next @a frames values, kept branch-free inside the loops so they can be vectorized
+    void fill(float* const buffer, const uint32_t frames) noexcept
+    {
+        const uint32_t rampFrames = std::min(frames, remaining);
+        const float start = current;
+        const float rampStep = step;
+
+        for (uint32_t i=0; i < rampFrames; ++i)
+            buffer[i] = start + rampStep * static_cast<float>(i + 1);
+
+        remaining -= rampFrames;
+
+        if (remaining == 0)
+        {
+            current = target;
+            if (rampFrames != 0)
+                buffer[rampFrames - 1] = target;
+        }
+        else
+        {
+            current = start + rampStep * static_cast<float>(rampFrames);
+        }
+
+        const float value = current;
+
+        for (uint32_t i=rampFrames; i < frames; ++i)
+            buffer[i] = value;
+    }
+};
+#endif
+
+#if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+// -----------------------------------------------------------------------
+// Audio buffers used to run the plugin in fixed-size blocks
+
+template<typename T>
+struct PluginFixedBlock {
+    // at least 1 channel, to keep the arrays valid
+    T inputs[DISTRHO_PLUGIN_NUM_INPUTS != 0 ? DISTRHO_PLUGIN_NUM_INPUTS : 1][kFixedBlockSize];
+    T outputs[DISTRHO_PLUGIN_NUM_OUTPUTS != 0 ? DISTRHO_PLUGIN_NUM_OUTPUTS : 1][kFixedBlockSize];
+    const T* inputPtrs[DISTRHO_PLUGIN_NUM_INPUTS != 0 ? DISTRHO_PLUGIN_NUM_INPUTS : 1];
+    T* outputPtrs[DISTRHO_PLUGIN_NUM_OUTPUTS != 0 ? DISTRHO_PLUGIN_NUM_OUTPUTS : 1];
+
+    PluginFixedBlock() noexcept
+    {
+       #if DISTRHO_PLUGIN_NUM_INPUTS != 0
+        for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_INPUTS; ++i)
+            inputPtrs[i] = inputs[i];
+       #else
+        inputPtrs[0] = nullptr;
+       #endif
+
+       #if DISTRHO_PLUGIN_NUM_OUTPUTS != 0
+        for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_OUTPUTS; ++i)
+            outputPtrs[i] = outputs[i];
+       #else
+        outputPtrs[0] = nullptr;
+       #endif
+
+        clear();
+    }
+
+    void clear() noexcept
+    {
+        std::memset(inputs, 0, sizeof(inputs));
+        std::memset(outputs, 0, sizeof(outputs));
+    }
+};
+#endif
+
+// -----------------------------------------------------------------------
+// Plugin exporter class
+
+class PluginExporter
+{
+public:
+    PluginExporter(void* const callbacksPtr,
+                   const writeMidiFunc writeMidiCall,
+                   const requestParameterValueChangeFunc requestParameterValueChangeCall,
+                   const updateStateValueFunc updateStateValueCall)
+        : fPlugin(static_cast<PluginClass*>(createPlugin())),
+          fData((fPlugin != nullptr) ? fPlugin->pData : nullptr),
+          fIsActive(false),
+          fOwnParameterTable(),
+          fOwnParameterSymbolIndex(),
+          fParameterTable(&fOwnParameterTable),
+          fParameterSymbolIndex(&fOwnParameterSymbolIndex)
+         #if DISTRHO_PLUGIN_WANT_WORKER
+        , fWorker(nullptr)
+         #endif
+         #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+        , fThreadPool(nullptr),
+          fUsesHostThreadPool(false)
+         #endif
+         #if DISTRHO_PLUGIN_WANT_SILENCE_DETECTION
+        , fSilentInputFrames(0),
+          fOutputSilent(false)
+         #endif
+         #ifdef DPF_TRACING
+        , fTrace(nullptr)
+         #endif
+         #if DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS
+        , fPendingBatchIndexes(nullptr),
+          fPendingBatchValues(nullptr)
+         #endif
+         #if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+        , fParameterSmoothers(nullptr),
+          fParameterRampSize(0)
+         #endif
+         #if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+        , fOversampler(DISTRHO_PLUGIN_NUM_INPUTS, DISTRHO_PLUGIN_NUM_OUTPUTS)
+         #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+        , fOversampler64(DISTRHO_PLUGIN_NUM_INPUTS, DISTRHO_PLUGIN_NUM_OUTPUTS)
+         #endif
+        , fOversamplingOverflowFrames(0)
+         #endif
+         #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+        , fHostBufferSize(d_nextBufferSize),
+          fFixedBlockPosition(0)
+         #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        , fFixedBlockMidiEventCount(0)
+         #endif
+         #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
+        , fFixedBlockMidiOutputIndex(0)
+         #endif
+         #endif
+         #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+        , fParameterEventCount(0)
+         #endif
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
+
+#if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+        {
+            uint32_t j=0;
+# if DISTRHO_PLUGIN_NUM_INPUTS > 0
+            for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_INPUTS; ++i, ++j)
+                fPlugin->initAudioPort(true, i, fData->audioPorts[j]);
+# endif
+# if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+            for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_OUTPUTS; ++i, ++j)
+                fPlugin->initAudioPort(false, i, fData->audioPorts[j]);
+# endif
+        }
+#endif // DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+
+#if DISTRHO_PLUGIN_WANT_SHARED_PARAMETERS
+        if (fData->parameterCount != 0)
+        {
+            const MutexLocker cml(PluginSharedParameters::getMutex());
+            PluginParameterTable* sharedTable = nullptr;
+            PluginSymbolIndex* sharedSymbolIndex = nullptr;
+            bool needsInit = false;
+
+            fData->parameters = PluginSharedParameters::acquire(fData->parameterCount, needsInit,
+                                                                sharedTable, sharedSymbolIndex);
+
+            // only the first instance fills in the parameters, all others reuse them
+            if (needsInit)
+            {
+                for (uint32_t i=0, count=fData->parameterCount; i < count; ++i)
+                    fPlugin->initParameter(i, fData->parameters[i]);
+
+                if (sharedTable != nullptr)
+                {
+                    sharedTable->init(fData->parameters, fData->parameterCount);
+                    sharedSymbolIndex->build(fData->parameters, fData->parameterCount, &Parameter::symbol);
+                }
+            }
+
+            if (sharedTable != nullptr)
+            {
+                fParameterTable = sharedTable;
+                fParameterSymbolIndex = sharedSymbolIndex;
+            }
+        }
+#else
+        for (uint32_t i=0, count=fData->parameterCount; i < count; ++i)
+            fPlugin->initParameter(i, fData->parameters[i]);
+#endif
+
+        // not shared with other instances, build our own
+        if (fParameterTable == &fOwnParameterTable)
+        {
+            fOwnParameterTable.init(fData->parameters, fData->parameterCount);
+            fOwnParameterSymbolIndex.build(fData->parameters, fData->parameterCount, &Parameter::symbol);
+        }
+
+#if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+        // start with all outputs marked as changed, so hosts receive their initial values
+        for (uint32_t i=0, count=fData->parameterCount; i < count; ++i)
+        {
+            if ((fData->parameters[i].hints & kParameterIsOutput) == 0x0)
+                continue;
+
+            fData->outputParameterValues[i] = fData->parameters[i].ranges.def;
+            fData->markParameterChanged(i);
+        }
+#endif
+
+#if DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS
+        if (fData->parameterCount != 0)
+        {
+            fPendingBatchIndexes = new uint32_t[fData->parameterCount];
+            fPendingBatchValues = new float[fData->parameterCount];
+        }
+#endif
+
+#if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+        if (fData->parameterCount != 0 && ! fData->isDummy)
+        {
+            const uint32_t kUnsmoothableHints = kParameterIsOutput|kParameterIsBoolean|kParameterIsInteger;
+            bool needsSmoothing = false;
+
+            for (uint32_t i=0, count=fData->parameterCount; i < count; ++i)
+            {
+                const uint32_t hints = fData->parameters[i].hints;
+
+                if ((hints & kParameterIsSmoothed) == 0x0)
+                    continue;
+
+                if (hints & kUnsmoothableHints)
+                {
+                    d_stderr2("DPF warning: Parameter %u cannot be smoothed, it is an output, boolean or integer", i);
+                    continue;
+                }
+
+                needsSmoothing = true;
+            }
+
+            if (needsSmoothing)
+            {
+                fParameterSmoothers = new PluginParameterSmoother[fData->parameterCount];
+                fData->parameterRamps = new float*[fData->parameterCount];
+                fParameterRampSize = getMaxPluginBufferSize();
+
+                for (uint32_t i=0, count=fData->parameterCount; i < count; ++i)
+                {
+                    const uint32_t hints = fData->parameters[i].hints;
+
+                    if ((hints & kParameterIsSmoothed) == 0x0 || (hints & kUnsmoothableHints) != 0x0)
+                    {
+                        fData->parameterRamps[i] = nullptr;
+                        continue;
+                    }
+
+                    fData->parameterRamps[i] = new float[fParameterRampSize];
+                    fParameterSmoothers[i].setTargetValue(fPlugin->getParameterValue(i));
+                    fParameterSmoothers[i].clearToTargetValue();
+                }
+
+                updateParameterSmoothingLengths();
+            }
+        }
+#endif
+
+        {
+            std::set<uint32_t> portGroupIndices;
+
+#if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+            for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS; ++i)
+                portGroupIndices.insert(fData->audioPorts[i].groupId);
+#endif
+            for (uint32_t i=0, count=fData->parameterCount; i < count; ++i)
+                portGroupIndices.insert(fData->parameters[i].groupId);
+
+            portGroupIndices.erase(kPortGroupNone);
+
+            if (const uint32_t portGroupSize = static_cast<uint32_t>(portGroupIndices.size()))
+            {
+                fData->portGroups = new PortGroupWithId[portGroupSize];
+                fData->portGroupCount = portGroupSize;
+
+                uint32_t index = 0;
+                for (std::set<uint32_t>::iterator it = portGroupIndices.begin(); it != portGroupIndices.end(); ++it, ++index)
+                {
+                    PortGroupWithId& portGroup(fData->portGroups[index]);
+                    portGroup.groupId = *it;
+
+                    if (portGroup.groupId < portGroupSize)
+                        fPlugin->initPortGroup(portGroup.groupId, portGroup);
+                    else
+                        fillInPredefinedPortGroupData(portGroup.groupId, portGroup);
+                }
+            }
+        }
+
+#if DISTRHO_PLUGIN_WANT_PROGRAMS
+        for (uint32_t i=0; i < fData->programCount; ++i)
+            fPlugin->initProgramName(i, fData->programNames[i]);
+#endif
+
+#if DISTRHO_PLUGIN_WANT_STATE
+        for (uint32_t i=0; i < fData->stateCount; ++i)
+            fPlugin->initState(i, fData->states[i]);
+
+        fStateKeyIndex.build(fData->states, fData->stateCount, &State::key);
+#endif
+
+#if defined(DPF_RUNTIME_TESTING) && defined(__GNUC__) && !defined(__clang__)
+        /* Run-time testing build.
+         * Verify that virtual functions are overriden if parameters, programs or states are in use.
+         * This does not work on all compilers, but we use it purely as informational check anyway. */
+        if (fData->parameterCount != 0)
+        {
+            if ((void*)(fPlugin->*(&Plugin::initParameter)) == (void*)&Plugin::initParameter)
+            {
+                d_stderr2("DPF warning: Plugins with parameters must implement `initParameter`");
+                abort();
+            }
+            if ((void*)(fPlugin->*(&Plugin::getParameterValue)) == (void*)&Plugin::getParameterValue)
+            {
+                d_stderr2("DPF warning: Plugins with parameters must implement `getParameterValue`");
+                abort();
+            }
+            if ((void*)(fPlugin->*(&Plugin::setParameterValue)) == (void*)&Plugin::setParameterValue)
+            {
+                d_stderr2("DPF warning: Plugins with parameters must implement `setParameterValue`");
+                abort();
+            }
+        }
+
+# if DISTRHO_PLUGIN_WANT_PROGRAMS
+        if (fData->programCount != 0)
+        {
+            if ((void*)(fPlugin->*(&Plugin::initProgramName)) == (void*)&Plugin::initProgramName)
+            {
+                d_stderr2("DPF warning: Plugins with programs must implement `initProgramName`");
+                abort();
+            }
+            if ((void*)(fPlugin->*(&Plugin::loadProgram)) == (void*)&Plugin::loadProgram)
+            {
+                d_stderr2("DPF warning: Plugins with programs must implement `loadProgram`");
+                abort();
+            }
+        }
+# endif
+
+# if DISTRHO_PLUGIN_WANT_STATE
+        if (fData->stateCount != 0)
+        {
+            bool hasNonUiState = false;
+            for (uint32_t i=0; i < fData->stateCount; ++i)
+            {
+                if ((fData->states[i].hints & kStateIsOnlyForUI) == 0)
+                {
+                    hasNonUiState = true;
+                    break;
+                }
+            }
+
+            if (hasNonUiState)
+            {
+                if ((void*)(fPlugin->*(static_cast<void(Plugin::*)(uint32_t,State&)>(&Plugin::initState))) ==
+                    (void*)static_cast<void(Plugin::*)(uint32_t,State&)>(&Plugin::initState))
+                {
+                    d_stderr2("DPF warning: Plugins with state must implement `initState`");
+                    abort();
+                }
+
+                if ((void*)(fPlugin->*(&Plugin::setState)) == (void*)&Plugin::setState)
+                {
+                    d_stderr2("DPF warning: Plugins with state must implement `setState`");
+                    abort();
+                }
+            }
+        }
+# endif
+
+# if DISTRHO_PLUGIN_WANT_FULL_STATE
+        if (fData->stateCount != 0)
+        {
+            if ((void*)(fPlugin->*(&Plugin::getState)) == (void*)&Plugin::getState)
+            {
+                d_stderr2("DPF warning: Plugins with full state must implement `getState`");
+                abort();
+            }
+        }
+        else
+        {
+            d_stderr2("DPF warning: Plugins with full state must have at least 1 state");
+            abort();
+        }
+# endif
+#endif
+
+        fData->callbacksPtr = callbacksPtr;
+        fData->writeMidiCallbackFunc = writeMidiCall;
+        fData->requestParameterValueChangeCallbackFunc = requestParameterValueChangeCall;
+        fData->updateStateValueCallbackFunc = updateStateValueCall;
+
+#if DISTRHO_PLUGIN_WANT_WORKER
+        // use our own worker thread, unless the wrapper provides a host one later
+        if (! fData->isDummy)
+        {
+            fWorker = new PluginWorker(fPlugin);
+            fData->workerPtr = fWorker;
+            fData->scheduleWorkCallbackFunc = PluginWorker::scheduleWorkCallback;
+            fData->sendWorkResponseCallbackFunc = PluginWorker::sendWorkResponseCallback;
+            fWorker->startThread();
+        }
+#endif
+
+#if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+        fOversampler.setFactor(fData->oversamplingFactor);
+       #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+        fOversampler64.setFactor(fData->oversamplingFactor);
+       #endif
+
+        if (! fData->isDummy)
+        {
+           #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+            fOversampler.setBufferSize(kFixedBlockSize);
+           #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+            fOversampler64.setBufferSize(kFixedBlockSize);
+           #endif
+           #else
+            fOversampler.setBufferSize(getBufferSize());
+           #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+            fOversampler64.setBufferSize(getBufferSize());
+           #endif
+           #endif
+        }
+#endif
+
+        if (! fData->isDummy)
+            resizeScratchArena();
+
+#ifdef DPF_TRACING
+        // no point in tracing instances only used for metadata
+        if (! fData->isDummy)
+            fTrace = new PluginTraceRecorder(fPlugin->getName());
+#endif
+    }
+
+    ~PluginExporter()
+    {
+#ifdef DPF_TRACING
+        delete fTrace;
+#endif
+#if DISTRHO_PLUGIN_WANT_WORKER
+        delete fWorker;
+#endif
+#if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+        if (fThreadPool != nullptr)
+            PluginThreadPool::release();
+#endif
+#if DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS
+        delete[] fPendingBatchIndexes;
+        delete[] fPendingBatchValues;
+#endif
+#if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+        delete[] fParameterSmoothers;
+#endif
+        delete fPlugin;
+    }
+
+    // -------------------------------------------------------------------
+
+    const char* getName() const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, "");
+
+        return fPlugin->getName();
+    }
+
+    const char* getLabel() const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, "");
+
+        return fPlugin->getLabel();
+    }
+
+    const char* getDescription() const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, "");
+
+        return fPlugin->getDescription();
+    }
+
+    const char* getMaker() const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, "");
+
+        return fPlugin->getMaker();
+    }
+
+    const char* getHomePage() const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, "");
+
+        return fPlugin->getHomePage();
+    }
+
+    const char* getLicense() const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, "");
+
+        return fPlugin->getLicense();
+    }
+
+    uint32_t getVersion() const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, 0);
+
+        return fPlugin->getVersion();
+    }
+
+    long getUniqueId() const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, 0);
+
+        return fPlugin->getUniqueId();
+    }
+
+    // always the Plugin base, even when calls are bound to DISTRHO_PLUGIN_CLASS
+    void* getInstancePointer() const noexcept
+    {
+        return static_cast<Plugin*>(fPlugin);
+    }
+
+    // -------------------------------------------------------------------
+
+#if DISTRHO_PLUGIN_WANT_LATENCY
+    uint32_t getLatency() const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0);
+
+       #if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+        // plugin latency is in oversampled frames, rounded up to host frames
+        const uint32_t factor = fData->oversamplingFactor;
+        return (fData->latency + factor - 1) / factor + PluginOversampler<float>::getLatency(factor)
+             #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+               + kFixedBlockSize
+             #endif
+               ;
+       #elif DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+        return fData->latency + kFixedBlockSize;
+       #else
+        return fData->latency;
+       #endif
+    }
+#endif
+
+    uint32_t getTailLength() const
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, 0);
+
+       #if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+        const uint32_t tailLength = fPlugin->getTailLength();
+
+        if (tailLength == UINT32_MAX)
+            return tailLength;
+
+        // same as latency, the filters keep ringing a bit longer
+        const uint32_t factor = fData->oversamplingFactor;
+        return (tailLength + factor - 1) / factor + PluginOversampler<float>::getLatency(factor)
+             #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+               + kFixedBlockSize
+             #endif
+               ;
+       #elif DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+        const uint32_t tailLength = fPlugin->getTailLength();
+
+        // the last block only comes out after the FIFO is flushed
+        return tailLength != UINT32_MAX ? tailLength + kFixedBlockSize : tailLength;
+       #else
+        return fPlugin->getTailLength();
+       #endif
+    }
+
+#if DISTRHO_PLUGIN_WANT_SILENCE_DETECTION
+    // whether the audio outputs of the last run were silent
+    bool isOutputSilent() const noexcept
+    {
+        return fOutputSilent;
+    }
+
+    // whether the outputs are silent and the input has been silent for at least the tail length
+    bool isIdle() const
+    {
+        if (! fOutputSilent)
+            return false;
+
+        const uint32_t tailLength = getTailLength();
+
+        if (tailLength == UINT32_MAX)
+            return false;
+
+        return fSilentInputFrames >= tailLength;
+    }
+#endif
+
+#if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+    AudioPortWithBusId& getAudioPort(const bool input, const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, sFallbackAudioPort);
+
+        if (input)
+        {
+# if DISTRHO_PLUGIN_NUM_INPUTS > 0
+            DISTRHO_SAFE_ASSERT_RETURN(index < DISTRHO_PLUGIN_NUM_INPUTS,  sFallbackAudioPort);
+# endif
+        }
+        else
+        {
+# if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+            DISTRHO_SAFE_ASSERT_RETURN(index < DISTRHO_PLUGIN_NUM_OUTPUTS, sFallbackAudioPort);
+# endif
+        }
+
+        return fData->audioPorts[index + (input ? 0 : DISTRHO_PLUGIN_NUM_INPUTS)];
+    }
+
+    uint32_t getAudioPortHints(const bool input, const uint32_t index) const noexcept
+    {
+        return getAudioPort(input, index).hints;
+    }
+    
+    uint32_t getAudioPortCountWithGroupId(const bool input, const uint32_t groupId) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0);
+
+        uint32_t numPorts = 0;
+
+        if (input)
+        {
+           #if DISTRHO_PLUGIN_NUM_INPUTS > 0
+            for (uint32_t i=0; i<DISTRHO_PLUGIN_NUM_INPUTS; ++i)
+            {
+                if (fData->audioPorts[i].groupId == groupId)
+                    ++numPorts;
+            }
+           #endif
+        }
+        else
+        {
+           #if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+            for (uint32_t i=0; i<DISTRHO_PLUGIN_NUM_OUTPUTS; ++i)
+            {
+                if (fData->audioPorts[i + DISTRHO_PLUGIN_NUM_INPUTS].groupId == groupId)
+                    ++numPorts;
+            }
+           #endif
+        }
+
+        return numPorts;
+    }
+#endif
+
+    uint32_t getParameterCount() const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0);
+
+        return fData->parameterCount;
+    }
+
+    uint32_t getParameterOffset() const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0);
+
+        return fData->parameterOffset;
+    }
+
+    uint32_t getParameterHints(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, 0x0);
+
+        return fParameterTable->hints[index];
+    }
+
+    ParameterDesignation getParameterDesignation(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, kParameterDesignationNull);
+
+        return fData->parameters[index].designation;
+    }
+
+    bool isParameterInput(const uint32_t index) const noexcept
+    {
+        return (getParameterHints(index) & kParameterIsOutput) == 0x0;
+    }
+
+    bool isParameterOutput(const uint32_t index) const noexcept
+    {
+        return (getParameterHints(index) & kParameterIsOutput) != 0x0;
+    }
+
+    bool isParameterInteger(const uint32_t index) const noexcept
+    {
+        return (getParameterHints(index) & kParameterIsInteger) != 0x0;
+    }
+
+    bool isParameterTrigger(const uint32_t index) const noexcept
+    {
+        return (getParameterHints(index) & kParameterIsTrigger) == kParameterIsTrigger;
+    }
+
+    bool isParameterOutputOrTrigger(const uint32_t index) const noexcept
+    {
+        const uint32_t hints = getParameterHints(index);
+
+        if (hints & kParameterIsOutput)
+            return true;
+        if ((hints & kParameterIsTrigger) == kParameterIsTrigger)
+            return true;
+
+        return false;
+    }
+
+    const String& getParameterName(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, sFallbackString);
+
+        return fData->parameters[index].name;
+    }
+
+    const String& getParameterShortName(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, sFallbackString);
+
+        return fData->parameters[index].shortName;
+    }
+
+    const String& getParameterSymbol(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, sFallbackString);
+
+        return fData->parameters[index].symbol;
+    }
+
+    const String& getParameterUnit(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, sFallbackString);
+
+        return fData->parameters[index].unit;
+    }
+
+    const String& getParameterDescription(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, sFallbackString);
+
+        return fData->parameters[index].description;
+    }
+
+    const ParameterEnumerationValues& getParameterEnumValues(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, sFallbackEnumValues);
+
+        return fData->parameters[index].enumValues;
+    }
+
+    const ParameterRanges& getParameterRanges(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, sFallbackRanges);
+
+        return fData->parameters[index].ranges;
+    }
+
+    float getParameterMinimum(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, 0.0f);
+
+        return fParameterTable->minimums[index];
+    }
+
+    float getParameterMaximum(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, 1.0f);
+
+        return fParameterTable->maximums[index];
+    }
+
+    // same as ParameterRanges::getFixedAndNormalizedValue(), without touching the full parameter data
+    double getNormalizedParameterValue(const uint32_t index, const double plain) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, 0.0);
+
+        const double normalized = (plain - fParameterTable->minimums[index]) * fParameterTable->normScales[index];
+
+        if (normalized <= 0.0)
+            return 0.0;
+        if (normalized >= 1.0)
+            return 1.0;
+        return normalized;
+    }
+
+    // same as ParameterRanges::getUnnormalizedValue(), without touching the full parameter data
+    double getUnnormalizedParameterValue(const uint32_t index, const double normalized) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, 0.0);
+
+        const double min = fParameterTable->minimums[index];
+        const double max = fParameterTable->maximums[index];
+
+        if (normalized <= 0.0)
+            return min;
+        if (normalized >= 1.0)
+            return max;
+        return normalized * (max - min) + min;
+    }
+
+    uint8_t getParameterMidiCC(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, 0);
+
+        return fData->parameters[index].midiCC;
+    }
+
+    uint32_t getParameterGroupId(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, kPortGroupNone);
+
+        return fData->parameters[index].groupId;
+    }
+
+    float getParameterDefault(const uint32_t index) const
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, 0.0f);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, 0.0f);
+
+        return fParameterTable->defaults[index];
+    }
+
+    float getParameterValue(const uint32_t index) const
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, 0.0f);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, 0.0f);
+
+       #if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+        if (fParameterTable->hints[index] & kParameterIsOutput)
+            return fData->outputParameterValues[index];
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS
+        // not yet received by the plugin
+        if (fData->isParameterPending(index))
+            return fData->pendingParameterValues[index].load(std::memory_order_relaxed);
+       #endif
+
+        return fPlugin->getParameterValue(index);
+    }
+
+    void setParameterValue(const uint32_t index, const float value)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount,);
+
+       #if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+        markTriggerParameterIfChanged(index, value);
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS
+        // keep a pending trigger pulse until the plugin gets it, triggers are reset after each run anyway
+        if ((fParameterTable->hints[index] & kParameterIsTrigger) == kParameterIsTrigger
+            && d_isEqual(value, fParameterTable->defaults[index]) && fData->isParameterPending(index))
+            return;
+
+        // can be called from any thread, the plugin only gets the value at the start of the next run
+        fData->setPendingParameterValue(index, value);
+       #else
+        setPluginParameterValue(index, value);
+       #endif
+    }
+
+    void setParameterValues(const uint32_t* const indexes, const float* const values, const uint32_t count)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
+
+        if (count == 0)
+            return;
+
+        DISTRHO_SAFE_ASSERT_RETURN(indexes != nullptr && values != nullptr,);
+
+       #if DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS
+        // pending values already reach the plugin as a single batch on the next run
+        for (uint32_t i=0; i < count; ++i)
+            setParameterValue(indexes[i], values[i]);
+       #else
+        for (uint32_t i=0; i < count; ++i)
+        {
+            DISTRHO_SAFE_ASSERT_UINT2_RETURN(indexes[i] < fData->parameterCount, indexes[i], fData->parameterCount,);
+
+           #if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+            markTriggerParameterIfChanged(indexes[i], values[i]);
+           #endif
+        }
+
+        setPluginParameterValues(indexes, values, count);
+       #endif
+    }
+
+   #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+    // must only be called from the audio thread, right before run()
+    void setParameterValueAtFrame(const uint32_t frame, const uint32_t index, const float value)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount,);
+
+       #if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+        markTriggerParameterIfChanged(index, value);
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS
+        // this change is newer than any pending one, which would otherwise override it
+        fData->pendingParameters[index / 32].fetch_and(~(1u << (index % 32)), std::memory_order_relaxed);
+       #endif
+
+        // nothing to gain from delaying changes at the start of the block
+        if (frame == 0)
+            return setPluginParameterValue(index, value);
+
+        // apply right away if we cannot store more events, slightly early is better than never
+        if (fParameterEventCount == kMaxParameterEvents)
+            return setPluginParameterValue(index, value);
+
+        // insert sorted by frame, keeping the order of events with the same frame
+        uint32_t pos = fParameterEventCount++;
+        for (; pos != 0 && fParameterEvents[pos - 1].frame > frame; --pos)
+            fParameterEvents[pos] = fParameterEvents[pos - 1];
+
+        ParameterEvent& event(fParameterEvents[pos]);
+        event.frame = frame;
+        event.index = index;
+        event.value = value;
+    }
+   #endif
+
+   #if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+    void markParameterChanged(const uint32_t index) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount,);
+
+        fData->markParameterChanged(index);
+    }
+
+    // find the next changed parameter output or trigger at or after index, clearing its changed flag
+    // use as `for (uint32_t i=0; getNextChangedParameter(i); ++i)`
+    bool getNextChangedParameter(uint32_t& index) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, false);
+
+        for (uint32_t w = index / 32, count = (fData->parameterCount + 31) / 32; w < count; ++w)
+        {
+            uint32_t bits = fData->changedParameters[w].load(std::memory_order_relaxed);
+
+            if (w == index / 32)
+                bits &= ~0u << (index % 32);
+
+            if (bits == 0)
+                continue;
+
+           #ifdef __GNUC__
+            const uint32_t bit = static_cast<uint32_t>(__builtin_ctz(bits));
+           #else
+            uint32_t bit = 0;
+            while ((bits & (1u << bit)) == 0)
+                ++bit;
+           #endif
+
+            fData->changedParameters[w].fetch_and(~(1u << bit), std::memory_order_acquire);
+            index = w * 32 + bit;
+            return true;
+        }
+
+        return false;
+    }
+   #endif
+
+    bool getParameterIndexForSymbol(const char* const symbol, uint32_t& index) const noexcept
+    {
+        return fParameterSymbolIndex->find(symbol, index);
+    }
+
+    uint32_t getPortGroupCount() const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0);
+
+        return fData->portGroupCount;
+    }
+
+    const PortGroupWithId& getPortGroupById(const uint32_t groupId) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && fData->portGroupCount != 0, sFallbackPortGroup);
+
+        for (uint32_t i=0; i < fData->portGroupCount; ++i)
+        {
+            const PortGroupWithId& portGroup(fData->portGroups[i]);
+
+            if (portGroup.groupId == groupId)
+                return portGroup;
+        }
+
+        return sFallbackPortGroup;
+    }
+
+    const PortGroupWithId& getPortGroupByIndex(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->portGroupCount, sFallbackPortGroup);
+
+        return fData->portGroups[index];
+    }
+
+    const String& getPortGroupSymbolForId(const uint32_t groupId) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, sFallbackString);
+
+        return getPortGroupById(groupId).symbol;
+    }
+
 #if DISTRHO_PLUGIN_WANT_PROGRAMS
-        for (uint32_t i=0; i < fData->programCount; ++i)
-            fPlugin->initProgramName(i, fData->programNames[i]);
-#endif
+    uint32_t getProgramCount() const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0);
 
-#if DISTRHO_PLUGIN_WANT_STATE
-        for (uint32_t i=0; i < fData->stateCount; ++i)
-            fPlugin->initState(i, fData->states[i]);
-#endif
+        return fData->programCount;
+    }
 
-#if defined(DPF_RUNTIME_TESTING) && defined(__GNUC__) && !defined(__clang__)
-        /* Run-time testing build.
-         * Verify that virtual functions are overriden if parameters, programs or states are in use.
-         * This does not work on all compilers, but we use it purely as informational check anyway. */
-        if (fData->parameterCount != 0)
-        {
-            if ((void*)(fPlugin->*(&Plugin::initParameter)) == (void*)&Plugin::initParameter)
-            {
-                d_stderr2("DPF warning: Plugins with parameters must implement `initParameter`");
-                abort();
-            }
-            if ((void*)(fPlugin->*(&Plugin::getParameterValue)) == (void*)&Plugin::getParameterValue)
-            {
-                d_stderr2("DPF warning: Plugins with parameters must implement `getParameterValue`");
-                abort();
-            }
-            if ((void*)(fPlugin->*(&Plugin::setParameterValue)) == (void*)&Plugin::setParameterValue)
-            {
-                d_stderr2("DPF warning: Plugins with parameters must implement `setParameterValue`");
-                abort();
-            }
-        }
+    const String& getProgramName(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->programCount, sFallbackString);
 
-# if DISTRHO_PLUGIN_WANT_PROGRAMS
-        if (fData->programCount != 0)
-        {
-            if ((void*)(fPlugin->*(&Plugin::initProgramName)) == (void*)&Plugin::initProgramName)
-            {
-                d_stderr2("DPF warning: Plugins with programs must implement `initProgramName`");
-                abort();
-            }
-            if ((void*)(fPlugin->*(&Plugin::loadProgram)) == (void*)&Plugin::loadProgram)
-            {
-                d_stderr2("DPF warning: Plugins with programs must implement `loadProgram`");
-                abort();
-            }
-        }
-# endif
+        return fData->programNames[index];
+    }
 
-# if DISTRHO_PLUGIN_WANT_STATE
-        if (fData->stateCount != 0)
-        {
-            bool hasNonUiState = false;
-            for (uint32_t i=0; i < fData->stateCount; ++i)
-            {
-                if ((fData->states[i].hints & kStateIsOnlyForUI) == 0)
-                {
-                    hasNonUiState = true;
-                    break;
-                }
-            }
+    void loadProgram(const uint32_t index)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->programCount,);
 
-            if (hasNonUiState)
-            {
-                if ((void*)(fPlugin->*(static_cast<void(Plugin::*)(uint32_t,State&)>(&Plugin::initState))) ==
-                    (void*)static_cast<void(Plugin::*)(uint32_t,State&)>(&Plugin::initState))
-                {
-                    d_stderr2("DPF warning: Plugins with state must implement `initState`");
-                    abort();
-                }
+       #if DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS
+        // the program replaces any value that did not reach the plugin yet
+        for (uint32_t i=0, count=(fData->parameterCount + 31) / 32; i < count; ++i)
+            fData->pendingParameters[i].store(0, std::memory_order_relaxed);
+       #endif
 
-                if ((void*)(fPlugin->*(&Plugin::setState)) == (void*)&Plugin::setState)
-                {
-                    d_stderr2("DPF warning: Plugins with state must implement `setState`");
-                    abort();
-                }
-            }
-        }
-# endif
+       #ifdef DPF_TRACING
+        if (fTrace != nullptr)
+            fTrace->addEvent(PluginTraceRecord::kTypeProgram, index);
+       #endif
 
-# if DISTRHO_PLUGIN_WANT_FULL_STATE
-        if (fData->stateCount != 0)
+        fPlugin->loadProgram(index);
+
+       #if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+        // programs change parameters on the plugin side, ramp to the new values
+        if (fData->parameterRamps != nullptr)
         {
-            if ((void*)(fPlugin->*(&Plugin::getState)) == (void*)&Plugin::getState)
+            for (uint32_t i=0, count=fData->parameterCount; i < count; ++i)
             {
-                d_stderr2("DPF warning: Plugins with full state must implement `getState`");
-                abort();
+                if (fData->parameterRamps[i] != nullptr)
+                    fParameterSmoothers[i].setTargetValue(fPlugin->getParameterValue(i));
             }
         }
-        else
-        {
-            d_stderr2("DPF warning: Plugins with full state must have at least 1 state");
-            abort();
-        }
-# endif
-#endif
-
-        fData->callbacksPtr = callbacksPtr;
-        fData->writeMidiCallbackFunc = writeMidiCall;
-        fData->requestParameterValueChangeCallbackFunc = requestParameterValueChangeCall;
-        fData->updateStateValueCallbackFunc = updateStateValueCall;
+       #endif
     }
+#endif
 
-    ~PluginExporter()
+#if DISTRHO_PLUGIN_WANT_STATE
+    uint32_t getStateCount() const noexcept
     {
-        delete fPlugin;
-    }
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0);
 
-    // -------------------------------------------------------------------
+        return fData->stateCount;
+    }
 
-    const char* getName() const noexcept
+    uint32_t getStateHints(const uint32_t index) const noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, "");
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->stateCount, 0x0);
 
-        return fPlugin->getName();
+        return fData->states[index].hints;
     }
 
-    const char* getLabel() const noexcept
+    const String& getStateKey(const uint32_t index) const noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, "");
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->stateCount, sFallbackString);
 
-        return fPlugin->getLabel();
+        return fData->states[index].key;
     }
 
-    const char* getDescription() const noexcept
+    const String& getStateDefaultValue(const uint32_t index) const noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, "");
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->stateCount, sFallbackString);
 
-        return fPlugin->getDescription();
+        return fData->states[index].defaultValue;
     }
 
-    const char* getMaker() const noexcept
+    const String& getStateLabel(const uint32_t index) const noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, "");
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->stateCount, sFallbackString);
 
-        return fPlugin->getMaker();
+        return fData->states[index].label;
     }
 
-    const char* getHomePage() const noexcept
+    const String& getStateDescription(const uint32_t index) const noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, "");
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->stateCount, sFallbackString);
 
-        return fPlugin->getHomePage();
+        return fData->states[index].description;
     }
 
-    const char* getLicense() const noexcept
+   #ifdef __MOD_DEVICES__
+    const String& getStateFileTypes(const uint32_t index) const noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, "");
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->stateCount, sFallbackString);
 
-        return fPlugin->getLicense();
+        return fData->states[index].fileTypes;
     }
+   #endif
 
-    uint32_t getVersion() const noexcept
+   #if DISTRHO_PLUGIN_WANT_FULL_STATE
+    String getStateValue(const char* const key) const
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, 0);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, sFallbackString);
+        DISTRHO_SAFE_ASSERT_RETURN(key != nullptr && key[0] != '\0', sFallbackString);
 
-        return fPlugin->getVersion();
+        return fPlugin->getState(key);
     }
+   #endif
 
-    long getUniqueId() const noexcept
+    void setState(const char* const key, const char* const value)
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, 0);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(key != nullptr && key[0] != '\0',);
+        DISTRHO_SAFE_ASSERT_RETURN(value != nullptr,);
 
-        return fPlugin->getUniqueId();
+       #ifdef DPF_TRACING
+        if (fTrace != nullptr)
+            fTrace->addEvent(PluginTraceRecord::kTypeState, 0, 0.f, key);
+       #endif
+
+        fPlugin->setState(key, value);
     }
 
-    void* getInstancePointer() const noexcept
+    bool getStateIndexForKey(const char* const key, uint32_t& index) const noexcept
     {
-        return fPlugin;
+        return fStateKeyIndex.find(key, index);
     }
 
-    // -------------------------------------------------------------------
-
-#if DISTRHO_PLUGIN_WANT_LATENCY
-    uint32_t getLatency() const noexcept
+    bool wantStateKey(const char* const key) const noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0);
+        DISTRHO_SAFE_ASSERT_RETURN(key != nullptr && key[0] != '\0', false);
 
-        return fData->latency;
+        uint32_t index;
+        return fStateKeyIndex.find(key, index);
     }
 #endif
 
-#if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
-    AudioPortWithBusId& getAudioPort(const bool input, const uint32_t index) const noexcept
+#if DISTRHO_PLUGIN_WANT_TIMEPOS
+    void setTimePosition(const TimePosition& timePosition) noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, sFallbackAudioPort);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
 
-        if (input)
-        {
-# if DISTRHO_PLUGIN_NUM_INPUTS > 0
-            DISTRHO_SAFE_ASSERT_RETURN(index < DISTRHO_PLUGIN_NUM_INPUTS,  sFallbackAudioPort);
-# endif
-        }
-        else
-        {
-# if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
-            DISTRHO_SAFE_ASSERT_RETURN(index < DISTRHO_PLUGIN_NUM_OUTPUTS, sFallbackAudioPort);
-# endif
-        }
+        std::memcpy(&fData->timePosition, &timePosition, sizeof(TimePosition));
+    }
+#endif
 
-        return fData->audioPorts[index + (input ? 0 : DISTRHO_PLUGIN_NUM_INPUTS)];
+    // -------------------------------------------------------------------
+
+    bool isActive() const noexcept
+    {
+        return fIsActive;
     }
 
-    uint32_t getAudioPortHints(const bool input, const uint32_t index) const noexcept
+   #if DISTRHO_PLUGIN_WANT_DSP_LOAD
+    DspLoad getDspLoad() const noexcept
     {
-        return getAudioPort(input, index).hints;
+        DspLoad dspLoad;
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, dspLoad);
+
+        fData->dspLoadMeter.get(dspLoad);
+        return dspLoad;
     }
-    
-    uint32_t getAudioPortCountWithGroupId(const bool input, const uint32_t groupId) const noexcept
+   #endif
+
+    void activate()
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0);
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(! fIsActive,);
 
-        uint32_t numPorts = 0;
+       #if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+        updateOversamplingFactorIfNeeded();
+       #endif
 
-        if (input)
+       #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+        // join the shared thread pool the first time we are activated, unless the host provides one.
+        // this is done here and not on creation, so wrappers can install a host pool before any DPF threads start
+        if (fThreadPool == nullptr && ! fUsesHostThreadPool && ! fData->isDummy)
         {
-           #if DISTRHO_PLUGIN_NUM_INPUTS > 0
-            for (uint32_t i=0; i<DISTRHO_PLUGIN_NUM_INPUTS; ++i)
-            {
-                if (fData->audioPorts[i].groupId == groupId)
-                    ++numPorts;
-            }
-           #endif
-        }
-        else
-        {
-           #if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
-            for (uint32_t i=0; i<DISTRHO_PLUGIN_NUM_OUTPUTS; ++i)
-            {
-                if (fData->audioPorts[i + DISTRHO_PLUGIN_NUM_INPUTS].groupId == groupId)
-                    ++numPorts;
-            }
-           #endif
+            fThreadPool = PluginThreadPool::acquire();
+            fData->threadPoolPtr = fThreadPool;
+            fData->executeParallelCallbackFunc = PluginThreadPool::executeParallelCallback;
         }
+       #endif
 
-        return numPorts;
+        activatePlugin();
     }
-#endif
 
-    uint32_t getParameterCount() const noexcept
+    void deactivate()
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0);
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(fIsActive,);
 
-        return fData->parameterCount;
-    }
+       #ifdef DPF_TRACING
+        if (fTrace != nullptr)
+            fTrace->addEvent(PluginTraceRecord::kTypeDeactivate);
+       #endif
 
-    uint32_t getParameterOffset() const noexcept
-    {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0);
+        fIsActive = false;
+        fPlugin->deactivate();
 
-        return fData->parameterOffset;
+       #if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+        // apply a factor change made while active, so that wrappers see the new latency right away
+        updateOversamplingFactorIfNeeded();
+        reportOversamplingOverflowIfNeeded();
+       #endif
     }
 
-    uint32_t getParameterHints(const uint32_t index) const noexcept
+    void deactivateIfNeeded()
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, 0x0);
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
 
-        return fData->parameters[index].hints;
+        if (fIsActive)
+            deactivate();
     }
 
-    ParameterDesignation getParameterDesignation(const uint32_t index) const noexcept
+   #ifdef DPF_TRACING
+    // called by the format wrappers for messages coming from the UI, @a type is a short description
+    void traceUiMessage(const char* const type) noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, kParameterDesignationNull);
-
-        return fData->parameters[index].designation;
+        if (fTrace != nullptr)
+            fTrace->addEvent(PluginTraceRecord::kTypeUiMessage, 0, 0.f, type);
     }
+   #endif
 
-    bool isParameterInput(const uint32_t index) const noexcept
+   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+    void run(const float** const inputs, float** const outputs, const uint32_t frames,
+             const MidiEvent* const midiEvents, const uint32_t midiEventCount)
     {
-        return (getParameterHints(index) & kParameterIsOutput) == 0x0;
+        runImpl(inputs, outputs, frames, midiEvents, midiEventCount);
     }
-
-    bool isParameterOutput(const uint32_t index) const noexcept
+   #else
+    void run(const float** const inputs, float** const outputs, const uint32_t frames)
     {
-        return (getParameterHints(index) & kParameterIsOutput) != 0x0;
+        runImpl(inputs, outputs, frames, nullptr, 0);
     }
+   #endif
 
-    bool isParameterInteger(const uint32_t index) const noexcept
+   #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+    void run(const double** const inputs, double** const outputs, const uint32_t frames,
+             const MidiEvent* const midiEvents, const uint32_t midiEventCount)
     {
-        return (getParameterHints(index) & kParameterIsInteger) != 0x0;
+        runImpl(inputs, outputs, frames, midiEvents, midiEventCount);
     }
-
-    bool isParameterTrigger(const uint32_t index) const noexcept
+   #else
+    void run(const double** const inputs, double** const outputs, const uint32_t frames)
     {
-        return (getParameterHints(index) & kParameterIsTrigger) == kParameterIsTrigger;
+        runImpl(inputs, outputs, frames, nullptr, 0);
     }
+   #endif
+   #endif
 
-    bool isParameterOutputOrTrigger(const uint32_t index) const noexcept
+    // -------------------------------------------------------------------
+
+   #if DISTRHO_PLUGIN_WANT_WORKER
+    // replace DPF's worker thread with a host-provided one
+    void setWorkerCallbacks(void* const workerPtr,
+                            const workerFunc scheduleWorkCall,
+                            const workerFunc sendWorkResponseCall)
     {
-        const uint32_t hints = getParameterHints(index);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(! fIsActive,);
 
-        if (hints & kParameterIsOutput)
-            return true;
-        if ((hints & kParameterIsTrigger) == kParameterIsTrigger)
-            return true;
+        if (fWorker != nullptr)
+        {
+            delete fWorker;
+            fWorker = nullptr;
+        }
 
-        return false;
+        fData->workerPtr = workerPtr;
+        fData->scheduleWorkCallbackFunc = scheduleWorkCall;
+        fData->sendWorkResponseCallbackFunc = sendWorkResponseCall;
     }
 
-    const String& getParameterName(const uint32_t index) const noexcept
+    void work(const void* const data, const uint32_t size)
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, sFallbackString);
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
 
-        return fData->parameters[index].name;
+        fPlugin->work(data, size);
     }
 
-    const String& getParameterShortName(const uint32_t index) const noexcept
+    void workResponse(const void* const data, const uint32_t size)
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, sFallbackString);
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
 
-        return fData->parameters[index].shortName;
+        fPlugin->workResponse(data, size);
     }
+   #endif
 
-    const String& getParameterSymbol(const uint32_t index) const noexcept
+   #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+    // replace DPF's thread pool with a host-provided one
+    void setThreadPoolCallback(void* const threadPoolPtr, const executeParallelFunc executeParallelCall)
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, sFallbackString);
-
-        return fData->parameters[index].symbol;
-    }
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(! fIsActive,);
 
-    const String& getParameterUnit(const uint32_t index) const noexcept
-    {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, sFallbackString);
+        if (fThreadPool != nullptr)
+        {
+            PluginThreadPool::release();
+            fThreadPool = nullptr;
+        }
 
-        return fData->parameters[index].unit;
+        fUsesHostThreadPool = executeParallelCall != nullptr;
+        fData->threadPoolPtr = threadPoolPtr;
+        fData->executeParallelCallbackFunc = executeParallelCall;
     }
+   #endif
 
-    const String& getParameterDescription(const uint32_t index) const noexcept
+    // -------------------------------------------------------------------
+
+   #ifdef DISTRHO_PLUGIN_TARGET_AU
+    void setAudioPortIO(const uint16_t numInputs, const uint16_t numOutputs)
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, sFallbackString);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
 
-        return fData->parameters[index].description;
+        if (fIsActive) fPlugin->deactivate();
+        fPlugin->ioChanged(numInputs, numOutputs);
+        if (fIsActive) fPlugin->activate();
     }
+   #endif
 
-    const ParameterEnumerationValues& getParameterEnumValues(const uint32_t index) const noexcept
+    // -------------------------------------------------------------------
+
+    // scratch memory reserved for the wrapper, for getBufferSize() samples of the biggest type used by run()
+    void* getWrapperScratchBuffer() const noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, sFallbackEnumValues);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, nullptr);
 
-        return fData->parameters[index].enumValues;
+        return fData->scratchArena.getWrapperBuffer();
     }
 
-    const ParameterRanges& getParameterRanges(const uint32_t index) const noexcept
-    {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, sFallbackRanges);
+    // -------------------------------------------------------------------
 
-        return fData->parameters[index].ranges;
-    }
+    // NOTE: buffer size and sample rate are host values here, the plugin sees them multiplied by the oversampling factor
+    //       and, with a fixed block size, it always sees that as buffer size
 
-    uint8_t getParameterMidiCC(const uint32_t index) const noexcept
+    uint32_t getBufferSize() const noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, 0);
-
-        return fData->parameters[index].midiCC;
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0);
+       #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+        return fHostBufferSize;
+       #elif DISTRHO_PLUGIN_WANT_OVERSAMPLING
+        return fData->bufferSize / fData->oversamplingFactor;
+       #else
+        return fData->bufferSize;
+       #endif
     }
 
-    uint32_t getParameterGroupId(const uint32_t index) const noexcept
+    double getSampleRate() const noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, kPortGroupNone);
-
-        return fData->parameters[index].groupId;
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0.0);
+       #if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+        return fData->sampleRate / fData->oversamplingFactor;
+       #else
+        return fData->sampleRate;
+       #endif
     }
 
-    float getParameterDefault(const uint32_t index) const
+    bool setBufferSize(const uint32_t bufferSize, const bool doCallback = false)
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, 0.0f);
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, 0.0f);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, false);
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, false);
+        DISTRHO_SAFE_ASSERT(bufferSize >= 2);
 
-        return fData->parameters[index].ranges.def;
-    }
+       #if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+        // apply a pending factor change here on the host side, instead of during the next run,
+        // but only while inactive, an active plugin keeps its factor until deactivated
+        if (! fIsActive)
+            updateOversamplingFactorIfNeeded();
+       #endif
 
-    float getParameterValue(const uint32_t index) const
-    {
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, 0.0f);
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, 0.0f);
+       #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+        // unused, the plugin buffer size never changes
+        (void)doCallback;
 
-        return fPlugin->getParameterValue(index);
-    }
+        if (fHostBufferSize == bufferSize)
+            return false;
 
-    void setParameterValue(const uint32_t index, const float value)
-    {
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount,);
+        fHostBufferSize = bufferSize;
 
-        fPlugin->setParameterValue(index, value);
-    }
+        // the wrapper still needs memory for the host buffer size
+        if (! fData->isDummy)
+            resizeScratchArena();
 
-    /*
-    bool getParameterIndexForSymbol(const char* const symbol, uint32_t& index)
-    {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, false);
+        return true;
+       #else
+       #if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+        reportOversamplingOverflowIfNeeded();
 
-        for (uint32_t i=0; i < fData->parameterCount; ++i)
+        if (! fData->isDummy)
         {
-            if (fData->parameters[i].symbol == symbol)
-            {
-                index = i;
-                return true;
-            }
+            fOversampler.setBufferSize(bufferSize);
+           #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+            fOversampler64.setBufferSize(bufferSize);
+           #endif
         }
 
-        return false;
-    }
-    */
+        const uint32_t pluginBufferSize = bufferSize * fData->oversamplingFactor;
+       #else
+        const uint32_t pluginBufferSize = bufferSize;
+       #endif
 
-    uint32_t getPortGroupCount() const noexcept
-    {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0);
+        if (fData->bufferSize == pluginBufferSize)
+            return false;
 
-        return fData->portGroupCount;
-    }
+        fData->bufferSize = pluginBufferSize;
 
-    const PortGroupWithId& getPortGroupById(const uint32_t groupId) const noexcept
-    {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && fData->portGroupCount != 0, sFallbackPortGroup);
+        if (! fData->isDummy)
+            resizeScratchArena();
 
-        for (uint32_t i=0; i < fData->portGroupCount; ++i)
-        {
-            const PortGroupWithId& portGroup(fData->portGroups[i]);
+       #if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+        resizeParameterRamps();
+       #endif
 
-            if (portGroup.groupId == groupId)
-                return portGroup;
+        if (doCallback)
+        {
+            if (fIsActive) fPlugin->deactivate();
+            fPlugin->bufferSizeChanged(pluginBufferSize);
+            if (fIsActive) fPlugin->activate();
         }
 
-        return sFallbackPortGroup;
+        return true;
+       #endif
     }
 
-    const PortGroupWithId& getPortGroupByIndex(const uint32_t index) const noexcept
+    void setSampleRate(const double sampleRate, const bool doCallback = false)
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->portGroupCount, sFallbackPortGroup);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
+        DISTRHO_SAFE_ASSERT(sampleRate > 0.0);
 
-        return fData->portGroups[index];
+       #if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+        // same as in setBufferSize
+        if (! fIsActive)
+            updateOversamplingFactorIfNeeded();
+
+        const double pluginSampleRate = sampleRate * fData->oversamplingFactor;
+       #else
+        const double pluginSampleRate = sampleRate;
+       #endif
+
+        if (d_isEqual(fData->sampleRate, pluginSampleRate))
+            return;
+
+        fData->sampleRate = pluginSampleRate;
+
+       #if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+        updateParameterSmoothingLengths();
+       #endif
+
+        if (doCallback)
+        {
+            if (fIsActive) fPlugin->deactivate();
+            fPlugin->sampleRateChanged(pluginSampleRate);
+            if (fIsActive) fPlugin->activate();
+        }
     }
 
-    const String& getPortGroupSymbolForId(const uint32_t groupId) const noexcept
+    bool isOffline() const noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, sFallbackString);
-
-        return getPortGroupById(groupId).symbol;
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, false);
+        return fData->isOffline;
     }
 
-#if DISTRHO_PLUGIN_WANT_PROGRAMS
-    uint32_t getProgramCount() const noexcept
+    // NOTE: unlike buffer size and sample rate, the plugin is not deactivated for this callback
+    void setOffline(const bool offline, const bool doCallback = false)
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
 
-        return fData->programCount;
+        if (fData->isOffline == offline)
+            return;
+
+        fData->isOffline = offline;
+
+        if (doCallback)
+            fPlugin->processModeChanged(offline);
     }
 
-    const String& getProgramName(const uint32_t index) const noexcept
+private:
+    // -------------------------------------------------------------------
+    // Plugin and DistrhoPlugin data
+
+    PluginClass* const fPlugin;
+    Plugin::PrivateData* const fData;
+    bool fIsActive;
+
+    // parameter data used while processing and name lookups, built once after init
+    // the pointers refer to our own copies, or to the shared ones if using shared parameters
+    PluginParameterTable fOwnParameterTable;
+    PluginSymbolIndex fOwnParameterSymbolIndex;
+    const PluginParameterTable* fParameterTable;
+    const PluginSymbolIndex* fParameterSymbolIndex;
+   #if DISTRHO_PLUGIN_WANT_STATE
+    PluginSymbolIndex fStateKeyIndex;
+   #endif
+
+   #if DISTRHO_PLUGIN_WANT_WORKER
+    // only used when the host does not provide a worker
+    PluginWorker* fWorker;
+   #endif
+
+   #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+    // only used when the host does not provide a thread pool
+    PluginThreadPool* fThreadPool;
+    bool fUsesHostThreadPool;
+   #endif
+
+   #if DISTRHO_PLUGIN_WANT_SILENCE_DETECTION
+    // frames since the last non-silent input, and silence state of the last run outputs
+    uint32_t fSilentInputFrames;
+    bool fOutputSilent;
+   #endif
+
+   #ifdef DPF_TRACING
+    // null for dummy instances
+    PluginTraceRecorder* fTrace;
+   #endif
+
+    // -------------------------------------------------------------------
+    // Activation, shared by activate() and hosts that call run() without activating first
+
+    void activatePlugin()
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->programCount, sFallbackString);
+       #if DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS
+        // before resetting, so smoothed parameters start from the pending values instead of ramping to them
+        applyPendingParameterValues();
+       #endif
 
-        return fData->programNames[index];
+        resetProcessingState();
+
+       #ifdef DPF_TRACING
+        if (fTrace != nullptr)
+            fTrace->addEvent(PluginTraceRecord::kTypeActivate);
+       #endif
+
+        fIsActive = true;
+        fPlugin->activate();
     }
 
-    void loadProgram(const uint32_t index)
+    // -------------------------------------------------------------------
+    // Host run, shared by all run() variants, MIDI events are always null without MIDI input
+
+    template<typename T>
+    void runImpl(const T** const inputs, T** const outputs, const uint32_t frames,
+                 const MidiEvent* const midiEvents, const uint32_t midiEventCount)
     {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
         DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->programCount,);
 
-        fPlugin->loadProgram(index);
+        if (! fIsActive)
+            activatePlugin();
+
+       #ifdef DPF_RT_SAFETY_CHECKS
+        const ScopedRealtimeThread srt;
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS
+        applyPendingParameterValues();
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_WORKER
+        if (fWorker != nullptr)
+            fWorker->dispatchResponses();
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_SILENCE_DETECTION
+        // count how long the input has been silent, output can have gaps of silence while the tail plays
+        if (midiEventCount == 0 && isAudioSilent(inputs, DISTRHO_PLUGIN_NUM_INPUTS, frames))
+            fSilentInputFrames = static_cast<uint32_t>(std::min<uint64_t>(static_cast<uint64_t>(fSilentInputFrames) + frames, UINT32_MAX));
+        else
+            fSilentInputFrames = 0;
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_DSP_LOAD || defined(DPF_TRACING)
+        const uint64_t runStartTime = d_gettime_ns();
+       #endif
+        fData->isProcessing = true;
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+       #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+        runInFixedBlocks(inputs, outputs, frames, midiEvents, midiEventCount);
+       #else
+        runPlugin(inputs, outputs, frames, midiEvents, midiEventCount);
+       #endif
+       #else
+        // unused
+        (void)midiEvents;
+       #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+        runInFixedBlocks(inputs, outputs, frames);
+       #else
+        runPlugin(inputs, outputs, frames);
+       #endif
+       #endif
+        fData->isProcessing = false;
+       #if DISTRHO_PLUGIN_WANT_DSP_LOAD || defined(DPF_TRACING)
+        const uint64_t runEndTime = d_gettime_ns();
+       #endif
+       #if DISTRHO_PLUGIN_WANT_DSP_LOAD
+        addDspLoadBlock(runEndTime - runStartTime, frames);
+       #endif
+       #ifdef DPF_TRACING
+        if (fTrace != nullptr)
+            fTrace->addRun(runStartTime, runEndTime, frames, midiEventCount);
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_SILENCE_DETECTION
+        fOutputSilent = isAudioSilent(outputs, DISTRHO_PLUGIN_NUM_OUTPUTS, frames);
+       #endif
     }
-#endif
 
-#if DISTRHO_PLUGIN_WANT_STATE
-    uint32_t getStateCount() const noexcept
-    {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0);
+    // -------------------------------------------------------------------
+    // Run the plugin, oversampled and split into smaller blocks as needed
 
-        return fData->stateCount;
+    template<typename T>
+    void runPlugin(const T** const inputs, T** const outputs, const uint32_t frames
+                  #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+                   , const MidiEvent* const midiEvents, const uint32_t midiEventCount
+                  #endif
+                   )
+    {
+       #if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+        if (fData->oversamplingFactor != 1)
+        {
+           #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+            runOversampled(inputs, outputs, frames, midiEvents, midiEventCount);
+           #else
+            runOversampled(inputs, outputs, frames);
+           #endif
+            return;
+        }
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        runPluginSplit(inputs, outputs, frames, midiEvents, midiEventCount);
+       #else
+        runPluginSplit(inputs, outputs, frames);
+       #endif
+    }
+
+    template<typename T>
+    void runPluginSplit(const T** const inputs, T** const outputs, const uint32_t frames
+                       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+                        , const MidiEvent* const midiEvents, const uint32_t midiEventCount
+                       #endif
+                        )
+    {
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+       #if DPF_PLUGIN_RUN_IN_BLOCKS
+        if (needsToRunInBlocks(frames, midiEventCount))
+            runInBlocks(inputs, outputs, frames, midiEvents, midiEventCount);
+        else
+       #endif
+        runPluginBlock(inputs, outputs, frames, midiEvents, midiEventCount);
+       #else
+       #if DPF_PLUGIN_RUN_IN_BLOCKS
+        if (needsToRunInBlocks(frames, 0))
+            runInBlocks(inputs, outputs, frames);
+        else
+       #endif
+        runPluginBlock(inputs, outputs, frames);
+       #endif
     }
 
-    uint32_t getStateHints(const uint32_t index) const noexcept
+    // single call to the plugin run(), with everything it needs for exactly these frames
+    template<typename T>
+    void runPluginBlock(const T** const inputs, T** const outputs, const uint32_t frames
+                       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+                        , const MidiEvent* const midiEvents, const uint32_t midiEventCount
+                       #endif
+                        )
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->stateCount, 0x0);
+        fData->scratchArena.reset();
 
-        return fData->states[index].hints;
+       #if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+        fillParameterRamps(frames);
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        fPlugin->run(inputs, outputs, frames, midiEvents, midiEventCount);
+       #else
+        fPlugin->run(inputs, outputs, frames);
+       #endif
     }
 
-    const String& getStateKey(const uint32_t index) const noexcept
+    // called right before activating the plugin
+    void resetProcessingState() noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->stateCount, sFallbackString);
+       #if DISTRHO_PLUGIN_WANT_DSP_LOAD
+        fData->dspLoadMeter.reset();
+       #endif
 
-        return fData->states[index].key;
+       #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+        resetFixedBlock();
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+        // start from the current values, no need to ramp from wherever the last run ended
+        if (fData->parameterRamps != nullptr)
+        {
+            for (uint32_t i=0, count=fData->parameterCount; i < count; ++i)
+                fParameterSmoothers[i].clearToTargetValue();
+        }
+       #endif
     }
 
-    const String& getStateDefaultValue(const uint32_t index) const noexcept
+   #if DISTRHO_PLUGIN_WANT_DSP_LOAD
+    // budget is based on the host rate, so the cost of oversampling counts against the plugin
+    void addDspLoadBlock(const uint64_t elapsedTime, const uint32_t frames) noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->stateCount, sFallbackString);
+       #if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+        const double hostSampleRate = fData->sampleRate / fData->oversamplingFactor;
+       #else
+        const double hostSampleRate = fData->sampleRate;
+       #endif
 
-        return fData->states[index].defaultValue;
+        fData->dspLoadMeter.addBlock(elapsedTime, frames, hostSampleRate);
     }
+   #endif
 
-    const String& getStateLabel(const uint32_t index) const noexcept
+    // highest buffer size the plugin can see, big enough for any oversampling factor so changing it never reallocates
+    uint32_t getMaxPluginBufferSize() const noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->stateCount, sFallbackString);
-
-        return fData->states[index].label;
+       #if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+        return std::max(1u, fData->bufferSize / fData->oversamplingFactor * 8);
+       #else
+        return std::max(1u, fData->bufferSize);
+       #endif
     }
 
-    const String& getStateDescription(const uint32_t index) const noexcept
+    void resizeScratchArena()
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->stateCount, sFallbackString);
+       #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+        const std::size_t sampleSize = sizeof(double);
+       #else
+        const std::size_t sampleSize = sizeof(float);
+       #endif
+        // host buffer size can be bigger than the plugin one when using a fixed block size
+        const std::size_t frames = std::max(getMaxPluginBufferSize(), getBufferSize());
+        const std::size_t bufferSize = (frames * sampleSize + PluginScratchArena::kAlignment - 1)
+                                     & ~(PluginScratchArena::kAlignment - 1);
 
-        return fData->states[index].description;
+        fData->scratchArena.resize(bufferSize * kWrapperScratchBufferCount,
+                                   bufferSize * DISTRHO_PLUGIN_SCRATCH_BUFFER_COUNT);
     }
 
-   #ifdef __MOD_DEVICES__
-    const String& getStateFileTypes(const uint32_t index) const noexcept
+   #if DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS
+    uint32_t* fPendingBatchIndexes;
+    float* fPendingBatchValues;
+
+    // hand all pending values to the plugin as a single batch, in parameter order
+    void applyPendingParameterValues()
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->stateCount, sFallbackString);
+        uint32_t pendingCount = 0;
 
-        return fData->states[index].fileTypes;
+        for (uint32_t w=0, count=(fData->parameterCount + 31) / 32; w < count; ++w)
+        {
+            uint32_t bits = fData->pendingParameters[w].exchange(0, std::memory_order_acquire);
+
+            while (bits != 0)
+            {
+               #ifdef __GNUC__
+                const uint32_t bit = static_cast<uint32_t>(__builtin_ctz(bits));
+               #else
+                uint32_t bit = 0;
+                while ((bits & (1u << bit)) == 0)
+                    ++bit;
+               #endif
+
+                bits &= bits - 1;
+
+                const uint32_t index = w * 32 + bit;
+                fPendingBatchIndexes[pendingCount] = index;
+                fPendingBatchValues[pendingCount] = fData->pendingParameterValues[index].load(std::memory_order_relaxed);
+                ++pendingCount;
+            }
+        }
+
+        if (pendingCount != 0)
+            setPluginParameterValues(fPendingBatchIndexes, fPendingBatchValues, pendingCount);
     }
    #endif
 
-   #if DISTRHO_PLUGIN_WANT_FULL_STATE
-    String getStateValue(const char* const key) const
+    void setPluginParameterValue(const uint32_t index, const float value)
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, sFallbackString);
-        DISTRHO_SAFE_ASSERT_RETURN(key != nullptr && key[0] != '\0', sFallbackString);
+       #ifdef DPF_TRACING
+        if (fTrace != nullptr)
+            fTrace->addEvent(PluginTraceRecord::kTypeParameter, index, value);
+       #endif
 
-        return fPlugin->getState(key);
+       #if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+        if (fData->parameterRamps != nullptr && fData->parameterRamps[index] != nullptr)
+            fParameterSmoothers[index].setTargetValue(value);
+       #endif
+
+        fPlugin->setParameterValue(index, value);
     }
-   #endif
 
-    void setState(const char* const key, const char* const value)
+    void setPluginParameterValues(const uint32_t* const indexes, const float* const values, const uint32_t count)
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
-        DISTRHO_SAFE_ASSERT_RETURN(key != nullptr && key[0] != '\0',);
-        DISTRHO_SAFE_ASSERT_RETURN(value != nullptr,);
+       #ifdef DPF_TRACING
+        if (fTrace != nullptr)
+        {
+            for (uint32_t i=0; i < count; ++i)
+                fTrace->addEvent(PluginTraceRecord::kTypeParameter, indexes[i], values[i]);
+        }
+       #endif
 
-        fPlugin->setState(key, value);
+       #if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+        if (fData->parameterRamps != nullptr)
+        {
+            for (uint32_t i=0; i < count; ++i)
+            {
+                if (fData->parameterRamps[indexes[i]] != nullptr)
+                    fParameterSmoothers[indexes[i]].setTargetValue(values[i]);
+            }
+        }
+       #endif
+
+        fPlugin->setParameterValues(indexes, values, count);
     }
 
-    bool wantStateKey(const char* const key) const noexcept
+   #if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+    // -------------------------------------------------------------------
+    // Parameter smoothing, one ramp buffer per smoothed parameter
+
+    PluginParameterSmoother* fParameterSmoothers;
+    uint32_t fParameterRampSize;
+
+    void resizeParameterRamps()
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, false);
-        DISTRHO_SAFE_ASSERT_RETURN(key != nullptr && key[0] != '\0', false);
+        if (fData->parameterRamps == nullptr)
+            return;
 
-        for (uint32_t i=0; i < fData->stateCount; ++i)
+        const uint32_t size = getMaxPluginBufferSize();
+
+        if (fParameterRampSize == size)
+            return;
+
+        fParameterRampSize = size;
+
+        for (uint32_t i=0, count=fData->parameterCount; i < count; ++i)
         {
-            if (fData->states[i].key == key)
-                return true;
+            if (fData->parameterRamps[i] == nullptr)
+                continue;
+
+            delete[] fData->parameterRamps[i];
+            fData->parameterRamps[i] = new float[size];
         }
+    }
 
-        return false;
+    void updateParameterSmoothingLengths() noexcept
+    {
+        if (fData->parameterRamps == nullptr)
+            return;
+
+        for (uint32_t i=0, count=fData->parameterCount; i < count; ++i)
+        {
+            if (fData->parameterRamps[i] == nullptr)
+                continue;
+
+            const float smoothingTime = std::max(0.f, fData->parameters[i].smoothingTime);
+            fParameterSmoothers[i].length = static_cast<uint32_t>(smoothingTime * fData->sampleRate + 0.5);
+        }
     }
-#endif
 
-#if DISTRHO_PLUGIN_WANT_TIMEPOS
-    void setTimePosition(const TimePosition& timePosition) noexcept
+    // runs in blocks of at most fParameterRampSize frames ensure the buffers are big enough
+    void fillParameterRamps(const uint32_t frames) noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
+        if (fData->parameterRamps == nullptr)
+            return;
 
-        std::memcpy(&fData->timePosition, &timePosition, sizeof(TimePosition));
+        for (uint32_t i=0, count=fData->parameterCount; i < count; ++i)
+        {
+            if (fData->parameterRamps[i] != nullptr)
+                fParameterSmoothers[i].fill(fData->parameterRamps[i], frames);
+        }
     }
-#endif
+   #endif
 
+   #if DISTRHO_PLUGIN_WANT_OVERSAMPLING
     // -------------------------------------------------------------------
+    // Oversampling, running the plugin at a multiple of the host rate
 
-    bool isActive() const noexcept
+    PluginOversampler<float> fOversampler;
+   #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+    PluginOversampler<double> fOversampler64;
+   #endif
+   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+    MidiEvent fOversampledMidiEvents[kMaxMidiEvents];
+   #endif
+    // set on the audio thread when a block is too big to oversample, reported from the host side
+    std::atomic<uint32_t> fOversamplingOverflowFrames;
+
+    PluginOversampler<float>& getOversampler(const float*) noexcept
     {
-        return fIsActive;
+        return fOversampler;
     }
 
-    void activate()
+   #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+    PluginOversampler<double>& getOversampler(const double*) noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
-        DISTRHO_SAFE_ASSERT_RETURN(! fIsActive,);
+        return fOversampler64;
+    }
+   #endif
 
-        fIsActive = true;
-        fPlugin->activate();
+    // warn about blocks that were too big to oversample, from the host side
+    void reportOversamplingOverflowIfNeeded()
+    {
+        if (const uint32_t frames = fOversamplingOverflowFrames.exchange(0, std::memory_order_relaxed))
+            d_stderr2("DPF warning: cannot oversample %u frames, more than the buffer size %u",
+                      frames, fData->bufferSize / fData->oversamplingFactor);
     }
 
-    void deactivate()
+    // apply a factor change requested by the plugin, reconfiguring it for the new rate.
+    // only called from host-side paths, never from the audio thread, as the plugin callbacks may allocate.
+    // changes made while active wait for the next deactivation.
+    void updateOversamplingFactorIfNeeded()
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
-        DISTRHO_SAFE_ASSERT_RETURN(fIsActive,);
+        const uint32_t factor = fData->nextOversamplingFactor;
+        const uint32_t oldFactor = fData->oversamplingFactor;
 
-        fIsActive = false;
-        fPlugin->deactivate();
+        if (factor == oldFactor)
+            return;
+
+        fData->oversamplingFactor = factor;
+        fData->bufferSize = fData->bufferSize / oldFactor * factor;
+        fData->sampleRate = fData->sampleRate / oldFactor * factor;
+
+        fOversampler.setFactor(factor);
+       #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+        fOversampler64.setFactor(factor);
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+        // ramp buffers are always big enough for the highest factor
+        updateParameterSmoothingLengths();
+       #endif
+
+        if (fIsActive) fPlugin->deactivate();
+        fPlugin->bufferSizeChanged(fData->bufferSize);
+        fPlugin->sampleRateChanged(fData->sampleRate);
+        if (fIsActive) fPlugin->activate();
     }
 
-    void deactivateIfNeeded()
+    // run the plugin between up and down sampling of its audio, with event frames scaled to match
+    template<typename T>
+    void runOversampled(const T** const inputs, T** const outputs, const uint32_t frames
+                       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+                        , const MidiEvent* const midiEvents, const uint32_t midiEventCount
+                       #endif
+                        )
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
+        PluginOversampler<T>& oversampler(getOversampler(static_cast<const T*>(nullptr)));
+        const uint32_t factor = fData->oversamplingFactor;
 
-        if (fIsActive)
+        if (frames > oversampler.getBufferSize())
         {
-            fIsActive = false;
-            fPlugin->deactivate();
+            // no printing on the audio thread, keep the first one for the host side to report
+            uint32_t noOverflow = 0;
+            fOversamplingOverflowFrames.compare_exchange_strong(noOverflow, frames, std::memory_order_relaxed);
+
+           #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+            // the block is skipped, but parameter changes must not pile up for the next one
+            for (uint32_t i=0; i < fParameterEventCount; ++i)
+                setPluginParameterValue(fParameterEvents[i].index, fParameterEvents[i].value);
+
+            fParameterEventCount = 0;
+           #endif
+
+           #if DISTRHO_PLUGIN_NUM_OUTPUTS != 0
+            for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_OUTPUTS; ++i)
+            {
+                if (outputs[i] != nullptr)
+                    std::memset(outputs[i], 0, sizeof(T) * frames);
+            }
+           #endif
+            return;
         }
-    }
 
-   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-    void run(const float** const inputs, float** const outputs, const uint32_t frames,
-             const MidiEvent* const midiEvents, const uint32_t midiEventCount)
-    {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
+        const T** const pluginInputs = oversampler.upsample(inputs, frames);
+        T** const pluginOutputs = oversampler.getOutputs();
+        const uint32_t pluginFrames = frames * factor;
 
-        if (! fIsActive)
+       #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+        for (uint32_t i=0; i < fParameterEventCount; ++i)
+            fParameterEvents[i].frame *= factor;
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        for (uint32_t i=0; i < midiEventCount; ++i)
         {
-            fIsActive = true;
-            fPlugin->activate();
+            std::memcpy(&fOversampledMidiEvents[i], &midiEvents[i], sizeof(MidiEvent));
+            fOversampledMidiEvents[i].frame *= factor;
         }
 
-        fData->isProcessing = true;
-        fPlugin->run(inputs, outputs, frames, midiEvents, midiEventCount);
-        fData->isProcessing = false;
+        runPluginSplit(pluginInputs, pluginOutputs, pluginFrames, fOversampledMidiEvents, midiEventCount);
+       #else
+        runPluginSplit(pluginInputs, pluginOutputs, pluginFrames);
+       #endif
+
+        oversampler.downsample(outputs, frames);
     }
-   #else
-    void run(const float** const inputs, float** const outputs, const uint32_t frames)
+   #endif
+
+   #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+    // -------------------------------------------------------------------
+    // Fixed block size, buffering host audio and MIDI until a full block is ready
+
+    uint32_t fHostBufferSize;
+    uint32_t fFixedBlockPosition;
+    PluginFixedBlock<float> fFixedBlock;
+   #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+    PluginFixedBlock<double> fFixedBlock64;
+   #endif
+   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+    uint32_t fFixedBlockMidiEventCount;
+    MidiEvent fFixedBlockMidiEvents[kMaxMidiEvents];
+   #endif
+   #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
+    uint32_t fFixedBlockMidiOutputIndex;
+   #endif
+
+    PluginFixedBlock<float>& getFixedBlock(const float*) noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
+        return fFixedBlock;
+    }
 
-        if (! fIsActive)
+   #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+    PluginFixedBlock<double>& getFixedBlock(const double*) noexcept
+    {
+        return fFixedBlock64;
+    }
+   #endif
+
+    // start again from silence, called on activation
+    void resetFixedBlock() noexcept
+    {
+        fFixedBlockPosition = 0;
+        fFixedBlock.clear();
+       #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+        fFixedBlock64.clear();
+       #endif
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        fFixedBlockMidiEventCount = 0;
+       #endif
+       #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
+        fData->blockMidiOutputCount = 0;
+        fFixedBlockMidiOutputIndex = 0;
+       #endif
+    }
+
+    // feed host audio and MIDI into the FIFO, running the plugin each time a full block is collected.
+    // host output comes from the previous block, which delays everything by exactly kFixedBlockSize frames.
+    template<typename T>
+    void runInFixedBlocks(const T** const inputs, T** const outputs, const uint32_t frames
+                         #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+                          , const MidiEvent* const midiEvents, const uint32_t midiEventCount
+                         #endif
+                          )
+    {
+        PluginFixedBlock<T>& block(getFixedBlock(static_cast<const T*>(nullptr)));
+
+       #if DISTRHO_PLUGIN_WANT_TIMEPOS
+        const uint64_t timePositionFrame = fData->timePosition.frame;
+       #endif
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        uint32_t midiEventIndex = 0;
+       #endif
+       #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+        // changes are applied between blocks, so the plugin runs are never split
+        const uint32_t parameterEventCount = fParameterEventCount;
+        uint32_t eventIndex = 0;
+        fParameterEventCount = 0;
+       #endif
+
+        for (uint32_t offset = 0; offset < frames;)
         {
-            fIsActive = true;
-            fPlugin->activate();
+            const uint32_t pos = fFixedBlockPosition;
+            const uint32_t count = std::min(frames - offset, kFixedBlockSize - pos);
+
+            // read all input before writing output, host buffers might be shared
+           #if DISTRHO_PLUGIN_NUM_INPUTS != 0
+            for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_INPUTS; ++i)
+            {
+                if (inputs[i] != nullptr)
+                    std::memcpy(block.inputs[i] + pos, inputs[i] + offset, sizeof(T) * count);
+                else
+                    std::memset(block.inputs[i] + pos, 0, sizeof(T) * count);
+            }
+           #endif
+           #if DISTRHO_PLUGIN_NUM_OUTPUTS != 0
+            for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_OUTPUTS; ++i)
+            {
+                if (outputs[i] != nullptr)
+                    std::memcpy(outputs[i] + offset, block.outputs[i] + pos, sizeof(T) * count);
+            }
+           #endif
+
+           #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+            for (; midiEventIndex < midiEventCount && midiEvents[midiEventIndex].frame < offset + count; ++midiEventIndex)
+            {
+                const MidiEvent& midiEvent(midiEvents[midiEventIndex]);
+
+                // external data is only valid during this host run, cannot keep it around
+                if (midiEvent.size > MidiEvent::kDataSize || fFixedBlockMidiEventCount == kMaxMidiEvents)
+                    continue;
+
+                MidiEvent& blockMidiEvent(fFixedBlockMidiEvents[fFixedBlockMidiEventCount++]);
+                std::memcpy(&blockMidiEvent, &midiEvent, sizeof(MidiEvent));
+                blockMidiEvent.frame = pos + (midiEvent.frame > offset ? midiEvent.frame - offset : 0);
+            }
+           #endif
+
+           #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
+            // MIDI written during the previous block, played along with its audio
+            for (; fFixedBlockMidiOutputIndex < fData->blockMidiOutputCount; ++fFixedBlockMidiOutputIndex)
+            {
+                const MidiEvent& blockMidiEvent(fData->blockMidiOutputEvents[fFixedBlockMidiOutputIndex]);
+
+                if (blockMidiEvent.frame >= pos + count && pos + count != kFixedBlockSize)
+                    break;
+
+                MidiEvent hostMidiEvent;
+                std::memcpy(&hostMidiEvent, &blockMidiEvent, sizeof(MidiEvent));
+                hostMidiEvent.frame = offset + std::min(count - 1, blockMidiEvent.frame > pos ? blockMidiEvent.frame - pos : 0);
+                fData->writeMidiCallbackFunc(fData->callbacksPtr, hostMidiEvent);
+            }
+           #endif
+
+            fFixedBlockPosition += count;
+            offset += count;
+
+            if (fFixedBlockPosition != kFixedBlockSize)
+                continue;
+
+           #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+            for (; eventIndex < parameterEventCount && fParameterEvents[eventIndex].frame < offset; ++eventIndex)
+                setPluginParameterValue(fParameterEvents[eventIndex].index, fParameterEvents[eventIndex].value);
+           #endif
+           #if DISTRHO_PLUGIN_WANT_TIMEPOS
+            // the block began kFixedBlockSize frames ago
+            fData->timePosition.frame = timePositionFrame + offset >= kFixedBlockSize
+                                      ? timePositionFrame + offset - kFixedBlockSize
+                                      : 0;
+           #endif
+           #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
+            fData->blockMidiOutputCount = 0;
+            fFixedBlockMidiOutputIndex = 0;
+           #endif
+
+           #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+            runPlugin(block.inputPtrs, block.outputPtrs, kFixedBlockSize, fFixedBlockMidiEvents, fFixedBlockMidiEventCount);
+            fFixedBlockMidiEventCount = 0;
+           #else
+            runPlugin(block.inputPtrs, block.outputPtrs, kFixedBlockSize);
+           #endif
+
+            fFixedBlockPosition = 0;
         }
 
-        fData->isProcessing = true;
-        fPlugin->run(inputs, outputs, frames);
-        fData->isProcessing = false;
+       #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+        // changes after the last full block
+        for (; eventIndex < parameterEventCount; ++eventIndex)
+            setPluginParameterValue(fParameterEvents[eventIndex].index, fParameterEvents[eventIndex].value);
+       #endif
+       #if DISTRHO_PLUGIN_WANT_TIMEPOS
+        fData->timePosition.frame = timePositionFrame;
+       #endif
     }
    #endif
 
+   #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
     // -------------------------------------------------------------------
+    // Sample-accurate parameter changes, sorted by frame
 
-   #ifdef DISTRHO_PLUGIN_TARGET_AU
-    void setAudioPortIO(const uint16_t numInputs, const uint16_t numOutputs)
-    {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
+    struct ParameterEvent {
+        uint32_t frame;
+        uint32_t index;
+        float value;
+    };
 
-        if (fIsActive) fPlugin->deactivate();
-        fPlugin->ioChanged(numInputs, numOutputs);
-        if (fIsActive) fPlugin->activate();
-    }
+    uint32_t fParameterEventCount;
+    ParameterEvent fParameterEvents[kMaxParameterEvents];
    #endif
 
-    // -------------------------------------------------------------------
+   #if DPF_PLUGIN_RUN_IN_BLOCKS
+   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+    MidiEvent fSplitMidiEvents[kMaxMidiEventsPerRun];
+   #endif
 
-    uint32_t getBufferSize() const noexcept
+    bool needsToRunInBlocks(const uint32_t frames, const uint32_t midiEventCount) const noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0);
-        return fData->bufferSize;
+       #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+        if (fParameterEventCount != 0)
+            return true;
+       #endif
+       #if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+        if (frames > fParameterRampSize && fData->parameterRamps != nullptr)
+            return true;
+       #else
+        // unused
+        (void)frames;
+       #endif
+       #if DPF_PLUGIN_SPLIT_MIDI_EVENTS
+        if (midiEventCount > kMaxMidiEventsPerRun)
+            return true;
+       #else
+        // unused
+        (void)midiEventCount;
+       #endif
+        return false;
     }
 
-    double getSampleRate() const noexcept
-    {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0.0);
-        return fData->sampleRate;
-    }
+    // run the plugin in smaller blocks, split at each parameter change point,
+    // wherever there are more MIDI events than a single run can take
+    // and when the host gives more frames than fit in the parameter ramp buffers
+    template<typename T>
+    void runInBlocks(const T** const inputs, T** const outputs, const uint32_t frames
+                    #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+                     , const MidiEvent* const midiEvents, const uint32_t midiEventCount
+                    #endif
+                     )
+    {
+       #if DISTRHO_PLUGIN_NUM_INPUTS != 0
+        const T* splitInputs[DISTRHO_PLUGIN_NUM_INPUTS];
+       #else
+        const T** const splitInputs = inputs;
+       #endif
+       #if DISTRHO_PLUGIN_NUM_OUTPUTS != 0
+        T* splitOutputs[DISTRHO_PLUGIN_NUM_OUTPUTS];
+       #else
+        T** const splitOutputs = outputs;
+       #endif
+       #if DISTRHO_PLUGIN_WANT_TIMEPOS
+        const uint64_t timePositionFrame = fData->timePosition.frame;
+       #endif
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        uint32_t midiEventIndex = 0;
+       #endif
+       #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+        uint32_t eventIndex = 0;
+       #endif
+
+        for (uint32_t offset = 0; offset < frames;)
+        {
+            uint32_t end = frames;
 
-    bool setBufferSize(const uint32_t bufferSize, const bool doCallback = false)
-    {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, false);
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, false);
-        DISTRHO_SAFE_ASSERT(bufferSize >= 2);
+           #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+            for (; eventIndex < fParameterEventCount && fParameterEvents[eventIndex].frame <= offset; ++eventIndex)
+                setPluginParameterValue(fParameterEvents[eventIndex].index, fParameterEvents[eventIndex].value);
 
-        if (fData->bufferSize == bufferSize)
-            return false;
+            if (eventIndex < fParameterEventCount)
+                end = std::min(frames, fParameterEvents[eventIndex].frame);
+           #endif
 
-        fData->bufferSize = bufferSize;
+           #if DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING
+            if (fData->parameterRamps != nullptr)
+                end = std::min(end, offset + fParameterRampSize);
+           #endif
 
-        if (doCallback)
-        {
-            if (fIsActive) fPlugin->deactivate();
-            fPlugin->bufferSizeChanged(bufferSize);
-            if (fIsActive) fPlugin->activate();
-        }
+           #if DPF_PLUGIN_SPLIT_MIDI_EVENTS
+            // stop right before the first event that does not fit,
+            // if that event is on the current frame we do a zero-length run with only MIDI events
+            if (midiEventCount - midiEventIndex > kMaxMidiEventsPerRun)
+                end = std::min(end, std::max(offset, midiEvents[midiEventIndex + kMaxMidiEventsPerRun].frame));
+           #endif
 
-        return true;
-    }
+           #if DISTRHO_PLUGIN_NUM_INPUTS != 0
+            for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_INPUTS; ++i)
+                splitInputs[i] = inputs[i] != nullptr ? inputs[i] + offset : nullptr;
+           #endif
+           #if DISTRHO_PLUGIN_NUM_OUTPUTS != 0
+            for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_OUTPUTS; ++i)
+                splitOutputs[i] = outputs[i] != nullptr ? outputs[i] + offset : nullptr;
+           #endif
+           #if DISTRHO_PLUGIN_WANT_TIMEPOS
+           #if DISTRHO_PLUGIN_WANT_OVERSAMPLING
+            fData->timePosition.frame = timePositionFrame + offset / fData->oversamplingFactor;
+           #else
+            fData->timePosition.frame = timePositionFrame + offset;
+           #endif
+           #endif
+           #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
+            fData->midiOutputFrameOffset = offset;
+           #endif
 
-    void setSampleRate(const double sampleRate, const bool doCallback = false)
-    {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
-        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
-        DISTRHO_SAFE_ASSERT(sampleRate > 0.0);
+           #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+            // events are sorted by frame, first block can use them as-is
+            const MidiEvent* splitMidiEvents;
+            uint32_t splitMidiEventCount = 0;
 
-        if (d_isEqual(fData->sampleRate, sampleRate))
-            return;
+            // a zero-length run always takes as many events as it can, so the loop keeps going
+            const bool midiOnlyRun = end == offset;
 
-        fData->sampleRate = sampleRate;
+            if (offset == 0)
+            {
+                // zero-length runs can come back here with some events already delivered
+                splitMidiEvents = midiEvents + midiEventIndex;
+                while (midiEventIndex < midiEventCount && splitMidiEventCount < kMaxMidiEventsPerRun
+                       && (midiOnlyRun || midiEvents[midiEventIndex].frame < end))
+                    ++midiEventIndex, ++splitMidiEventCount;
+            }
+            else
+            {
+                splitMidiEvents = fSplitMidiEvents;
+                for (; midiEventIndex < midiEventCount && splitMidiEventCount < kMaxMidiEventsPerRun
+                       && (midiOnlyRun || midiEvents[midiEventIndex].frame < end); ++midiEventIndex)
+                {
+                    MidiEvent& midiEvent(fSplitMidiEvents[splitMidiEventCount++]);
+                    std::memcpy(&midiEvent, &midiEvents[midiEventIndex], sizeof(MidiEvent));
+                    midiEvent.frame = midiEvent.frame > offset ? midiEvent.frame - offset : 0;
+                }
+            }
 
-        if (doCallback)
-        {
-            if (fIsActive) fPlugin->deactivate();
-            fPlugin->sampleRateChanged(sampleRate);
-            if (fIsActive) fPlugin->activate();
+            runPluginBlock(splitInputs, splitOutputs, end - offset, splitMidiEvents, splitMidiEventCount);
+           #else
+            runPluginBlock(splitInputs, splitOutputs, end - offset);
+           #endif
+
+            offset = end;
         }
-    }
 
-private:
-    // -------------------------------------------------------------------
-    // Plugin and DistrhoPlugin data
+       #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+        // changes at or past the end of this block
+        for (; eventIndex < fParameterEventCount; ++eventIndex)
+            setPluginParameterValue(fParameterEvents[eventIndex].index, fParameterEvents[eventIndex].value);
 
-    Plugin* const fPlugin;
-    Plugin::PrivateData* const fData;
-    bool fIsActive;
+        fParameterEventCount = 0;
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_TIMEPOS
+        fData->timePosition.frame = timePositionFrame;
+       #endif
+       #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
+        fData->midiOutputFrameOffset = 0;
+       #endif
+    }
+   #endif
+
+   #if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+    // triggers set by the host need to be reset after run, mark them the same way as outputs
+    void markTriggerParameterIfChanged(const uint32_t index, const float value) noexcept
+    {
+        if ((fParameterTable->hints[index] & kParameterIsTrigger) == kParameterIsTrigger
+            && d_isNotEqual(value, fParameterTable->defaults[index]))
+            fData->markParameterChanged(index);
+    }
+   #endif
 
     // -------------------------------------------------------------------
     // Static fallback data, see DistrhoPlugin.cpp
@@ -92,6 +92,10 @@ static const requestParameterValueChangeFunc requestParameterValueChangeCallback
 
 static volatile bool gCloseSignalReceived = false;
 
+#if DISTRHO_PLUGIN_WANT_DSP_LOAD
+static volatile bool gDspLoadRequested = false;
+#endif
+
 #ifdef DISTRHO_OS_WINDOWS
 static BOOL WINAPI winSignalHandler(DWORD dwCtrlType) noexcept
 {
@@ -113,6 +117,13 @@ static void closeSignalHandler(int) noexcept
     gCloseSignalReceived = true;
 }
 
+# if DISTRHO_PLUGIN_WANT_DSP_LOAD
+static void dspLoadSignalHandler(int) noexcept
+{
+    gDspLoadRequested = true;
+}
+# endif
+
 static void initSignalHandler()
 {
     struct sigaction sig;
@@ -123,6 +134,12 @@ static void initSignalHandler()
     sigemptyset(&sig.sa_mask);
     sigaction(SIGINT, &sig, nullptr);
     sigaction(SIGTERM, &sig, nullptr);
+
+   #if DISTRHO_PLUGIN_WANT_DSP_LOAD
+    // print DSP load statistics on request, with `kill -USR1 <pid>`
+    sig.sa_handler = dspLoadSignalHandler;
+    sigaction(SIGUSR1, &sig, nullptr);
+   #endif
 }
 #endif
 
@@ -251,7 +268,12 @@ public:
         fUI.exec(this);
        #else
         while (! gCloseSignalReceived)
+        {
             d_sleep(1);
+           #if DISTRHO_PLUGIN_WANT_DSP_LOAD
+            printDspLoadIfRequested();
+           #endif
+        }
 
         // unused
         (void)winId;
@@ -318,6 +340,10 @@ protected:
         if (gCloseSignalReceived)
             return fUI.quit();
 
+       #if DISTRHO_PLUGIN_WANT_DSP_LOAD
+        printDspLoadIfRequested();
+       #endif
+
 # if DISTRHO_PLUGIN_WANT_PROGRAMS
         if (fProgramChanged >= 0)
         {
@@ -328,6 +354,7 @@ protected:
 
         for (uint32_t i=0, count=fPlugin.getParameterCount(); i < count; ++i)
         {
+           #if ! DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
             if (fPlugin.isParameterOutput(i))
             {
                 const float value = fPlugin.getParameterValue(i);
@@ -338,7 +365,9 @@ protected:
                 fLastOutputValues[i] = value;
                 fUI.parameterChanged(i, value);
             }
-            else if (fParametersChanged[i])
+            else
+           #endif
+            if (fParametersChanged[i])
             {
                 fParametersChanged[i] = false;
                 fUI.parameterChanged(i, fPlugin.getParameterValue(i));
@@ -361,6 +390,10 @@ protected:
 
     void jackProcess(const jack_nframes_t nframes)
     {
+#ifdef DPF_RT_SAFETY_CHECKS
+        const ScopedRealtimeThread srt;
+#endif
+
 #if DISTRHO_PLUGIN_NUM_INPUTS > 0
         const float* audioIns[DISTRHO_PLUGIN_NUM_INPUTS];
 
@@ -478,7 +511,7 @@ protected:
                             continue;
 
                         const float scaled = static_cast<float>(value)/127.0f;
-                        const float fvalue = fPlugin.getParameterRanges(j).getUnnormalizedValue(scaled);
+                        const float fvalue = fPlugin.getUnnormalizedParameterValue(j, scaled);
                         fPlugin.setParameterValue(j, fvalue);
 #if DISTRHO_PLUGIN_HAS_UI
                         fParametersChanged[j] = true;
@@ -541,6 +574,10 @@ protected:
 #if DISTRHO_PLUGIN_HAS_UI
     void setParameterValue(const uint32_t index, const float value)
     {
+       #ifdef DPF_TRACING
+        fPlugin.traceUiMessage("parameter");
+       #endif
+
         fPlugin.setParameterValue(index, value);
     }
 
@@ -551,6 +588,11 @@ protected:
         midiData[0] = (velocity != 0 ? 0x90 : 0x80) | channel;
         midiData[1] = note;
         midiData[2] = velocity;
+
+       #ifdef DPF_TRACING
+        fPlugin.traceUiMessage("note");
+       #endif
+
         fNotesRingBuffer.writeCustomData(midiData, 3);
         fNotesRingBuffer.commitWrite("PluginJack::sendNote");
     }
@@ -559,22 +601,57 @@ protected:
 # if DISTRHO_PLUGIN_WANT_STATE
     void setState(const char* const key, const char* const value)
     {
+       #ifdef DPF_TRACING
+        fPlugin.traceUiMessage("state");
+       #endif
+
         fPlugin.setState(key, value);
     }
 # endif
 #endif // DISTRHO_PLUGIN_HAS_UI
 
+#if DISTRHO_PLUGIN_WANT_DSP_LOAD
+    void printDspLoadIfRequested()
+    {
+        if (! gDspLoadRequested)
+            return;
+
+        gDspLoadRequested = false;
+
+        const DspLoad dspLoad(fPlugin.getDspLoad());
+        d_stdout("DSP load over the last %u blocks: min %.1f%%, avg %.1f%%, p99 %.1f%%, max %.1f%%",
+                 dspLoad.blockCount,
+                 dspLoad.minimum * 100.0,
+                 dspLoad.average * 100.0,
+                 dspLoad.p99 * 100.0,
+                 dspLoad.maximum * 100.0);
+    }
+#endif
+
     // NOTE: no trigger support for JACK, simulate it here
     void updateParameterTriggers()
     {
         float defValue;
 
+       #if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+        for (uint32_t i=0; fPlugin.getNextChangedParameter(i); ++i)
+        {
+            // changed outputs are picked up by the UI idle callback
+            if (fPlugin.isParameterOutput(i))
+            {
+               #if DISTRHO_PLUGIN_HAS_UI
+                fParametersChanged[i] = true;
+               #endif
+                continue;
+            }
+       #else
         for (uint32_t i=0, count=fPlugin.getParameterCount(); i < count; ++i)
         {
+       #endif
             if ((fPlugin.getParameterHints(i) & kParameterIsTrigger) != kParameterIsTrigger)
                 continue;
 
-            defValue = fPlugin.getParameterRanges(i).def;
+            defValue = fPlugin.getParameterDefault(i);
 
             if (d_isNotEqual(defValue, fPlugin.getParameterValue(i)))
                 fPlugin.setParameterValue(i, defValue);
@@ -394,7 +394,7 @@ private:
             else if ((fPlugin.getParameterHints(i) & kParameterIsTrigger) == kParameterIsTrigger)
             {
                 // NOTE: no trigger support in LADSPA control ports, simulate it here
-                value = fPlugin.getParameterRanges(i).def;
+                value = fPlugin.getParameterDefault(i);
 
                 if (d_isEqual(value, fPlugin.getParameterValue(i)))
                     continue;
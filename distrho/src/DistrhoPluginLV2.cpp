@@ -83,6 +83,8 @@ public:
 #endif
           fPortControls(nullptr),
           fLastControlValues(nullptr),
+          fParameterBatchIndexes(nullptr),
+          fParameterBatchValues(nullptr),
           fSampleRate(sampleRate),
           fURIDs(uridMap),
 #if DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST
@@ -90,6 +92,10 @@ public:
 #endif
           fUridMap(uridMap),
           fWorker(worker)
+#if DISTRHO_PLUGIN_WANT_WORKER
+        , fWorkRespond(nullptr),
+          fWorkRespondHandle(nullptr)
+#endif
     {
 #if DISTRHO_PLUGIN_NUM_INPUTS > 0
         for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_INPUTS; ++i)
@@ -109,6 +115,8 @@ public:
         {
             fPortControls      = new float*[count];
             fLastControlValues = new float[count];
+            fParameterBatchIndexes = new uint32_t[count];
+            fParameterBatchValues  = new float[count];
 
             for (uint32_t i=0; i < count; ++i)
             {
@@ -128,6 +136,9 @@ public:
 #if DISTRHO_PLUGIN_WANT_LATENCY
         fPortLatency = nullptr;
 #endif
+#if DISTRHO_PLUGIN_WANT_OFFLINE_MODE
+        fPortFreewheel = nullptr;
+#endif
 
 #if DISTRHO_PLUGIN_WANT_STATE
         std::memset(&fAtomForge, 0, sizeof(fAtomForge));
@@ -155,11 +166,17 @@ public:
             fUrids = nullptr;
             fNeededUiSends = nullptr;
         }
-#else
+#elif ! DISTRHO_PLUGIN_WANT_WORKER
         // unused
         (void)fWorker;
 #endif
 
+#if DISTRHO_PLUGIN_WANT_WORKER
+        // prefer the host worker, DPF uses its own thread otherwise
+        if (fWorker != nullptr)
+            fPlugin.setWorkerCallbacks(this, scheduleWorkCallback, sendWorkResponseCallback);
+#endif
+
 #if ! DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST
         // unused
         (void)ctrlInPortChangeReq;
@@ -180,6 +197,18 @@ public:
             fLastControlValues = nullptr;
         }
 
+        if (fParameterBatchIndexes != nullptr)
+        {
+            delete[] fParameterBatchIndexes;
+            fParameterBatchIndexes = nullptr;
+        }
+
+        if (fParameterBatchValues != nullptr)
+        {
+            delete[] fParameterBatchValues;
+            fParameterBatchValues = nullptr;
+        }
+
 #if DISTRHO_PLUGIN_WANT_STATE
         if (fNeededUiSends != nullptr)
         {
@@ -317,15 +346,33 @@ public:
             if (port == index++)
             {
                 fPortControls[i] = (float*)dataLocation;
+               #if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+                // new buffer, make sure the current output value is written on next run
+                if (fPlugin.isParameterOutput(i))
+                    fPlugin.markParameterChanged(i);
+               #endif
                 return;
             }
         }
+
+#if DISTRHO_PLUGIN_WANT_OFFLINE_MODE
+        if (port == index++)
+        {
+            fPortFreewheel = (const float*)dataLocation;
+            return;
+        }
+#endif
     }
 
     // -------------------------------------------------------------------
 
     void lv2_run(const uint32_t sampleCount)
     {
+#if DISTRHO_PLUGIN_WANT_OFFLINE_MODE
+        if (fPortFreewheel != nullptr)
+            fPlugin.setOffline(*fPortFreewheel > 0.5f, true);
+#endif
+
         // cache midi input and time position first
 #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
         uint32_t midiEventCount = 0;
@@ -566,6 +613,10 @@ public:
             {
                 const void* const data = (const void*)(event + 1);
 
+               #ifdef DPF_TRACING
+                fPlugin.traceUiMessage("state");
+               #endif
+
                 // check if this is our special message
                 if (std::strcmp((const char*)data, "__dpf_ui_data__") == 0)
                 {
@@ -601,8 +652,9 @@ public:
         }
 #endif
 
-        // Check for updated parameters
+        // Check for updated parameters, and send them to the plugin as a single batch
         float curValue;
+        uint32_t changedCount = 0;
 
         for (uint32_t i=0, count=fPlugin.getParameterCount(); i < count; ++i)
         {
@@ -613,10 +665,14 @@ public:
             {
                 fLastControlValues[i] = curValue;
 
-                fPlugin.setParameterValue(i, curValue);
+                fParameterBatchIndexes[changedCount] = i;
+                fParameterBatchValues[changedCount] = curValue;
+                ++changedCount;
             }
         }
 
+        fPlugin.setParameterValues(fParameterBatchIndexes, fParameterBatchValues, changedCount);
+
         // Run plugin
         if (sampleCount != 0)
         {
@@ -1101,12 +1157,34 @@ public:
         return LV2_STATE_SUCCESS;
     }
 
+   #endif
+
+   #if DISTRHO_PLUGIN_WANT_STATE || DISTRHO_PLUGIN_WANT_WORKER
     // -------------------------------------------------------------------
 
-    LV2_Worker_Status lv2_work(const void* const data)
+    LV2_Worker_Status lv2_work(const LV2_Worker_Respond_Function respond,
+                               const LV2_Worker_Respond_Handle handle,
+                               const void* const data)
     {
         const LV2_Atom* const eventBody = (const LV2_Atom*)data;
 
+       #if DISTRHO_PLUGIN_WANT_WORKER
+        if (eventBody->type == fURIDs.dpfWork)
+        {
+            fWorkRespond = respond;
+            fWorkRespondHandle = handle;
+            fPlugin.work(eventBody + 1, eventBody->size);
+            fWorkRespond = nullptr;
+            fWorkRespondHandle = nullptr;
+            return LV2_WORKER_SUCCESS;
+        }
+       #else
+        // unused
+        (void)respond;
+        (void)handle;
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_STATE
         if (eventBody->type == fURIDs.dpfKeyValue)
         {
             const char* const key   = (const char*)(eventBody + 1);
@@ -1154,12 +1232,20 @@ public:
 
             return LV2_WORKER_SUCCESS;
         }
+       #endif
 
         return LV2_WORKER_ERR_UNKNOWN;
     }
 
-    LV2_Worker_Status lv2_work_response(uint32_t, const void*)
+    LV2_Worker_Status lv2_work_response(const uint32_t size, const void* const body)
     {
+       #if DISTRHO_PLUGIN_WANT_WORKER
+        fPlugin.workResponse(body, size);
+       #else
+        // unused
+        (void)size;
+        (void)body;
+       #endif
         return LV2_WORKER_SUCCESS;
     }
    #endif
@@ -1201,9 +1287,14 @@ private:
    #if DISTRHO_PLUGIN_WANT_LATENCY
     float* fPortLatency;
    #endif
+   #if DISTRHO_PLUGIN_WANT_OFFLINE_MODE
+    const float* fPortFreewheel;
+   #endif
 
     // Temporary data
     float* fLastControlValues;
+    uint32_t* fParameterBatchIndexes;
+    float* fParameterBatchValues;
     double fSampleRate;
    #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
     MidiEvent fMidiEvents[kMaxMidiEvents];
@@ -1286,6 +1377,7 @@ private:
         LV2_URID atomString;
         LV2_URID atomURID;
         LV2_URID dpfKeyValue;
+        LV2_URID dpfWork;
         LV2_URID midiEvent;
         LV2_URID patchSet;
         LV2_URID patchProperty;
@@ -1313,6 +1405,7 @@ private:
               atomString(map(LV2_ATOM__String)),
               atomURID(map(LV2_ATOM__URID)),
               dpfKeyValue(map(DISTRHO_PLUGIN_LV2_STATE_PREFIX "KeyValueState")),
+              dpfWork(map(DISTRHO_PLUGIN_LV2_STATE_PREFIX "Work")),
               midiEvent(map(LV2_MIDI__MidiEvent)),
               patchSet(map(LV2_PATCH__Set)),
               patchProperty(map(LV2_PATCH__property)),
@@ -1340,6 +1433,16 @@ private:
     const LV2_URID_Map* const fUridMap;
     const LV2_Worker_Schedule* const fWorker;
 
+   #if DISTRHO_PLUGIN_WANT_WORKER
+    // scheduled work is sent to the host as an atom, so it can be told apart from state messages
+    struct {
+        LV2_Atom atom;
+        uint8_t data[kMaxWorkSize];
+    } fWorkMessage;
+    LV2_Worker_Respond_Function fWorkRespond;
+    LV2_Worker_Respond_Handle fWorkRespondHandle;
+   #endif
+
    #if DISTRHO_PLUGIN_WANT_STATE
     LV2_Atom_Forge fAtomForge;
     StringToStringMap fStateMap;
@@ -1364,22 +1467,21 @@ private:
         fPlugin.setState(key, newValue);
 
         // key must already exist
-        for (uint32_t i=0, count=fPlugin.getStateCount(); i < count; ++i)
+        uint32_t i;
+
+        if (! fPlugin.getStateIndexForKey(key, i))
         {
-            if (fPlugin.getStateKey(i) == key)
-            {
-                const String dkey(key);
-                fStateMap[dkey] = newValue;
+            d_stderr("Failed to find plugin state with key \"%s\"", key);
+            return false;
+        }
 
-                if ((fPlugin.getStateHints(i) & kStateIsOnlyForDSP) == 0x0)
-                    fNeededUiSends[i] = true;
+        const String dkey(key);
+        fStateMap[dkey] = newValue;
 
-                return true;
-            }
-        }
+        if ((fPlugin.getStateHints(i) & kStateIsOnlyForDSP) == 0x0)
+            fNeededUiSends[i] = true;
 
-        d_stderr("Failed to find plugin state with key \"%s\"", key);
-        return false;
+        return true;
     }
    #endif
 
@@ -1387,7 +1489,11 @@ private:
     {
         float curValue;
 
+       #if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+        for (uint32_t i=0; fPlugin.getNextChangedParameter(i); ++i)
+       #else
         for (uint32_t i=0, count=fPlugin.getParameterCount(); i < count; ++i)
+       #endif
         {
             if (fPlugin.isParameterOutput(i))
             {
@@ -1430,6 +1536,34 @@ private:
     }
    #endif
 
+   #if DISTRHO_PLUGIN_WANT_WORKER
+    bool scheduleWork(const void* const data, const uint32_t size)
+    {
+        fWorkMessage.atom.size = size;
+        fWorkMessage.atom.type = fURIDs.dpfWork;
+        std::memcpy(fWorkMessage.data, data, size);
+
+        return fWorker->schedule_work(fWorker->handle, sizeof(LV2_Atom) + size, &fWorkMessage) == LV2_WORKER_SUCCESS;
+    }
+
+    static bool scheduleWorkCallback(void* const ptr, const void* const data, const uint32_t size)
+    {
+        return ((PluginLv2*)ptr)->scheduleWork(data, size);
+    }
+
+    bool sendWorkResponse(const void* const data, const uint32_t size)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fWorkRespond != nullptr, false);
+
+        return fWorkRespond(fWorkRespondHandle, size, data) == LV2_WORKER_SUCCESS;
+    }
+
+    static bool sendWorkResponseCallback(void* const ptr, const void* const data, const uint32_t size)
+    {
+        return ((PluginLv2*)ptr)->sendWorkResponse(data, size);
+    }
+   #endif
+
    #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
     bool writeMidi(const MidiEvent& midiEvent)
     {
@@ -1619,10 +1753,12 @@ static LV2_State_Status lv2_restore(LV2_Handle instance, LV2_State_Retrieve_Func
 {
     return instancePtr->lv2_restore(retrieve, handle, features);
 }
+#endif
 
-LV2_Worker_Status lv2_work(LV2_Handle instance, LV2_Worker_Respond_Function, LV2_Worker_Respond_Handle, uint32_t, const void* data)
+#if DISTRHO_PLUGIN_WANT_STATE || DISTRHO_PLUGIN_WANT_WORKER
+LV2_Worker_Status lv2_work(LV2_Handle instance, LV2_Worker_Respond_Function respond, LV2_Worker_Respond_Handle handle, uint32_t, const void* data)
 {
-    return instancePtr->lv2_work(data);
+    return instancePtr->lv2_work(respond, handle, data);
 }
 
 LV2_Worker_Status lv2_work_response(LV2_Handle instance, uint32_t size, const void* body)
@@ -1658,10 +1794,14 @@ static const void* lv2_extension_data(const char* uri)
 
 #if DISTRHO_PLUGIN_WANT_STATE
     static const LV2_State_Interface state = { lv2_save, lv2_restore };
-    static const LV2_Worker_Interface worker = { lv2_work, lv2_work_response, nullptr };
 
     if (std::strcmp(uri, LV2_STATE__interface) == 0)
         return &state;
+#endif
+
+#if DISTRHO_PLUGIN_WANT_STATE || DISTRHO_PLUGIN_WANT_WORKER
+    static const LV2_Worker_Interface worker = { lv2_work, lv2_work_response, nullptr };
+
     if (std::strcmp(uri, LV2_WORKER__interface) == 0)
         return &worker;
 #endif
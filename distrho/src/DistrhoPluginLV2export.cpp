@@ -101,6 +101,8 @@ static constexpr const char* const lv2ManifestPluginExtensionData[] = {
     "opts:interface",
    #if DISTRHO_PLUGIN_WANT_STATE
     LV2_STATE__interface,
+   #endif
+   #if DISTRHO_PLUGIN_WANT_STATE || DISTRHO_PLUGIN_WANT_WORKER
     LV2_WORKER__interface,
    #endif
    #if DISTRHO_PLUGIN_WANT_PROGRAMS
@@ -120,6 +122,8 @@ static constexpr const char* const lv2ManifestPluginOptionalFeatures[] = {
    #if DISTRHO_PLUGIN_WANT_STATE
     LV2_STATE__mapPath,
     LV2_STATE__freePath,
+   #elif DISTRHO_PLUGIN_WANT_WORKER
+    LV2_WORKER__schedule,
    #endif
    #if DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST
     LV2_CONTROL_INPUT_PORT_CHANGE_REQUEST_URI,
@@ -166,6 +170,7 @@ static constexpr const char* const lv2ManifestUiOptionalFeatures[] = {
     "ui:parent",
     "ui:touch",
   #endif
+    "ui:portMap",
     "ui:requestValue",
     nullptr
 };
@@ -982,6 +987,21 @@ void lv2_generate_ttl(const char* const basename)
                 else
                     pluginString += "    ] ,\n";
             }
+
+#if DISTRHO_PLUGIN_WANT_OFFLINE_MODE
+            // placed after parameters so that existing port indexes do not change
+            pluginString += "    lv2:port [\n";
+            pluginString += "        a lv2:InputPort, lv2:ControlPort ;\n";
+            pluginString += "        lv2:index " + String(portIndex) + " ;\n";
+            pluginString += "        lv2:name \"Freewheel\" ;\n";
+            pluginString += "        lv2:symbol \"lv2_freewheel\" ;\n";
+            pluginString += "        lv2:default 0 ;\n";
+            pluginString += "        lv2:minimum 0 ;\n";
+            pluginString += "        lv2:maximum 1 ;\n";
+            pluginString += "        lv2:designation lv2:freeWheeling ;\n";
+            pluginString += "        lv2:portProperty lv2:toggled, <" LV2_PORT_PROPS__notOnGUI "> ;\n";
+            pluginString += "    ] ;\n\n";
+#endif
         }
 
         // comment
@@ -1354,6 +1374,9 @@ void lv2_generate_ttl(const char* const basename)
             if (plugin.getParameterDesignation(i) == kParameterDesignationBypass)
                 enabledIndex = i;
         }
+       #if DISTRHO_PLUGIN_WANT_OFFLINE_MODE
+        jsString += "'lv2_freewheel',";
+       #endif
         jsString += "];\n";
         jsString += "var ei=" + String(enabledIndex != INT32_MAX ? enabledIndex : -1) + ";\n\n";
         jsString += "if(e.type==='start'){\n";
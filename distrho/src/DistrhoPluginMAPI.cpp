@@ -66,7 +66,7 @@ public:
 
     void setParameter(unsigned int index, float value)
     {
-        fPlugin.setParameterValue(index, fPlugin.getParameterRanges(index).getUnnormalizedValue(value));
+        fPlugin.setParameterValue(index, fPlugin.getUnnormalizedParameterValue(index, value));
     }
 
    #if DISTRHO_PLUGIN_WANT_STATE
@@ -90,7 +90,7 @@ private:
             if ((fPlugin.getParameterHints(i) & kParameterIsTrigger) == kParameterIsTrigger)
             {
                 // NOTE: no trigger support in MAPI, simulate it here
-                value = fPlugin.getParameterRanges(i).def;
+                value = fPlugin.getParameterDefault(i);
 
                 if (d_isEqual(value, fPlugin.getParameterValue(i)))
                     continue;
@@ -0,0 +1,369 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef DISTRHO_PLUGIN_OVERSAMPLING_HPP_INCLUDED
+#define DISTRHO_PLUGIN_OVERSAMPLING_HPP_INCLUDED
+
+#include "../DistrhoUtils.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+// Oversampling constants
+
+static const uint32_t kMaxOversamplingFactor = 8;
+static const uint32_t kMaxOversamplingStages = 3;
+
+// Half-band lowpass with 47 taps, where only the 24 even taps and the center one are non-zero.
+// Each 2x stage splits it into 2 polyphase branches: the even taps and a pure delay through the center tap.
+static const uint32_t kHalfBandTaps = 24;
+static const uint32_t kHalfBandHistory = kHalfBandTaps - 1;
+static const uint32_t kHalfBandOddDelay = kHalfBandTaps / 2;
+
+// extra delay added to the last stage so that the total latency is a whole number of host samples
+static const uint32_t kMaxOversamplingExtraDelay = kMaxOversamplingFactor / 2 - 1;
+
+// -----------------------------------------------------------------------
+// Oversampler, used by PluginExporter to run the plugin at a higher sample rate
+
+template<typename T>
+class PluginOversampler
+{
+public:
+    PluginOversampler(const uint32_t numInputs, const uint32_t numOutputs) noexcept
+        : fNumInputs(numInputs),
+          fNumOutputs(numOutputs),
+          fInputs(new Channel[numInputs]),
+          fOutputs(new Channel[numOutputs]),
+          fInputBuffers(new const T*[numInputs]),
+          fOutputBuffers(new T*[numOutputs]),
+          fFactor(1),
+          fStageCount(0),
+          fExtraDelay(0),
+          fBufferSize(0),
+          fTempBuffer(nullptr),
+          fWorkBuffer(nullptr),
+          fPhaseBuffer(nullptr)
+    {
+        // windowed-sinc with a Blackman window, normalized for unity gain at DC
+        const uint32_t length = kHalfBandTaps * 2 - 1;
+        double coefficients[kHalfBandTaps];
+        double sum = 0.0;
+
+        for (uint32_t i=0; i<kHalfBandTaps; ++i)
+        {
+            const uint32_t k = i * 2;
+            const double m = static_cast<double>(k) - kHalfBandHistory;
+            const double w = static_cast<double>(k) / (length - 1);
+
+            coefficients[i] = std::sin(M_PI * m / 2) / (M_PI * m)
+                            * (0.42 - 0.5 * std::cos(2 * M_PI * w) + 0.08 * std::cos(4 * M_PI * w));
+            sum += coefficients[i];
+        }
+
+        // the even taps add up to 0.5, the other half comes from the center tap
+        for (uint32_t i=0; i<kHalfBandTaps; ++i)
+            fCoefficients[i] = static_cast<T>(coefficients[i] * 0.5 / sum);
+
+        reset();
+    }
+
+    ~PluginOversampler()
+    {
+        freeBuffers();
+        delete[] fInputs;
+        delete[] fOutputs;
+        delete[] fInputBuffers;
+        delete[] fOutputBuffers;
+    }
+
+    // allocate buffers for the maximum factor, so the factor can be changed while running
+    void setBufferSize(const uint32_t bufferSize)
+    {
+        if (fBufferSize == bufferSize)
+            return;
+
+        freeBuffers();
+        fBufferSize = bufferSize;
+
+        if (bufferSize == 0)
+            return;
+
+        const uint32_t maxSize = bufferSize * kMaxOversamplingFactor;
+        const uint32_t maxStageSize = maxSize / 2;
+
+        for (uint32_t i=0; i<fNumInputs; ++i)
+        {
+            fInputs[i].buffer = new T[maxSize];
+            fInputBuffers[i] = fInputs[i].buffer;
+        }
+
+        for (uint32_t i=0; i<fNumOutputs; ++i)
+        {
+            fOutputs[i].buffer = new T[maxSize];
+            fOutputBuffers[i] = fOutputs[i].buffer;
+        }
+
+        fTempBuffer = new T[maxStageSize];
+        fWorkBuffer = new T[maxStageSize + kHalfBandHistory + kMaxOversamplingExtraDelay];
+        fPhaseBuffer = new T[maxStageSize + kHalfBandOddDelay + kMaxOversamplingExtraDelay];
+    }
+
+    void setFactor(const uint32_t factor)
+    {
+        DISTRHO_SAFE_ASSERT_UINT_RETURN(isValidFactor(factor), factor,);
+
+        fFactor = factor;
+        fStageCount = getStageCount(factor);
+        fExtraDelay = getPadding(factor) / 2;
+        reset();
+    }
+
+    // clear the filter history, the next block starts from silence
+    void reset() noexcept
+    {
+        for (uint32_t i=0; i<fNumInputs; ++i)
+            std::memset(fInputs[i].stages, 0, sizeof(fInputs[i].stages));
+
+        for (uint32_t i=0; i<fNumOutputs; ++i)
+            std::memset(fOutputs[i].stages, 0, sizeof(fOutputs[i].stages));
+    }
+
+    uint32_t getBufferSize() const noexcept
+    {
+        return fBufferSize;
+    }
+
+    // upsample host inputs into the plugin-side buffers, returning them
+    const T** upsample(const T* const* const inputs, const uint32_t frames) noexcept
+    {
+        for (uint32_t c=0; c<fNumInputs; ++c)
+        {
+            const T* src = inputs[c];
+
+            if (src == nullptr)
+            {
+                std::memset(fTempBuffer, 0, sizeof(T) * frames);
+                src = fTempBuffer;
+            }
+
+            for (uint32_t s=0, n=frames; s<fStageCount; ++s, n*=2)
+            {
+                // alternate buffers so that the last stage writes into the plugin-side buffer
+                T* const dst = (fStageCount - s) % 2 != 0 ? fInputs[c].buffer : fTempBuffer;
+                upsampleStage(fInputs[c].stages[s], src, dst, n);
+                src = dst;
+            }
+        }
+
+        return fInputBuffers;
+    }
+
+    // plugin-side output buffers, to be passed to downsample() after running the plugin
+    T** getOutputs() const noexcept
+    {
+        return fOutputBuffers;
+    }
+
+    void downsample(T** const outputs, const uint32_t frames) noexcept
+    {
+        for (uint32_t c=0; c<fNumOutputs; ++c)
+        {
+            if (outputs[c] == nullptr)
+                continue;
+
+            const T* src = fOutputs[c].buffer;
+
+            for (uint32_t s=fStageCount, n=frames*fFactor; s-- != 0;)
+            {
+                n /= 2;
+
+                T* const dst = s == 0 ? outputs[c]
+                             : (fStageCount - s) % 2 != 0 ? fTempBuffer : fOutputs[c].buffer;
+                downsampleStage(fOutputs[c].stages[s], src, dst, n, s + 1 == fStageCount ? fExtraDelay : 0);
+                src = dst;
+            }
+        }
+    }
+
+    // -------------------------------------------------------------------
+
+    static bool isValidFactor(const uint32_t factor) noexcept
+    {
+        return factor == 1 || factor == 2 || factor == 4 || factor == 8;
+    }
+
+    // latency added by up and down sampling, in host samples
+    static uint32_t getLatency(const uint32_t factor) noexcept
+    {
+        return (getFilterDelay(factor) + getPadding(factor)) / factor;
+    }
+
+private:
+    // filter history of a single 2x stage, for either up or down sampling
+    struct Stage {
+        T up[kHalfBandHistory];
+        T downEven[kHalfBandHistory + kMaxOversamplingExtraDelay];
+        T downOdd[kHalfBandOddDelay + kMaxOversamplingExtraDelay];
+    };
+
+    struct Channel {
+        T* buffer;
+        Stage stages[kMaxOversamplingStages];
+
+        Channel() noexcept
+            : buffer(nullptr) {}
+    };
+
+    const uint32_t fNumInputs;
+    const uint32_t fNumOutputs;
+    Channel* const fInputs;
+    Channel* const fOutputs;
+    const T** const fInputBuffers;
+    T** const fOutputBuffers;
+
+    uint32_t fFactor;
+    uint32_t fStageCount;
+    uint32_t fExtraDelay;
+    uint32_t fBufferSize;
+
+    // scratch buffers shared by all channels
+    T* fTempBuffer;
+    T* fWorkBuffer;
+    T* fPhaseBuffer;
+
+    T fCoefficients[kHalfBandTaps];
+
+    void freeBuffers() noexcept
+    {
+        for (uint32_t i=0; i<fNumInputs; ++i)
+        {
+            delete[] fInputs[i].buffer;
+            fInputs[i].buffer = nullptr;
+            fInputBuffers[i] = nullptr;
+        }
+
+        for (uint32_t i=0; i<fNumOutputs; ++i)
+        {
+            delete[] fOutputs[i].buffer;
+            fOutputs[i].buffer = nullptr;
+            fOutputBuffers[i] = nullptr;
+        }
+
+        delete[] fTempBuffer;
+        delete[] fWorkBuffer;
+        delete[] fPhaseBuffer;
+        fTempBuffer = fWorkBuffer = fPhaseBuffer = nullptr;
+    }
+
+    // NOTE: the filter loops below go over taps first and samples second,
+    // so the inner loop is a plain multiply-add over contiguous memory the compiler can vectorize.
+    // Sources are copied into the work buffers first, so src and dst are allowed to overlap.
+
+    // 2x upsample of n samples from src into 2n samples in dst
+    void upsampleStage(Stage& stage, const T* const src, T* const dst, const uint32_t n) noexcept
+    {
+        T* const work = fWorkBuffer;
+        T* const even = fPhaseBuffer;
+
+        std::memcpy(work, stage.up, sizeof(T) * kHalfBandHistory);
+        std::memcpy(work + kHalfBandHistory, src, sizeof(T) * n);
+
+        for (uint32_t i=0; i<n; ++i)
+            even[i] = 0;
+
+        // zero-stuffing halves the energy, so the even taps are doubled
+        for (uint32_t j=0; j<kHalfBandTaps; ++j)
+        {
+            const T coef = fCoefficients[j] * 2;
+            const T* const in = work + kHalfBandHistory - j;
+
+            for (uint32_t i=0; i<n; ++i)
+                even[i] += coef * in[i];
+        }
+
+        // the odd branch is a pure delay, as the doubled center tap is exactly 1
+        const T* const odd = work + kHalfBandHistory - (kHalfBandOddDelay - 1);
+
+        for (uint32_t i=0; i<n; ++i)
+        {
+            dst[i * 2] = even[i];
+            dst[i * 2 + 1] = odd[i];
+        }
+
+        std::memcpy(stage.up, work + n, sizeof(T) * kHalfBandHistory);
+    }
+
+    // 2x downsample of 2n samples from src into n samples in dst, with an optional extra delay
+    void downsampleStage(Stage& stage, const T* const src, T* const dst, const uint32_t n,
+                         const uint32_t extraDelay) noexcept
+    {
+        const uint32_t evenHistory = kHalfBandHistory + extraDelay;
+        const uint32_t oddHistory = kHalfBandOddDelay + extraDelay;
+        T* const even = fWorkBuffer;
+        T* const odd = fPhaseBuffer;
+
+        std::memcpy(even, stage.downEven, sizeof(T) * evenHistory);
+        std::memcpy(odd, stage.downOdd, sizeof(T) * oddHistory);
+
+        for (uint32_t i=0; i<n; ++i)
+        {
+            even[evenHistory + i] = src[i * 2];
+            odd[oddHistory + i] = src[i * 2 + 1];
+        }
+
+        // center tap
+        for (uint32_t i=0; i<n; ++i)
+            dst[i] = odd[i] * static_cast<T>(0.5);
+
+        for (uint32_t j=0; j<kHalfBandTaps; ++j)
+        {
+            const T coef = fCoefficients[j];
+            const T* const in = even + kHalfBandHistory - j;
+
+            for (uint32_t i=0; i<n; ++i)
+                dst[i] += coef * in[i];
+        }
+
+        std::memcpy(stage.downEven, even + n, sizeof(T) * evenHistory);
+        std::memcpy(stage.downOdd, odd + n, sizeof(T) * oddHistory);
+    }
+
+    static uint32_t getStageCount(const uint32_t factor) noexcept
+    {
+        return factor >= 8 ? 3 : factor >= 4 ? 2 : factor >= 2 ? 1 : 0;
+    }
+
+    // combined delay of all up and down stages, in samples at the oversampled rate
+    static uint32_t getFilterDelay(const uint32_t factor) noexcept
+    {
+        return kHalfBandHistory * 2 * (factor - 1);
+    }
+
+    // delay needed on top of the filters to reach a whole number of host samples, at the oversampled rate
+    static uint32_t getPadding(const uint32_t factor) noexcept
+    {
+        return (factor - getFilterDelay(factor) % factor) % factor;
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(PluginOversampler)
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // DISTRHO_PLUGIN_OVERSAMPLING_HPP_INCLUDED
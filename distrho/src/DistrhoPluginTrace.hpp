@@ -0,0 +1,433 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef DISTRHO_PLUGIN_TRACE_HPP_INCLUDED
+#define DISTRHO_PLUGIN_TRACE_HPP_INCLUDED
+
+#include "../extra/Filesystem.hpp"
+#include "../extra/String.hpp"
+#include "../extra/Thread.hpp"
+#include "../extra/Time.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <vector>
+
+#ifdef DISTRHO_OS_WINDOWS
+# include <windows.h>
+#else
+# include <unistd.h>
+#endif
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+// Trace constants
+
+// number of records each instance can hold until the writer thread drains them, must be a power of 2
+static const uint32_t kTraceRecordCount = 2048;
+
+// how often the writer thread drains all instances
+static const uint32_t kTraceWriteIntervalMs = 50;
+
+// -----------------------------------------------------------------------
+// A single traced event, fixed size so it can be copied around without allocations
+
+struct PluginTraceRecord {
+    enum Type {
+        kTypeRun,
+        kTypeParameter,
+        kTypeProgram,
+        kTypeState,
+        kTypeUiMessage,
+        kTypeActivate,
+        kTypeDeactivate
+    };
+
+    uint64_t time;     // start time, from d_gettime_ns()
+    uint64_t duration; // only used for runs
+    uint32_t type;
+    uint32_t index;    // frames for runs, parameter or program index otherwise
+    uint32_t count;    // MIDI events for runs
+    float value;       // parameter value
+    char text[32];     // state key or UI message name, truncated
+};
+
+class PluginTraceWriter;
+
+// -----------------------------------------------------------------------
+// Per-instance trace recorder, used by PluginExporter when built with DPF_TRACING
+//
+// Events come from the audio thread and from host and UI threads alike, so records go into
+// a bounded multi-producer queue made of sequenced slots (no locks, no allocations).
+// A single background thread shared by all instances drains it into a Chrome trace JSON file,
+// which can be opened with Perfetto or chrome://tracing.
+
+class PluginTraceRecorder
+{
+public:
+    PluginTraceRecorder(const char* pluginName);
+    ~PluginTraceRecorder();
+
+    void addRun(const uint64_t startTime, const uint64_t endTime, const uint32_t frames, const uint32_t midiEventCount) noexcept
+    {
+        PluginTraceRecord record;
+        record.time = startTime;
+        record.duration = endTime - startTime;
+        record.type = PluginTraceRecord::kTypeRun;
+        record.index = frames;
+        record.count = midiEventCount;
+        record.value = 0.f;
+        record.text[0] = '\0';
+        push(record);
+    }
+
+    void addEvent(const PluginTraceRecord::Type type,
+                  const uint32_t index = 0, const float value = 0.f, const char* const text = nullptr) noexcept
+    {
+        PluginTraceRecord record;
+        record.time = d_gettime_ns();
+        record.duration = 0;
+        record.type = type;
+        record.index = index;
+        record.count = 0;
+        record.value = value;
+
+        if (text != nullptr)
+        {
+            std::strncpy(record.text, text, sizeof(record.text) - 1);
+            record.text[sizeof(record.text) - 1] = '\0';
+        }
+        else
+        {
+            record.text[0] = '\0';
+        }
+
+        push(record);
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> sequence;
+        PluginTraceRecord record;
+    };
+
+    Slot* const fSlots;
+    std::atomic<uint32_t> fWritePos;
+    uint32_t fReadPos; // writer thread only
+    std::atomic<uint32_t> fDropped;
+
+    const uint32_t fInstanceId;
+    FILE* fFile;
+    bool fNeedsComma;
+
+    friend class PluginTraceWriter;
+
+    // can be called from any thread, drops the record if the queue is full
+    void push(const PluginTraceRecord& record) noexcept
+    {
+        uint32_t pos = fWritePos.load(std::memory_order_relaxed);
+        Slot* slot;
+
+        for (;;)
+        {
+            slot = &fSlots[pos & (kTraceRecordCount - 1)];
+
+            const int32_t diff = static_cast<int32_t>(slot->sequence.load(std::memory_order_acquire) - pos);
+
+            if (diff == 0)
+            {
+                if (fWritePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                fDropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            else
+            {
+                pos = fWritePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        std::memcpy(&slot->record, &record, sizeof(PluginTraceRecord));
+        slot->sequence.store(pos + 1, std::memory_order_release);
+    }
+
+    // single consumer, either the writer thread or the destructor
+    bool pop(PluginTraceRecord& record) noexcept
+    {
+        Slot& slot(fSlots[fReadPos & (kTraceRecordCount - 1)]);
+
+        if (static_cast<int32_t>(slot.sequence.load(std::memory_order_acquire) - (fReadPos + 1)) < 0)
+            return false;
+
+        std::memcpy(&record, &slot.record, sizeof(PluginTraceRecord));
+        slot.sequence.store(fReadPos + kTraceRecordCount, std::memory_order_release);
+        ++fReadPos;
+        return true;
+    }
+
+    void openFile(const char* const pluginName)
+    {
+        String filename;
+
+        if (const char* const dir = std::getenv("DPF_TRACE_DIR"))
+            filename = dir;
+       #ifdef DISTRHO_OS_WINDOWS
+        else if (const char* const tempDir = std::getenv("TEMP"))
+            filename = tempDir;
+        else
+            filename = ".";
+       #else
+        else
+            filename = "/tmp";
+       #endif
+
+        filename += DISTRHO_OS_SEP_STR "dpf-trace-";
+        filename += String(getProcessId());
+        filename += "-";
+        filename += String(fInstanceId);
+        filename += ".json";
+
+        fFile = d_fopen(filename, "w");
+        DISTRHO_SAFE_ASSERT_RETURN(fFile != nullptr,);
+
+        d_stdout("DPF trace for instance #%u is written to '%s'", fInstanceId, filename.buffer());
+
+        // name the track of this instance
+        std::fprintf(fFile, "[\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"",
+                     getProcessId(), fInstanceId);
+        writeJsonString(pluginName);
+        std::fprintf(fFile, " #%u\"}}", fInstanceId);
+        fNeedsComma = true;
+    }
+
+    // called from the writer thread, or the destructor after this recorder was removed from it
+    void writeRecords()
+    {
+        const uint32_t pid = getProcessId();
+        PluginTraceRecord record;
+
+        while (pop(record))
+        {
+            std::fputs(fNeedsComma ? ",\n" : "\n", fFile);
+            fNeedsComma = true;
+
+            const double ts = static_cast<double>(record.time) / 1000.0;
+
+            switch (record.type)
+            {
+            case PluginTraceRecord::kTypeRun:
+                std::fprintf(fFile, "{\"name\":\"run\",\"ph\":\"X\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,"
+                                    "\"args\":{\"frames\":%u,\"midi\":%u}}",
+                             pid, fInstanceId, ts, static_cast<double>(record.duration) / 1000.0,
+                             record.index, record.count);
+                break;
+            case PluginTraceRecord::kTypeParameter:
+                std::fprintf(fFile, "{\"name\":\"parameter\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,"
+                                    "\"args\":{\"index\":%u,\"value\":%g}}",
+                             pid, fInstanceId, ts, record.index, static_cast<double>(record.value));
+                break;
+            case PluginTraceRecord::kTypeProgram:
+                std::fprintf(fFile, "{\"name\":\"program\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,"
+                                    "\"args\":{\"index\":%u}}",
+                             pid, fInstanceId, ts, record.index);
+                break;
+            case PluginTraceRecord::kTypeState:
+            case PluginTraceRecord::kTypeUiMessage:
+                std::fprintf(fFile, "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,"
+                                    "\"args\":{\"%s\":\"",
+                             record.type == PluginTraceRecord::kTypeState ? "state" : "ui message",
+                             pid, fInstanceId, ts,
+                             record.type == PluginTraceRecord::kTypeState ? "key" : "type");
+                writeJsonString(record.text);
+                std::fputs("\"}}", fFile);
+                break;
+            case PluginTraceRecord::kTypeActivate:
+            case PluginTraceRecord::kTypeDeactivate:
+                std::fprintf(fFile, "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f}",
+                             record.type == PluginTraceRecord::kTypeActivate ? "activate" : "deactivate",
+                             pid, fInstanceId, ts);
+                break;
+            }
+        }
+
+        if (const uint32_t dropped = fDropped.exchange(0, std::memory_order_relaxed))
+        {
+            std::fprintf(fFile, ",\n{\"name\":\"dropped\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,"
+                                "\"args\":{\"records\":%u}}",
+                         pid, fInstanceId, static_cast<double>(d_gettime_ns()) / 1000.0, dropped);
+        }
+
+        std::fflush(fFile);
+    }
+
+    void writeJsonString(const char* str)
+    {
+        for (; *str != '\0'; ++str)
+        {
+            const uchar c = static_cast<uchar>(*str);
+
+            if (c == '"' || c == '\\')
+                std::fprintf(fFile, "\\%c", c);
+            else if (c < 0x20)
+                std::fprintf(fFile, "\\u%04x", c);
+            else
+                std::fputc(c, fFile);
+        }
+    }
+
+    static uint32_t getProcessId() noexcept
+    {
+       #ifdef DISTRHO_OS_WINDOWS
+        return static_cast<uint32_t>(GetCurrentProcessId());
+       #else
+        return static_cast<uint32_t>(getpid());
+       #endif
+    }
+
+    static std::atomic<uint32_t>& getInstanceCounter() noexcept
+    {
+        static std::atomic<uint32_t> counter(0);
+        return counter;
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(PluginTraceRecorder)
+};
+
+// -----------------------------------------------------------------------
+// Background thread that drains all trace recorders, running while at least one exists
+
+class PluginTraceWriter : public Thread
+{
+public:
+    static void add(PluginTraceRecorder* const recorder)
+    {
+        PluginTraceWriter& writer(getInstance());
+        const MutexLocker cml(writer.fLifecycleMutex);
+
+        {
+            const MutexLocker cml2(writer.fMutex);
+            writer.fRecorders.push_back(recorder);
+        }
+
+        if (! writer.isThreadRunning())
+            writer.startThread();
+    }
+
+    static void remove(PluginTraceRecorder* const recorder)
+    {
+        PluginTraceWriter& writer(getInstance());
+        const MutexLocker cml(writer.fLifecycleMutex);
+        bool empty;
+
+        {
+            const MutexLocker cml2(writer.fMutex);
+
+            for (std::vector<PluginTraceRecorder*>::iterator it = writer.fRecorders.begin(); it != writer.fRecorders.end(); ++it)
+            {
+                if (*it == recorder)
+                {
+                    writer.fRecorders.erase(it);
+                    break;
+                }
+            }
+
+            empty = writer.fRecorders.empty();
+        }
+
+        if (empty)
+            writer.stopThread(-1);
+    }
+
+protected:
+    void run() override
+    {
+        while (! shouldThreadExit())
+        {
+            d_msleep(kTraceWriteIntervalMs);
+
+            const MutexLocker cml(fMutex);
+
+            for (std::vector<PluginTraceRecorder*>::iterator it = fRecorders.begin(); it != fRecorders.end(); ++it)
+                (*it)->writeRecords();
+        }
+    }
+
+private:
+    Mutex fLifecycleMutex; // serializes starting and stopping the thread
+    Mutex fMutex;          // protects the recorder list
+    std::vector<PluginTraceRecorder*> fRecorders;
+
+    PluginTraceWriter()
+        : Thread("DPF Trace"),
+          fLifecycleMutex(),
+          fMutex(),
+          fRecorders() {}
+
+    // created on first use, so it is always valid even for instances created during static initialization
+    static PluginTraceWriter& getInstance() noexcept
+    {
+        static PluginTraceWriter writer;
+        return writer;
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(PluginTraceWriter)
+};
+
+// -----------------------------------------------------------------------
+// PluginTraceRecorder constructor and destructor, after PluginTraceWriter is complete
+
+inline PluginTraceRecorder::PluginTraceRecorder(const char* const pluginName)
+    : fSlots(new Slot[kTraceRecordCount]),
+      fWritePos(0),
+      fReadPos(0),
+      fDropped(0),
+      fInstanceId(++getInstanceCounter()),
+      fFile(nullptr),
+      fNeedsComma(false)
+{
+    for (uint32_t i=0; i < kTraceRecordCount; ++i)
+        fSlots[i].sequence.store(i, std::memory_order_relaxed);
+
+    openFile(pluginName);
+
+    if (fFile != nullptr)
+        PluginTraceWriter::add(this);
+}
+
+inline PluginTraceRecorder::~PluginTraceRecorder()
+{
+    if (fFile != nullptr)
+    {
+        PluginTraceWriter::remove(this);
+
+        // the writer thread is no longer touching us, write what is left
+        writeRecords();
+        std::fputs("\n]\n", fFile);
+        std::fclose(fFile);
+    }
+
+    delete[] fSlots;
+}
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // DISTRHO_PLUGIN_TRACE_HPP_INCLUDED
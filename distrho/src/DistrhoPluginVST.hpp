@@ -366,6 +366,22 @@ struct ScopedUTF8String {
     }
 };
 
+// --------------------------------------------------------------------------------------------------------------------
+// custom, constant uids related to DPF (shared between the VST3 plugin and the export tool)
+
+static constexpr const uint32_t dpf_id_entry = d_cconst('D', 'P', 'F', ' ');
+static constexpr const uint32_t dpf_id_clas  = d_cconst('c', 'l', 'a', 's');
+static constexpr const uint32_t dpf_id_comp  = d_cconst('c', 'o', 'm', 'p');
+static constexpr const uint32_t dpf_id_ctrl  = d_cconst('c', 't', 'r', 'l');
+static constexpr const uint32_t dpf_id_proc  = d_cconst('p', 'r', 'o', 'c');
+static constexpr const uint32_t dpf_id_view  = d_cconst('v', 'i', 'e', 'w');
+
+#if defined(DISTRHO_PLUGIN_BRAND_ID) && !defined(DPF_VST3_DONT_USE_BRAND_ID)
+static constexpr const uint32_t dpf_id_brand = d_cconst(STRINGIFY(DISTRHO_PLUGIN_BRAND_ID));
+#else
+static constexpr const uint32_t dpf_id_brand = 0;
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 
 END_NAMESPACE_DISTRHO
@@ -295,8 +295,11 @@ protected:
 
     void setParameterValue(const uint32_t index, const float realValue)
     {
-        const ParameterRanges& ranges(fPlugin->getParameterRanges(index));
-        const float perValue = ranges.getNormalizedValue(realValue);
+        const float perValue = fPlugin->getNormalizedParameterValue(index, realValue);
+
+       #ifdef DPF_TRACING
+        fPlugin->traceUiMessage("parameter");
+       #endif
 
         fPlugin->setParameterValue(index, realValue);
         hostCallback(VST_HOST_OPCODE_00, index, 0, nullptr, perValue);
@@ -319,6 +322,11 @@ protected:
         midiData[0] = (velocity != 0 ? 0x90 : 0x80) | channel;
         midiData[1] = note;
         midiData[2] = velocity;
+
+       #ifdef DPF_TRACING
+        fPlugin->traceUiMessage("note");
+       #endif
+
         fNotesRingBuffer.writeCustomData(midiData, 3);
         fNotesRingBuffer.commitWrite();
     }
@@ -327,6 +335,10 @@ protected:
    #if DISTRHO_PLUGIN_WANT_STATE
     void setState(const char* const key, const char* const value)
     {
+       #ifdef DPF_TRACING
+        fPlugin->traceUiMessage("state");
+       #endif
+
         fUiHelper->setStateFromUI(key, value);
     }
    #endif
@@ -810,6 +822,12 @@ public:
             {
                 ++key;
                 float fvalue;
+                uint32_t paramIndex;
+
+                // parameters are sent to the plugin as a single batch after reading them all
+                uint32_t* const batchIndexes = new uint32_t[paramCount];
+                float* const batchValues = new float[paramCount];
+                uint32_t batchCount = 0;
 
                 while (bytesRead < chunkSize)
                 {
@@ -821,14 +839,9 @@ public:
                     bytesRead += size;
 
                     // find parameter with this symbol, and set its value
-                    for (uint32_t i=0; i<paramCount; ++i)
+                    if (fPlugin.getParameterIndexForSymbol(key, paramIndex) && ! fPlugin.isParameterOutputOrTrigger(paramIndex))
                     {
-                        if (fPlugin.isParameterOutputOrTrigger(i))
-                            continue;
-                        if (fPlugin.getParameterSymbol(i) != key)
-                            continue;
-
-                        if (fPlugin.getParameterHints(i) & kParameterIsInteger)
+                        if (fPlugin.getParameterHints(paramIndex) & kParameterIsInteger)
                         {
                             fvalue = std::atoi(value);
                         }
@@ -838,12 +851,12 @@ public:
                             fvalue = std::atof(value);
                         }
 
-                        fPlugin.setParameterValue(i, fvalue);
-                       #if DISTRHO_PLUGIN_HAS_UI
-                        if (fVstUI != nullptr)
-                            setParameterValueFromPlugin(i, fvalue);
-                       #endif
-                        break;
+                        if (batchCount < paramCount)
+                        {
+                            batchIndexes[batchCount] = paramIndex;
+                            batchValues[batchCount] = fvalue;
+                            ++batchCount;
+                        }
                     }
 
                     // get next key
@@ -851,6 +864,19 @@ public:
                     key  = value + size;
                     bytesRead += size;
                 }
+
+                fPlugin.setParameterValues(batchIndexes, batchValues, batchCount);
+
+               #if DISTRHO_PLUGIN_HAS_UI
+                if (fVstUI != nullptr)
+                {
+                    for (uint32_t i=0; i<batchCount; ++i)
+                        setParameterValueFromPlugin(batchIndexes[i], batchValues[i]);
+                }
+               #endif
+
+                delete[] batchIndexes;
+                delete[] batchValues;
             }
 
             return 1;
@@ -968,22 +994,22 @@ public:
 
     float vst_getParameter(const uint32_t index)
     {
-        const ParameterRanges& ranges(fPlugin.getParameterRanges(index));
-        return ranges.getNormalizedValue(fPlugin.getParameterValue(index));
+        return fPlugin.getNormalizedParameterValue(index, fPlugin.getParameterValue(index));
     }
 
     void vst_setParameter(const uint32_t index, const float value)
     {
         const uint32_t hints = fPlugin.getParameterHints(index);
-        const ParameterRanges& ranges(fPlugin.getParameterRanges(index));
 
         // TODO figure out how to detect kVstParameterUsesIntegerMinMax host support, and skip normalization
-        float realValue = ranges.getUnnormalizedValue(value);
+        float realValue = fPlugin.getUnnormalizedParameterValue(index, value);
 
         if (hints & kParameterIsBoolean)
         {
-            const float midRange = ranges.min + (ranges.max - ranges.min) / 2.0f;
-            realValue = realValue > midRange ? ranges.max : ranges.min;
+            const float min = fPlugin.getParameterMinimum(index);
+            const float max = fPlugin.getParameterMaximum(index);
+            const float midRange = min + (max - min) / 2.0f;
+            realValue = realValue > midRange ? max : min;
         }
 
         if (hints & kParameterIsInteger)
@@ -999,7 +1025,8 @@ public:
        #endif
     }
 
-    void vst_processReplacing(const float** const inputs, float** const outputs, const int32_t sampleFrames)
+    template<typename T>
+    void vst_processReplacing(const T** const inputs, T** const outputs, const int32_t sampleFrames)
     {
         if (! fPlugin.isActive())
         {
@@ -1161,7 +1188,11 @@ private:
     {
         float curValue, defValue;
 
+       #if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+        for (uint32_t i=0; fPlugin.getNextChangedParameter(i); ++i)
+       #else
         for (uint32_t i=0, count=fPlugin.getParameterCount(); i < count; ++i)
+       #endif
         {
             if (fPlugin.isParameterOutput(i))
             {
@@ -1203,8 +1234,7 @@ private:
                 continue;
             }
 
-            const ParameterRanges& ranges(fPlugin.getParameterRanges(i));
-            hostCallback(VST_HOST_OPCODE_00, i, 0, nullptr, ranges.getNormalizedValue(curValue));
+            hostCallback(VST_HOST_OPCODE_00, i, 0, nullptr, fPlugin.getNormalizedParameterValue(i, curValue));
         }
 
        #if DISTRHO_PLUGIN_WANT_LATENCY
@@ -1223,8 +1253,7 @@ private:
    #if DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST
     bool requestParameterValueChange(const uint32_t index, const float value)
     {
-        const ParameterRanges& ranges(fPlugin.getParameterRanges(index));
-        hostCallback(VST_HOST_OPCODE_00, index, 0, nullptr, ranges.getNormalizedValue(value));
+        hostCallback(VST_HOST_OPCODE_00, index, 0, nullptr, fPlugin.getNormalizedParameterValue(index, value));
         return true;
     }
 
@@ -1580,6 +1609,17 @@ static void VST_FUNCTION_INTERFACE vst_processReplacingCallback(vst_effect* cons
         pluginPtr->vst_processReplacing(const_cast<const float**>(inputs), outputs, sampleFrames);
 }
 
+#if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+static void VST_FUNCTION_INTERFACE vst_processDoubleReplacingCallback(vst_effect* const effect,
+                                                                      const double* const* const inputs,
+                                                                      double** const outputs,
+                                                                      const int32_t sampleFrames)
+{
+    if (PluginVst* const pluginPtr = getEffectPlugin(effect))
+        pluginPtr->vst_processReplacing(const_cast<const double**>(inputs), outputs, sampleFrames);
+}
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 
 END_NAMESPACE_DISTRHO
@@ -1681,6 +1721,9 @@ const vst_effect* VSTPluginMain(const vst_host_callback audioMaster)
 
     // plugin flags
     effect->flags |= 1 << 4; // uses process_float
+   #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+    effect->flags |= 1 << 12; // uses process_double
+   #endif
    #if DISTRHO_PLUGIN_IS_SYNTH
     effect->flags |= 1 << 8;
    #endif
@@ -1697,6 +1740,9 @@ const vst_effect* VSTPluginMain(const vst_host_callback audioMaster)
     effect->get_parameter = vst_getParameterCallback;
     effect->set_parameter = vst_setParameterCallback;
     effect->process_float = vst_processReplacingCallback;
+   #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+    effect->process_double = vst_processDoubleReplacingCallback;
+   #endif
 
     // special values
     effect->valid       = 101;
@@ -80,23 +80,7 @@ static_assert(sizeof(v3_tuid) == sizeof(dpf_tuid), "uid size mismatch");
 #endif
 
 // --------------------------------------------------------------------------------------------------------------------
-// custom, constant uids related to DPF
-
-static constexpr const uint32_t dpf_id_entry = d_cconst('D', 'P', 'F', ' ');
-static constexpr const uint32_t dpf_id_clas  = d_cconst('c', 'l', 'a', 's');
-static constexpr const uint32_t dpf_id_comp  = d_cconst('c', 'o', 'm', 'p');
-static constexpr const uint32_t dpf_id_ctrl  = d_cconst('c', 't', 'r', 'l');
-static constexpr const uint32_t dpf_id_proc  = d_cconst('p', 'r', 'o', 'c');
-static constexpr const uint32_t dpf_id_view  = d_cconst('v', 'i', 'e', 'w');
-
-// --------------------------------------------------------------------------------------------------------------------
-// plugin specific uids (values are filled in during plugin init)
-
-#if defined(DISTRHO_PLUGIN_BRAND_ID) && !defined(DPF_VST3_DONT_USE_BRAND_ID)
-static constexpr const uint32_t dpf_id_brand = d_cconst(STRINGIFY(DISTRHO_PLUGIN_BRAND_ID));
-#else
-static constexpr const uint32_t dpf_id_brand = 0;
-#endif
+// plugin specific uids (values are filled in during plugin init, constant parts are in DistrhoPluginVST.hpp)
 
 static dpf_tuid dpf_tuid_class = { dpf_id_entry, dpf_id_clas, 0, dpf_id_brand };
 static dpf_tuid dpf_tuid_component = { dpf_id_entry, dpf_id_comp, 0, dpf_id_brand };
@@ -247,6 +231,29 @@ const char* tuid2str(const v3_tuid iid)
     return buf;
 }
 
+// --------------------------------------------------------------------------------------------------------------------
+// get the channel buffers of an audio bus matching the requested sample size
+
+template<typename T>
+static inline
+T** getChannelBuffers(const v3_audio_bus_buffers& bus) noexcept;
+
+template<>
+inline
+float** getChannelBuffers<float>(const v3_audio_bus_buffers& bus) noexcept
+{
+    return bus.channel_buffers_32;
+}
+
+#if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+template<>
+inline
+double** getChannelBuffers<double>(const v3_audio_bus_buffers& bus) noexcept
+{
+    return bus.channel_buffers_64;
+}
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 // dpf_plugin_view_create (implemented on UI side)
 
@@ -595,8 +602,9 @@ public:
           fParameterCount(fPlugin.getParameterCount()),
           fVst3ParameterCount(fParameterCount + kVst3InternalParameterCount),
           fCachedParameterValues(nullptr),
-          fDummyAudioBuffer(nullptr),
-          fParameterValuesChangedDuringProcessing(nullptr)
+          fParameterValuesChangedDuringProcessing(nullptr),
+          fParameterBatchIndexes(nullptr),
+          fParameterBatchValues(nullptr)
        #if DPF_VST3_USES_SEPARATE_CONTROLLER
         , fIsComponent(isComponent)
        #endif
@@ -655,6 +663,12 @@ public:
            #endif
         }
 
+        if (fParameterCount != 0)
+        {
+            fParameterBatchIndexes = new uint32_t[fParameterCount];
+            fParameterBatchValues = new float[fParameterCount];
+        }
+
        #if DISTRHO_PLUGIN_WANT_STATE
         for (uint32_t i=0, count=fPlugin.getStateCount(); i<count; ++i)
         {
@@ -677,18 +691,24 @@ public:
             fCachedParameterValues = nullptr;
         }
 
-        if (fDummyAudioBuffer != nullptr)
-        {
-            delete[] fDummyAudioBuffer;
-            fDummyAudioBuffer = nullptr;
-        }
-
         if (fParameterValuesChangedDuringProcessing != nullptr)
         {
             delete[] fParameterValuesChangedDuringProcessing;
             fParameterValuesChangedDuringProcessing = nullptr;
         }
 
+        if (fParameterBatchIndexes != nullptr)
+        {
+            delete[] fParameterBatchIndexes;
+            fParameterBatchIndexes = nullptr;
+        }
+
+        if (fParameterBatchValues != nullptr)
+        {
+            delete[] fParameterBatchValues;
+            fParameterBatchValues = nullptr;
+        }
+
        #if DISTRHO_PLUGIN_HAS_UI
         if (fParameterValueChangesForUI != nullptr)
         {
@@ -703,26 +723,26 @@ public:
 
     double _getNormalizedParameterValue(const uint32_t index, const double plain)
     {
-        const ParameterRanges& ranges(fPlugin.getParameterRanges(index));
-        return ranges.getFixedAndNormalizedValue(plain);
+        return fPlugin.getNormalizedParameterValue(index, plain);
     }
 
-    void _setNormalizedPluginParameterValue(const uint32_t index, const double normalized)
+    void _setNormalizedPluginParameterValue(const uint32_t index, const double normalized, const int32_t offset = 0)
     {
-        const ParameterRanges& ranges(fPlugin.getParameterRanges(index));
         const uint32_t hints = fPlugin.getParameterHints(index);
-        float value = ranges.getUnnormalizedValue(normalized);
+        float value = fPlugin.getUnnormalizedParameterValue(index, normalized);
 
         // convert as needed as check for changes
         if (hints & kParameterIsBoolean)
         {
-            const float midRange = ranges.min + (ranges.max - ranges.min) / 2.f;
+            const float min = fPlugin.getParameterMinimum(index);
+            const float max = fPlugin.getParameterMaximum(index);
+            const float midRange = min + (max - min) / 2.f;
             const bool isHigh = value > midRange;
 
             if (isHigh == (fCachedParameterValues[kVst3InternalParameterBaseCount + index] > midRange))
                 return;
 
-            value = isHigh ? ranges.max : ranges.min;
+            value = isHigh ? max : min;
         }
         else if (hints & kParameterIsInteger)
         {
@@ -736,7 +756,7 @@ public:
         else
         {
             // deal with low resolution of some hosts, which convert double to float internally and lose precision
-            if (std::abs(ranges.getNormalizedValue(static_cast<double>(fCachedParameterValues[kVst3InternalParameterBaseCount + index])) - normalized) < 0.0000001)
+            if (std::abs(fPlugin.getNormalizedParameterValue(index, fCachedParameterValues[kVst3InternalParameterBaseCount + index]) - normalized) < 0.0000001)
                 return;
         }
 
@@ -752,7 +772,15 @@ public:
       #endif
 
         if (!fPlugin.isParameterOutputOrTrigger(index))
+        {
+           #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+            fPlugin.setParameterValueAtFrame(offset, index, value);
+           #else
             fPlugin.setParameterValue(index, value);
+            // unused
+            (void)offset;
+           #endif
+        }
     }
 
     // ----------------------------------------------------------------------------------------------------------------
@@ -948,6 +976,7 @@ public:
         const bool connectedToUI = fConnectionFromCtrlToView != nullptr && fConnectedToUI;
        #endif
         bool componentValuesChanged = false;
+        uint32_t parameterBatchCount = 0;
         String key, value;
         bool empty = true;
         bool hasValue = false;
@@ -1095,15 +1124,11 @@ public:
                     {
                         d_debug("found parameter '%s' '%s'", key.buffer(), value.buffer());
                         float fvalue;
+                        uint32_t j;
 
                         // find parameter with this symbol, and set its value
-                        for (uint32_t j=0; j < fParameterCount; ++j)
+                        if (fPlugin.getParameterIndexForSymbol(key, j) && ! fPlugin.isParameterOutputOrTrigger(j))
                         {
-                            if (fPlugin.isParameterOutputOrTrigger(j))
-                                continue;
-                            if (fPlugin.getParameterSymbol(j) != key)
-                                continue;
-
                             if (fPlugin.getParameterHints(j) & kParameterIsInteger)
                             {
                                 fvalue = std::atoi(value.buffer());
@@ -1122,6 +1147,9 @@ public:
                             {
                                 componentValuesChanged = true;
                                 fParameterValuesChangedDuringProcessing[kVst3InternalParameterBaseCount + j] = true;
+                               #if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+                                fPlugin.markParameterChanged(j);
+                               #endif
                             }
                            #else
                             componentValuesChanged = true;
@@ -1134,8 +1162,14 @@ public:
                                 fParameterValueChangesForUI[kVst3InternalParameterBaseCount + j] = true;
                             }
                            #endif
-                            fPlugin.setParameterValue(j, fvalue);
-                            break;
+
+                            // plugin parameter updates are also handled outside the read loop, as a single batch
+                            if (parameterBatchCount < fParameterCount)
+                            {
+                                fParameterBatchIndexes[parameterBatchCount] = j;
+                                fParameterBatchValues[parameterBatchCount] = fvalue;
+                                ++parameterBatchCount;
+                            }
                         }
                     }
 
@@ -1146,6 +1180,8 @@ public:
             }
         }
 
+        fPlugin.setParameterValues(fParameterBatchIndexes, fParameterBatchValues, parameterBatchCount);
+
         if (fComponentHandler != nullptr && componentValuesChanged)
             v3_cpp_obj(fComponentHandler)->restart_component(fComponentHandler, V3_RESTART_PARAM_VALUES_CHANGED);
 
@@ -1156,10 +1192,10 @@ public:
             {
                 if (fPlugin.isParameterOutputOrTrigger(i))
                     continue;
-                fParameterValueChangesForUI[kVst3InternalParameterBaseCount + i] = false;
-                sendParameterSetToUI(kVst3InternalParameterCount + i,
-                                     fCachedParameterValues[kVst3InternalParameterBaseCount + i]);
+                fParameterValueChangesForUI[kVst3InternalParameterBaseCount + i] = true;
             }
+
+            sendParameterSetBatchToUI();
         }
        #endif
 
@@ -1344,13 +1380,18 @@ public:
 
     v3_result setupProcessing(v3_process_setup* const setup)
     {
+       #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+        DISTRHO_SAFE_ASSERT_RETURN(setup->symbolic_sample_size == V3_SAMPLE_32 ||
+                                   setup->symbolic_sample_size == V3_SAMPLE_64, V3_INVALID_ARG);
+       #else
         DISTRHO_SAFE_ASSERT_RETURN(setup->symbolic_sample_size == V3_SAMPLE_32, V3_INVALID_ARG);
+       #endif
 
         const bool active = fPlugin.isActive();
         fPlugin.deactivateIfNeeded();
 
-        // TODO process_mode can be V3_REALTIME, V3_PREFETCH, V3_OFFLINE
-
+        // V3_PREFETCH is still time-constrained, only V3_OFFLINE allows slower than real-time processing
+        fPlugin.setOffline(setup->process_mode == V3_OFFLINE, true);
         fPlugin.setSampleRate(setup->sample_rate, true);
         fPlugin.setBufferSize(setup->max_block_size, true);
 
@@ -1368,9 +1409,6 @@ public:
         if (active)
             fPlugin.activate();
 
-        delete[] fDummyAudioBuffer;
-        fDummyAudioBuffer = new float[setup->max_block_size];
-
         return V3_OK;
     }
 
@@ -1391,7 +1429,12 @@ public:
 
     v3_result process(v3_process_data* const data)
     {
+       #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+        DISTRHO_SAFE_ASSERT_RETURN(data->symbolic_sample_size == V3_SAMPLE_32 ||
+                                   data->symbolic_sample_size == V3_SAMPLE_64, V3_INVALID_ARG);
+       #else
         DISTRHO_SAFE_ASSERT_RETURN(data->symbolic_sample_size == V3_SAMPLE_32, V3_INVALID_ARG);
+       #endif
         // d_debug("process %i", data->symbolic_sample_size);
 
         // activate plugin if not done yet
@@ -1461,57 +1504,6 @@ public:
             return V3_OK;
         }
 
-        const float* inputs[DISTRHO_PLUGIN_NUM_INPUTS != 0 ? DISTRHO_PLUGIN_NUM_INPUTS : 1];
-        /* */ float* outputs[DISTRHO_PLUGIN_NUM_OUTPUTS != 0 ? DISTRHO_PLUGIN_NUM_OUTPUTS : 1];
-
-        std::memset(fDummyAudioBuffer, 0, sizeof(float)*data->nframes);
-
-        {
-            int32_t i = 0;
-           #if DISTRHO_PLUGIN_NUM_INPUTS > 0
-            if (data->inputs != nullptr)
-            {
-                for (int32_t b = 0; b < data->num_input_buses; ++b) {
-                    for (int32_t j = 0; j < data->inputs[b].num_channels; ++j)
-                    {
-                        DISTRHO_SAFE_ASSERT_INT_BREAK(i < DISTRHO_PLUGIN_NUM_INPUTS, i);
-                        if (!fEnabledInputs[i] && i < DISTRHO_PLUGIN_NUM_INPUTS) {
-                            inputs[i++] = fDummyAudioBuffer;
-                            continue;
-                        }
-
-                        inputs[i++] = data->inputs[b].channel_buffers_32[j];
-                    }
-                }
-            }
-           #endif
-            for (; i < std::max(1, DISTRHO_PLUGIN_NUM_INPUTS); ++i)
-                inputs[i] = fDummyAudioBuffer;
-        }
-
-        {
-            int32_t i = 0;
-           #if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
-            if (data->outputs != nullptr)
-            {
-                for (int32_t b = 0; b < data->num_output_buses; ++b) {
-                    for (int32_t j = 0; j < data->outputs[b].num_channels; ++j)
-                    {
-                        DISTRHO_SAFE_ASSERT_INT_BREAK(i < DISTRHO_PLUGIN_NUM_OUTPUTS, i);
-                        if (!fEnabledOutputs[i] && i < DISTRHO_PLUGIN_NUM_OUTPUTS) {
-                            outputs[i++] = fDummyAudioBuffer;
-                            continue;
-                        }
-
-                        outputs[i++] = data->outputs[b].channel_buffers_32[j];
-                    }
-                }
-            }
-           #endif
-            for (; i < std::max(1, DISTRHO_PLUGIN_NUM_OUTPUTS); ++i)
-                outputs[i] = fDummyAudioBuffer;
-        }
-
        #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
         fHostEventOutputHandle = data->output_events;
        #endif
@@ -1592,6 +1584,18 @@ public:
                 }
                #endif
 
+                const uint32_t index = rindex - kVst3InternalParameterCount;
+
+               #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+                // pass all parameter changes, plugin run will be split at each change point
+                for (int32_t j = 0, pcount = v3_cpp_obj(queue)->get_point_count(queue); j < pcount; ++j)
+                {
+                    if (v3_cpp_obj(queue)->get_point(queue, j, &offset, &normalized) != V3_OK)
+                        break;
+
+                    _setNormalizedPluginParameterValue(index, normalized, std::max(0, offset));
+                }
+               #else
                 if (v3_cpp_obj(queue)->get_point_count(queue) <= 0)
                     continue;
 
@@ -1602,22 +1606,49 @@ public:
                 if (offset != 0)
                     continue;
 
-                const uint32_t index = rindex - kVst3InternalParameterCount;
                 _setNormalizedPluginParameterValue(index, normalized);
+               #endif
             }
         }
 
        #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
         const uint32_t midiEventCount = inputEventList.convert(fMidiEvents);
-        fPlugin.run(inputs, outputs, data->nframes, fMidiEvents, midiEventCount);
        #else
-        fPlugin.run(inputs, outputs, data->nframes);
+        const uint32_t midiEventCount = 0;
+       #endif
+
+        // dummy buffer comes from the plugin scratch memory, sized from max_block_size in setupProcessing
+       #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+        if (data->symbolic_sample_size == V3_SAMPLE_64)
+            runWithAudioBuffers(data, static_cast<double*>(fPlugin.getWrapperScratchBuffer()), midiEventCount);
+        else
+       #endif
+        runWithAudioBuffers(data, static_cast<float*>(fPlugin.getWrapperScratchBuffer()), midiEventCount);
+
+       #if DISTRHO_PLUGIN_WANT_SILENCE_DETECTION && DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+        // let the host know when our outputs are silent, so it can skip processing further down the chain
+        if (data->outputs != nullptr)
+        {
+            const bool silent = fPlugin.isOutputSilent();
+
+            for (int32_t b = 0; b < data->num_output_buses; ++b)
+            {
+                v3_audio_bus_buffers& bus(data->outputs[b]);
+                if (! silent)
+                    bus.channel_silence_bitset = 0;
+                else if (bus.num_channels < 64)
+                    bus.channel_silence_bitset = (1ULL << bus.num_channels) - 1;
+                else
+                    bus.channel_silence_bitset = ~0ULL;
+            }
+        }
        #endif
 
        #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
         fHostEventOutputHandle = nullptr;
        #endif
 
+       #if ! DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
         // if there are any parameter changes after frame 0, set them here
         if (v3_param_changes** const inparamsptr = data->input_params)
         {
@@ -1652,14 +1683,15 @@ public:
                 _setNormalizedPluginParameterValue(index, normalized);
             }
         }
+       #endif
 
         updateParametersFromProcessing(data->output_params, data->nframes - 1);
         return V3_OK;
     }
 
-    uint32_t getTailSamples() const noexcept
+    uint32_t getTailSamples() const
     {
-        return 0;
+        return fPlugin.getTailLength();
     }
 
     // ----------------------------------------------------------------------------------------------------------------
@@ -2086,7 +2118,17 @@ public:
                 {
                     if (fPlugin.isParameterOutputOrTrigger(i))
                         continue;
-                    fCachedParameterValues[kVst3InternalParameterBaseCount + i] = fPlugin.getParameterValue(i);
+
+                    const float value = fPlugin.getParameterValue(i);
+
+                    if (d_isEqual(fCachedParameterValues[kVst3InternalParameterBaseCount + i], value))
+                        continue;
+
+                    fCachedParameterValues[kVst3InternalParameterBaseCount + i] = value;
+                   #if DISTRHO_PLUGIN_HAS_UI
+                    // sent to the UI as a single batch on next idle
+                    fParameterValueChangesForUI[kVst3InternalParameterBaseCount + i] = true;
+                   #endif
                 }
 
                #if DISTRHO_PLUGIN_HAS_UI
@@ -2148,6 +2190,10 @@ public:
         v3_attribute_list** const attrs = v3_cpp_obj(message)->get_attributes(message);
         DISTRHO_SAFE_ASSERT_RETURN(attrs != nullptr, V3_INVALID_ARG);
 
+       #ifdef DPF_TRACING
+        fPlugin.traceUiMessage(msgid);
+       #endif
+
        #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
         if (std::strcmp(msgid, "midi") == 0)
             return notify_midi(attrs);
@@ -2223,12 +2269,9 @@ public:
            #endif
 
             for (uint32_t i=0; i<fParameterCount; ++i)
-            {
-                fParameterValueChangesForUI[kVst3InternalParameterBaseCount + i] = false;
-                sendParameterSetToUI(kVst3InternalParameterCount + i,
-                                     fCachedParameterValues[kVst3InternalParameterBaseCount + i]);
-            }
+                fParameterValueChangesForUI[kVst3InternalParameterBaseCount + i] = true;
 
+            sendParameterSetBatchToUI();
             sendReadyToUI();
             return V3_OK;
         }
@@ -2257,16 +2300,7 @@ public:
             }
            #endif
 
-            for (uint32_t i=0; i<fParameterCount; ++i)
-            {
-                if (! fParameterValueChangesForUI[kVst3InternalParameterBaseCount + i])
-                    continue;
-
-                fParameterValueChangesForUI[kVst3InternalParameterBaseCount + i] = false;
-                sendParameterSetToUI(kVst3InternalParameterCount + i,
-                                     fCachedParameterValues[kVst3InternalParameterBaseCount + i]);
-            }
-
+            sendParameterSetBatchToUI();
             sendReadyToUI();
             return V3_OK;
         }
@@ -2459,8 +2493,9 @@ private:
     const uint32_t fParameterCount;
     const uint32_t fVst3ParameterCount; // full offset + real
     float* fCachedParameterValues; // basic offset + real
-    float* fDummyAudioBuffer;
     bool* fParameterValuesChangedDuringProcessing; // basic offset + real
+    uint32_t* fParameterBatchIndexes; // real
+    float* fParameterBatchValues; // real
    #if DISTRHO_PLUGIN_NUM_INPUTS > 0
     bool fEnabledInputs[DISTRHO_PLUGIN_NUM_INPUTS];
    #endif
@@ -2878,6 +2913,70 @@ private:
     // ----------------------------------------------------------------------------------------------------------------
     // helper functions called during process, cannot block
 
+    // collect the host audio buffers, using a dummy buffer for disabled or missing channels, and run the plugin
+    template<typename T>
+    void runWithAudioBuffers(v3_process_data* const data, T* const dummyBuffer, const uint32_t midiEventCount)
+    {
+        const T* inputs[DISTRHO_PLUGIN_NUM_INPUTS != 0 ? DISTRHO_PLUGIN_NUM_INPUTS : 1];
+        /* */ T* outputs[DISTRHO_PLUGIN_NUM_OUTPUTS != 0 ? DISTRHO_PLUGIN_NUM_OUTPUTS : 1];
+
+        std::memset(dummyBuffer, 0, sizeof(T)*data->nframes);
+
+        {
+            int32_t i = 0;
+           #if DISTRHO_PLUGIN_NUM_INPUTS > 0
+            if (data->inputs != nullptr)
+            {
+                for (int32_t b = 0; b < data->num_input_buses; ++b) {
+                    for (int32_t j = 0; j < data->inputs[b].num_channels; ++j)
+                    {
+                        DISTRHO_SAFE_ASSERT_INT_BREAK(i < DISTRHO_PLUGIN_NUM_INPUTS, i);
+                        if (!fEnabledInputs[i] && i < DISTRHO_PLUGIN_NUM_INPUTS) {
+                            inputs[i++] = dummyBuffer;
+                            continue;
+                        }
+
+                        inputs[i++] = getChannelBuffers<T>(data->inputs[b])[j];
+                    }
+                }
+            }
+           #endif
+            for (; i < std::max(1, DISTRHO_PLUGIN_NUM_INPUTS); ++i)
+                inputs[i] = dummyBuffer;
+        }
+
+        {
+            int32_t i = 0;
+           #if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+            if (data->outputs != nullptr)
+            {
+                for (int32_t b = 0; b < data->num_output_buses; ++b) {
+                    for (int32_t j = 0; j < data->outputs[b].num_channels; ++j)
+                    {
+                        DISTRHO_SAFE_ASSERT_INT_BREAK(i < DISTRHO_PLUGIN_NUM_OUTPUTS, i);
+                        if (!fEnabledOutputs[i] && i < DISTRHO_PLUGIN_NUM_OUTPUTS) {
+                            outputs[i++] = dummyBuffer;
+                            continue;
+                        }
+
+                        outputs[i++] = getChannelBuffers<T>(data->outputs[b])[j];
+                    }
+                }
+            }
+           #endif
+            for (; i < std::max(1, DISTRHO_PLUGIN_NUM_OUTPUTS); ++i)
+                outputs[i] = dummyBuffer;
+        }
+
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        fPlugin.run(inputs, outputs, data->nframes, fMidiEvents, midiEventCount);
+       #else
+        fPlugin.run(inputs, outputs, data->nframes);
+        // unused
+        (void)midiEventCount;
+       #endif
+    }
+
     void updateParametersFromProcessing(v3_param_changes** const outparamsptr, const int32_t offset)
     {
         DISTRHO_SAFE_ASSERT_RETURN(outparamsptr != nullptr,);
@@ -2897,7 +2996,11 @@ private:
         }
        #endif
 
+       #if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+        for (uint32_t i=0; fPlugin.getNextChangedParameter(i); ++i)
+       #else
         for (uint32_t i=0; i<fParameterCount; ++i)
+       #endif
         {
             if (fPlugin.isParameterOutput(i))
             {
@@ -3011,6 +3114,39 @@ private:
         v3_cpp_obj_unref(message);
     }
 
+    // send all parameters marked as changed for the UI in a single message
+    void sendParameterSetBatchToUI()
+    {
+        uint32_t count = 0;
+
+        for (uint32_t i=0; i<fParameterCount; ++i)
+        {
+            if (! fParameterValueChangesForUI[kVst3InternalParameterBaseCount + i])
+                continue;
+
+            fParameterValueChangesForUI[kVst3InternalParameterBaseCount + i] = false;
+            fParameterBatchIndexes[count] = i;
+            fParameterBatchValues[count] = fCachedParameterValues[kVst3InternalParameterBaseCount + i];
+            ++count;
+        }
+
+        if (count == 0)
+            return;
+
+        v3_message** const message = createMessage("parameter-set-batch");
+        DISTRHO_SAFE_ASSERT_RETURN(message != nullptr,);
+
+        v3_attribute_list** const attrlist = v3_cpp_obj(message)->get_attributes(message);
+        DISTRHO_SAFE_ASSERT_RETURN(attrlist != nullptr,);
+
+        v3_cpp_obj(attrlist)->set_int(attrlist, "__dpf_msg_target__", 2);
+        v3_cpp_obj(attrlist)->set_binary(attrlist, "indexes", fParameterBatchIndexes, sizeof(uint32_t)*count);
+        v3_cpp_obj(attrlist)->set_binary(attrlist, "values", fParameterBatchValues, sizeof(float)*count);
+        v3_cpp_obj(fConnectionFromCtrlToView)->notify(fConnectionFromCtrlToView, message);
+
+        v3_cpp_obj_unref(message);
+    }
+
     void sendStateSetToUI(const char* const key, const char* const value) const
     {
         v3_message** const message = createMessage("state-set");
@@ -3051,6 +3187,9 @@ private:
     bool requestParameterValueChange(const uint32_t index, float)
     {
         fParameterValuesChangedDuringProcessing[kVst3InternalParameterBaseCount + index] = true;
+       #if DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING
+        fPlugin.markParameterChanged(index);
+       #endif
         return true;
     }
 
@@ -4085,6 +4224,10 @@ struct dpf_audio_processor : v3_audio_processor_cpp {
     {
         // NOTE runs during RT
         // d_debug("dpf_audio_processor::can_process_sample_size => %i", symbolic_sample_size);
+       #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+        if (symbolic_sample_size == V3_SAMPLE_64)
+            return V3_OK;
+       #endif
         return symbolic_sample_size == V3_SAMPLE_32 ? V3_OK : V3_NOT_IMPLEMENTED;
     }
 
@@ -4563,9 +4706,13 @@ struct dpf_component : v3_component_cpp {
 };
 
 // --------------------------------------------------------------------------------------------------------------------
-// Dummy plugin to get data from
+// Dummy plugin to get data from (or build-time metadata if available)
 
+#if DISTRHO_PLUGIN_HAS_STATIC_METADATA
+static constexpr const PluginStaticMetadata* const sPlugin = &kPluginStaticMetadata;
+#else
 static ScopedPointer<PluginExporter> sPlugin;
+#endif
 
 static const char* getPluginCategories()
 {
@@ -4966,6 +5113,11 @@ bool ENTRYFNNAME(ENTRYFNNAMEARGS)
         }
     }
 
+   #if DISTRHO_PLUGIN_HAS_STATIC_METADATA
+    // set uniqueId from build-time metadata, no plugin instance needed
+    dpf_tuid_class[2] = dpf_tuid_component[2] = dpf_tuid_controller[2]
+        = dpf_tuid_processor[2] = dpf_tuid_view[2] = sPlugin->getUniqueId();
+   #else
     // init dummy plugin and set uniqueId
     if (sPlugin == nullptr)
     {
@@ -4987,6 +5139,7 @@ bool ENTRYFNNAME(ENTRYFNNAMEARGS)
         dpf_tuid_class[2] = dpf_tuid_component[2] = dpf_tuid_controller[2]
             = dpf_tuid_processor[2] = dpf_tuid_view[2] = sPlugin->getUniqueId();
     }
+   #endif
 
     return true;
 }
@@ -4996,7 +5149,9 @@ bool EXITFNNAME(void);
 
 bool EXITFNNAME(void)
 {
+   #if ! DISTRHO_PLUGIN_HAS_STATIC_METADATA
     DISTRHO_NAMESPACE::sPlugin = nullptr;
+   #endif
     return true;
 }
 
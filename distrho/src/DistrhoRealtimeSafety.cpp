@@ -0,0 +1,272 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../extra/RealtimeSafety.hpp"
+
+#if DISTRHO_RT_SAFETY_HOOKS
+
+#include <cerrno>
+#include <new>
+
+#include <dlfcn.h>
+#include <pthread.h>
+
+// --------------------------------------------------------------------------------------------------------------------
+// Realtime-safety hooks
+//
+// These replace the allocation and locking functions with hidden visibility,
+// so that only calls made from within the plugin binary (plugin code and DPF itself) are intercepted,
+// while the host and other libraries keep using the regular functions.
+// Every hook forwards to the global definition of the same function, found through dlsym(RTLD_DEFAULT),
+// which is what the plugin would have used without hooks.
+// Memory keeps going through whichever allocator the host uses (glibc, jemalloc, tcmalloc, etc),
+// so pointers can still be freely passed between the plugin and the rest of the process.
+// NOTE: RTLD_NEXT is not used, as for dlopen'ed plugins it skips allocators preloaded or linked by the host
+
+// NOTE: all these functions are already declared (and possibly used) at this point,
+//       so their visibility needs to be set at assembler level
+#if __SIZEOF_POINTER__ == 8
+# define DISTRHO_RT_SAFETY_SIZE_T "m"
+#else
+# define DISTRHO_RT_SAFETY_SIZE_T "j"
+#endif
+
+__asm__(".hidden malloc\n"
+        ".hidden calloc\n"
+        ".hidden realloc\n"
+        ".hidden posix_memalign\n"
+        ".hidden free\n"
+        ".hidden pthread_mutex_lock\n"
+        ".hidden _Znw" DISTRHO_RT_SAFETY_SIZE_T "\n"
+        ".hidden _Zna" DISTRHO_RT_SAFETY_SIZE_T "\n"
+        ".hidden _Znw" DISTRHO_RT_SAFETY_SIZE_T "RKSt9nothrow_t\n"
+        ".hidden _Zna" DISTRHO_RT_SAFETY_SIZE_T "RKSt9nothrow_t\n"
+        ".hidden _ZdlPv\n"
+        ".hidden _ZdaPv\n"
+        ".hidden _ZdlPvRKSt9nothrow_t\n"
+        ".hidden _ZdaPvRKSt9nothrow_t\n"
+       #ifdef __cpp_sized_deallocation
+        ".hidden _ZdlPv" DISTRHO_RT_SAFETY_SIZE_T "\n"
+        ".hidden _ZdaPv" DISTRHO_RT_SAFETY_SIZE_T "\n"
+       #endif
+        );
+
+// resolve the real function on first use, our hooks are hidden so dlsym never returns them,
+// and calls made by dlsym itself never reach them either.
+// NOTE: failures are not reported, as printing could allocate and end up here again
+template <typename Func>
+static inline Func getRealFunction(std::atomic<Func>& cache, const char* const name) noexcept
+{
+    Func func = cache.load(std::memory_order_relaxed);
+
+    if (func == nullptr)
+    {
+        func = reinterpret_cast<Func>(dlsym(RTLD_DEFAULT, name));
+        cache.store(func, std::memory_order_relaxed);
+    }
+
+    return func;
+}
+
+#define DISTRHO_RT_SAFETY_REAL_FUNC(Type, name) \
+    static std::atomic<Type> realFunc(nullptr); \
+    const Type func = getRealFunction(realFunc, name);
+
+typedef void* (*malloc_func)(size_t);
+typedef void (*free_func)(void*);
+
+extern "C" {
+
+void* malloc(const size_t size) __THROW
+{
+    DISTRHO_RT_SAFETY_CHECK_ALLOCATION("malloc")
+    DISTRHO_RT_SAFETY_REAL_FUNC(malloc_func, "malloc")
+    return func != nullptr ? func(size) : nullptr;
+}
+
+void* calloc(const size_t count, const size_t size) __THROW
+{
+    typedef void* (*calloc_func)(size_t, size_t);
+
+    DISTRHO_RT_SAFETY_CHECK_ALLOCATION("calloc")
+    DISTRHO_RT_SAFETY_REAL_FUNC(calloc_func, "calloc")
+    return func != nullptr ? func(count, size) : nullptr;
+}
+
+void* realloc(void* const ptr, const size_t size) __THROW
+{
+    typedef void* (*realloc_func)(void*, size_t);
+
+    DISTRHO_RT_SAFETY_CHECK_ALLOCATION("realloc")
+    DISTRHO_RT_SAFETY_REAL_FUNC(realloc_func, "realloc")
+    return func != nullptr ? func(ptr, size) : nullptr;
+}
+
+int posix_memalign(void** const ptr, const size_t alignment, const size_t size) __THROW
+{
+    typedef int (*posix_memalign_func)(void**, size_t, size_t);
+
+    DISTRHO_RT_SAFETY_CHECK_ALLOCATION("posix_memalign")
+    DISTRHO_RT_SAFETY_REAL_FUNC(posix_memalign_func, "posix_memalign")
+    return func != nullptr ? func(ptr, alignment, size) : ENOMEM;
+}
+
+void free(void* const ptr) __THROW
+{
+    if (ptr == nullptr)
+        return;
+
+    DISTRHO_RT_SAFETY_CHECK("free")
+    DISTRHO_RT_SAFETY_REAL_FUNC(free_func, "free")
+
+    if (func != nullptr)
+        func(ptr);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* const mutex) __THROW
+{
+    typedef int (*pthread_mutex_lock_func)(pthread_mutex_t*);
+
+    DISTRHO_RT_SAFETY_CHECK("pthread_mutex_lock")
+    DISTRHO_RT_SAFETY_REAL_FUNC(pthread_mutex_lock_func, "pthread_mutex_lock")
+    return func != nullptr ? func(mutex) : EINVAL;
+}
+
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// C++ allocation hooks
+
+typedef void* (*nothrow_new_func)(std::size_t, const std::nothrow_t&);
+typedef void (*nothrow_delete_func)(void*, const std::nothrow_t&);
+typedef void (*sized_delete_func)(void*, std::size_t);
+
+void* operator new(const std::size_t size)
+{
+    DISTRHO_RT_SAFETY_CHECK_ALLOCATION("operator new")
+    DISTRHO_RT_SAFETY_REAL_FUNC(malloc_func, "_Znw" DISTRHO_RT_SAFETY_SIZE_T)
+
+    if (func == nullptr)
+        throw std::bad_alloc();
+
+    return func(size);
+}
+
+void* operator new[](const std::size_t size)
+{
+    DISTRHO_RT_SAFETY_CHECK_ALLOCATION("operator new[]")
+    DISTRHO_RT_SAFETY_REAL_FUNC(malloc_func, "_Zna" DISTRHO_RT_SAFETY_SIZE_T)
+
+    if (func == nullptr)
+        throw std::bad_alloc();
+
+    return func(size);
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t& nt) noexcept
+{
+    DISTRHO_RT_SAFETY_CHECK_ALLOCATION("operator new")
+    DISTRHO_RT_SAFETY_REAL_FUNC(nothrow_new_func, "_Znw" DISTRHO_RT_SAFETY_SIZE_T "RKSt9nothrow_t")
+    return func != nullptr ? func(size, nt) : nullptr;
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t& nt) noexcept
+{
+    DISTRHO_RT_SAFETY_CHECK_ALLOCATION("operator new[]")
+    DISTRHO_RT_SAFETY_REAL_FUNC(nothrow_new_func, "_Zna" DISTRHO_RT_SAFETY_SIZE_T "RKSt9nothrow_t")
+    return func != nullptr ? func(size, nt) : nullptr;
+}
+
+void operator delete(void* const ptr) noexcept
+{
+    if (ptr == nullptr)
+        return;
+
+    DISTRHO_RT_SAFETY_CHECK("operator delete")
+    DISTRHO_RT_SAFETY_REAL_FUNC(free_func, "_ZdlPv")
+
+    if (func != nullptr)
+        func(ptr);
+}
+
+void operator delete[](void* const ptr) noexcept
+{
+    if (ptr == nullptr)
+        return;
+
+    DISTRHO_RT_SAFETY_CHECK("operator delete[]")
+    DISTRHO_RT_SAFETY_REAL_FUNC(free_func, "_ZdaPv")
+
+    if (func != nullptr)
+        func(ptr);
+}
+
+void operator delete(void* const ptr, const std::nothrow_t& nt) noexcept
+{
+    if (ptr == nullptr)
+        return;
+
+    DISTRHO_RT_SAFETY_CHECK("operator delete")
+    DISTRHO_RT_SAFETY_REAL_FUNC(nothrow_delete_func, "_ZdlPvRKSt9nothrow_t")
+
+    if (func != nullptr)
+        func(ptr, nt);
+}
+
+void operator delete[](void* const ptr, const std::nothrow_t& nt) noexcept
+{
+    if (ptr == nullptr)
+        return;
+
+    DISTRHO_RT_SAFETY_CHECK("operator delete[]")
+    DISTRHO_RT_SAFETY_REAL_FUNC(nothrow_delete_func, "_ZdaPvRKSt9nothrow_t")
+
+    if (func != nullptr)
+        func(ptr, nt);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void* const ptr, const std::size_t size) noexcept
+{
+    if (ptr == nullptr)
+        return;
+
+    DISTRHO_RT_SAFETY_CHECK("operator delete")
+    DISTRHO_RT_SAFETY_REAL_FUNC(sized_delete_func, "_ZdlPv" DISTRHO_RT_SAFETY_SIZE_T)
+
+    if (func != nullptr)
+        func(ptr, size);
+}
+
+void operator delete[](void* const ptr, const std::size_t size) noexcept
+{
+    if (ptr == nullptr)
+        return;
+
+    DISTRHO_RT_SAFETY_CHECK("operator delete[]")
+    DISTRHO_RT_SAFETY_REAL_FUNC(sized_delete_func, "_ZdaPv" DISTRHO_RT_SAFETY_SIZE_T)
+
+    if (func != nullptr)
+        func(ptr, size);
+}
+#endif
+
+#undef DISTRHO_RT_SAFETY_REAL_FUNC
+#undef DISTRHO_RT_SAFETY_SIZE_T
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#endif // DISTRHO_RT_SAFETY_HOOKS
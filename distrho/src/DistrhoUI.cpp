@@ -82,6 +82,10 @@ END_NAMESPACE_DISTRHO
 #include "src/WindowPrivateData.hpp"
 #include "DistrhoUIPrivateData.hpp"
 
+#if DISTRHO_PLUGIN_WANT_DIRECT_ACCESS && DISTRHO_PLUGIN_WANT_DSP_LOAD
+# include "DistrhoPlugin.hpp"
+#endif
+
 START_NAMESPACE_DISTRHO
 
 /* ------------------------------------------------------------------------------------------------------------
@@ -438,6 +442,15 @@ void* UI::getPluginInstancePointer() const noexcept
 {
     return uiData->dspPtr;
 }
+
+# if DISTRHO_PLUGIN_WANT_DSP_LOAD
+DspLoad UI::getDspLoad() const noexcept
+{
+    DISTRHO_SAFE_ASSERT_RETURN(uiData->dspPtr != nullptr, DspLoad());
+
+    return static_cast<const Plugin*>(uiData->dspPtr)->getDspLoad();
+}
+# endif
 #endif
 
 /* ------------------------------------------------------------------------------------------------------------
@@ -93,6 +93,7 @@ public:
           fURIDs(uridMap),
           fBypassParameterIndex(fUiPortMap != nullptr ? fUiPortMap->port_index(fUiPortMap->handle, ParameterDesignationSymbols::bypass_lv2)
                                                       : LV2UI_INVALID_PORT_INDEX),
+          fParameterPortEnd(UINT32_MAX),
           fWinIdWasNull(winId == 0),
           fUI(this, winId, sampleRate,
               editParameterCallback,
@@ -103,6 +104,18 @@ public:
               fileRequestCallback,
               bundlePath, dspPtr, scaleFactor, bgColor, fgColor, appClassName)
     {
+       #if DISTRHO_PLUGIN_WANT_OFFLINE_MODE
+        // the freewheel port comes right after the parameters, anything from there on is not a parameter.
+        // it is marked as notOnGUI, so hosts without ui:portMap are not expected to send it to us
+        if (fUiPortMap != nullptr)
+        {
+            const uint32_t freewheelPortIndex = fUiPortMap->port_index(fUiPortMap->handle, "lv2_freewheel");
+
+            if (freewheelPortIndex != LV2UI_INVALID_PORT_INDEX)
+                fParameterPortEnd = freewheelPortIndex;
+        }
+       #endif
+
         if (widget != nullptr)
             *widget = (LV2UI_Widget)fUI.getNativeWindowHandle();
 
@@ -161,7 +174,7 @@ public:
         {
             const uint32_t parameterOffset = fUI.getParameterOffset();
 
-            if (rindex < parameterOffset)
+            if (rindex < parameterOffset || rindex >= fParameterPortEnd)
                 return;
 
             DISTRHO_SAFE_ASSERT_RETURN(bufferSize == sizeof(float),)
@@ -348,6 +361,9 @@ private:
     // index of bypass parameter, if present
     const uint32_t fBypassParameterIndex;
 
+    // index of the first port after the parameters, UINT32_MAX if unknown
+    uint32_t fParameterPortEnd;
+
     // using ui:showInterface if true
     const bool fWinIdWasNull;
 
@@ -469,6 +469,28 @@ public:
             return V3_OK;
         }
 
+        if (std::strcmp(msgid, "parameter-set-batch") == 0)
+        {
+            const uint32_t* indexes;
+            const float* values;
+            uint32_t indexesSize, valuesSize;
+            v3_result res;
+
+            res = v3_cpp_obj(attrs)->get_binary(attrs, "indexes", (const void**)&indexes, &indexesSize);
+            DISTRHO_SAFE_ASSERT_INT_RETURN(res == V3_OK, res, res);
+
+            res = v3_cpp_obj(attrs)->get_binary(attrs, "values", (const void**)&values, &valuesSize);
+            DISTRHO_SAFE_ASSERT_INT_RETURN(res == V3_OK, res, res);
+
+            DISTRHO_SAFE_ASSERT_UINT2_RETURN(indexesSize / sizeof(uint32_t) == valuesSize / sizeof(float),
+                                             indexesSize, valuesSize, V3_INVALID_ARG);
+
+            for (uint32_t i=0, count=valuesSize / sizeof(float); i < count; ++i)
+                fUI.parameterChanged(indexes[i], values[i]);
+
+            return V3_OK;
+        }
+
        #if DISTRHO_PLUGIN_WANT_STATE
         if (std::strcmp(msgid, "state-set") == 0)
         {
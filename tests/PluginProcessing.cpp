@@ -0,0 +1,1301 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "distrho/src/DistrhoPluginInternal.hpp"
+#include "distrho/src/DistrhoPlugin.cpp"
+#include "distrho/extra/CpuDispatch.hpp"
+
+#define DISTRHO_IS_STANDALONE 1
+#include "distrho/src/DistrhoUtils.cpp"
+
+#ifdef DPF_RT_SAFETY_CHECKS
+# include "distrho/src/DistrhoRealtimeSafety.cpp"
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+// same as in tests.hpp, which cannot be used here as it requires linking to DGL
+#define DISTRHO_ASSERT_EQUAL(v1, v2, msg) \
+    if (v1 != v2) { d_stderr2("Test condition failed: %s; file:%s line:%i", msg, __FILE__, __LINE__); return 1; }
+
+#define DISTRHO_ASSERT_SAFE_EQUAL(v1, v2, msg) \
+    if (d_isNotEqual(v1, v2)) { d_stderr2("Test condition failed: %s; file:%s line:%i", msg, __FILE__, __LINE__); return 1; }
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static constexpr const double kSampleRate = 48000.0;
+static constexpr const uint32_t kBufferSize = 64;
+
+// plugin runs per host run without parameter changes
+#if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+static constexpr const uint32_t kRunsPerBuffer = kBufferSize / DISTRHO_PLUGIN_FIXED_BLOCK_SIZE;
+#else
+static constexpr const uint32_t kRunsPerBuffer = 1;
+#endif
+
+// 32 frames at kSampleRate
+static constexpr const float kSmoothingTime = 32.f / 48000.f;
+
+enum Parameters {
+    kParameterGain,
+    kParameterSmoothed,
+    kParameterLevel,
+    kParameterCount
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+// Gain kernels, with one variant per ISA level picked when the binary is loaded
+
+DISTRHO_CPU_DISPATCH
+static void applyGain(const float* const input, float* const output, const uint32_t frames, const float gain)
+{
+    for (uint32_t i=0; i < frames; ++i)
+        output[i] = input[i] * gain;
+}
+
+DISTRHO_CPU_DISPATCH
+static void applyGain(const double* const input, double* const output, const uint32_t frames, const float gain)
+{
+    for (uint32_t i=0; i < frames; ++i)
+        output[i] = input[i] * gain;
+}
+
+#if DISTRHO_CPU_TARGETS_AVAILABLE
+// same as above, only built for AVX2, must only be called after checking d_getCpuDispatchLevel()
+DISTRHO_CPU_TARGET_AVX2
+static void applyGainAVX2(const float* const input, float* const output, const uint32_t frames, const float gain)
+{
+    for (uint32_t i=0; i < frames; ++i)
+        output[i] = input[i] * gain;
+}
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+// Plugin that records what DPF passes to each run, so the test can verify blocks and events
+
+class ProcessingTestPlugin : public Plugin
+{
+public:
+    static constexpr const uint32_t kMaxRuns = 256;
+    static constexpr const uint32_t kMaxMidiEvents = DISTRHO_PLUGIN_MAX_MIDI_EVENTS;
+    static constexpr const uint32_t kMaxParallelTasks = 64;
+
+    struct RunInfo {
+        uint32_t frames;
+        uint32_t midiEventCount;
+        double sampleRate;
+    };
+
+    struct MidiEventInfo {
+        uint64_t frame; // since the plugin was activated, in plugin frames
+        uint8_t note;
+    };
+
+    RunInfo runs[kMaxRuns];
+    uint32_t runCount;
+
+    MidiEventInfo midiEvents[kMaxMidiEvents];
+    uint32_t midiEventCount;
+
+    // work scheduled on the next run, and what came back from the worker
+    std::atomic<uint32_t> pendingWork;
+    std::atomic<uint32_t> workRequest;
+    uint32_t workResponseValue;
+    uint32_t workResponseRunCount;
+
+    // parallel tasks to run on each run, and how many times each one was called
+    uint32_t parallelTaskCount;
+    uint32_t parallelTaskErrors;
+    std::atomic<uint32_t> parallelTaskCalls[kMaxParallelTasks];
+
+    // reported tail length, in frames
+    uint32_t tailLength;
+
+    // time to spend in each run, in microseconds
+    uint32_t runSleepTime;
+
+    // runs with 64-bit audio buffers
+    uint32_t doubleRunCount;
+
+    // processing mode changes received, and the mode seen by the last run
+    uint32_t processModeChangeCount;
+    bool runOffline;
+
+    // scratch buffers handed out during the last run, the last one being more than the arena can hold
+    float* scratchBuffers[3];
+    uint32_t scratchBufferSize;
+
+    // parameter changes received by the plugin, and how many groups of them
+    uint32_t parameterChangeCount;
+    uint32_t parameterBatchCount;
+
+    // parameters filled in by this instance
+    uint32_t initParameterCount;
+
+    // value reported through the level output on every run
+    float outputLevel;
+
+    // activate calls, and buffer size and sample rate changes received
+    uint32_t activateCount;
+    uint32_t bufferSizeChangeCount;
+    uint32_t sampleRateChangeCount;
+
+    ProcessingTestPlugin()
+        : Plugin(kParameterCount, 0, 0),
+          runCount(0),
+          midiEventCount(0),
+          pendingWork(0),
+          workRequest(0),
+          workResponseValue(0),
+          workResponseRunCount(0),
+          parallelTaskCount(0),
+          parallelTaskErrors(0),
+          tailLength(0),
+          runSleepTime(0),
+          doubleRunCount(0),
+          processModeChangeCount(0),
+          runOffline(false),
+          scratchBuffers(),
+          scratchBufferSize(0),
+          parameterChangeCount(0),
+          parameterBatchCount(0),
+          initParameterCount(0),
+          outputLevel(0.f),
+          activateCount(0),
+          bufferSizeChangeCount(0),
+          sampleRateChangeCount(0),
+          fFrame(0),
+          fGain(1.f),
+          fSmoothed(0.f)
+    {
+        for (uint32_t i=0; i < kMaxParallelTasks; ++i)
+            parallelTaskCalls[i] = 0;
+    }
+
+    void clearLog() noexcept
+    {
+        runCount = 0;
+        midiEventCount = 0;
+    }
+
+    // same as the plugin changing it from setParameterValue
+    void requestOversamplingFactor(const uint32_t factor) noexcept
+    {
+        setOversamplingFactor(factor);
+    }
+
+protected:
+    const char* getLabel() const override { return "PluginProcessing"; }
+    const char* getMaker() const override { return "DISTRHO"; }
+    const char* getLicense() const override { return "ISC"; }
+    uint32_t getVersion() const override { return d_version(1, 0, 0); }
+
+    void initParameter(const uint32_t index, Parameter& parameter) override
+    {
+        ++initParameterCount;
+
+        parameter.hints = kParameterIsAutomatable;
+
+        switch (index)
+        {
+        case kParameterGain:
+            parameter.name = "Gain";
+            parameter.symbol = "gain";
+            parameter.ranges.def = 1.f;
+            break;
+        case kParameterSmoothed:
+            parameter.hints |= kParameterIsSmoothed;
+            parameter.name = "Smoothed";
+            parameter.symbol = "smoothed";
+            parameter.ranges.def = 0.f;
+            parameter.smoothingTime = kSmoothingTime;
+            break;
+        case kParameterLevel:
+            parameter.hints = kParameterIsOutput;
+            parameter.name = "Level";
+            parameter.symbol = "level";
+            parameter.ranges.def = 0.f;
+            break;
+        }
+    }
+
+    float getParameterValue(const uint32_t index) const override
+    {
+        switch (index)
+        {
+        case kParameterGain:
+            return fGain;
+        case kParameterSmoothed:
+            return fSmoothed;
+        }
+
+        return 0.f;
+    }
+
+    void setParameterValue(const uint32_t index, const float value) override
+    {
+        ++parameterChangeCount;
+
+        switch (index)
+        {
+        case kParameterGain:
+            fGain = value;
+            break;
+        case kParameterSmoothed:
+            fSmoothed = value;
+            break;
+        }
+    }
+
+    void setParameterValues(const uint32_t* const indexes, const float* const values, const uint32_t count) override
+    {
+        ++parameterBatchCount;
+        Plugin::setParameterValues(indexes, values, count);
+    }
+
+    void activate() override
+    {
+        fFrame = 0;
+        ++activateCount;
+    }
+
+    void bufferSizeChanged(uint32_t) override
+    {
+        ++bufferSizeChangeCount;
+    }
+
+    void sampleRateChanged(double) override
+    {
+        ++sampleRateChangeCount;
+    }
+
+    void processModeChanged(const bool) override
+    {
+        ++processModeChangeCount;
+    }
+
+    uint32_t getTailLength() const override
+    {
+        return tailLength;
+    }
+
+    void run(const float** const inputs, float** const outputs, const uint32_t frames,
+             const MidiEvent* const events, const uint32_t eventCount) override
+    {
+        process(inputs, outputs, frames, events, eventCount);
+    }
+
+    void run(const double** const inputs, double** const outputs, const uint32_t frames,
+             const MidiEvent* const events, const uint32_t eventCount) override
+    {
+        ++doubleRunCount;
+        process(inputs, outputs, frames, events, eventCount);
+    }
+
+    template<typename T>
+    void process(const T** const inputs, T** const outputs, const uint32_t frames,
+                 const MidiEvent* const events, const uint32_t eventCount)
+    {
+        if (const uint32_t work = pendingWork.exchange(0))
+            scheduleWork(&work, sizeof(work));
+
+        // every task must have been called exactly once when executeParallel returns
+        if (parallelTaskCount != 0)
+        {
+            for (uint32_t i=0; i < parallelTaskCount; ++i)
+                parallelTaskCalls[i] = 0;
+
+            executeParallel(parallelTaskCount, parallelTask, this);
+
+            for (uint32_t i=0; i < parallelTaskCount; ++i)
+            {
+                if (parallelTaskCalls[i] != 1)
+                    ++parallelTaskErrors;
+            }
+        }
+
+        runOffline = isOffline();
+
+        if (runSleepTime != 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(runSleepTime));
+
+        // only reported to the host when different from the last value
+        setOutputParameterValue(kParameterLevel, outputLevel);
+
+        if (runCount < kMaxRuns)
+        {
+            RunInfo& info(runs[runCount++]);
+            info.frames = frames;
+            info.midiEventCount = eventCount;
+            info.sampleRate = getSampleRate();
+        }
+
+        for (uint32_t i=0; i < eventCount && midiEventCount < kMaxMidiEvents; ++i)
+        {
+            MidiEventInfo& info(midiEvents[midiEventCount++]);
+            info.frame = fFrame + events[i].frame;
+            info.note = events[i].data[1];
+        }
+
+        // output 0 is the input with the current gain
+        applyGain(inputs[0], outputs[0], frames, fGain);
+
+        scratchBufferSize = getBufferSize();
+        scratchBuffers[0] = getScratchBuffer(scratchBufferSize);
+        scratchBuffers[1] = getScratchBuffer(scratchBufferSize);
+        scratchBuffers[2] = getScratchBuffer(scratchBufferSize * 64);
+
+        // output 1 is the smoothed parameter ramp
+        const float* const ramp = getParameterRamp(kParameterSmoothed);
+        DISTRHO_SAFE_ASSERT_RETURN(ramp != nullptr,);
+
+        for (uint32_t i=0; i < frames; ++i)
+            outputs[1][i] = ramp[i];
+
+        fFrame += frames;
+    }
+
+    // worker thread, doubles the requested value
+    void work(const void* const data, const uint32_t size) override
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(size == sizeof(uint32_t),);
+
+        const uint32_t value = *static_cast<const uint32_t*>(data);
+        workRequest = value;
+
+        const uint32_t response = value * 2;
+        sendWorkResponse(&response, sizeof(response));
+    }
+
+    void workResponse(const void* const data, const uint32_t size) override
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(size == sizeof(uint32_t),);
+
+        workResponseValue = *static_cast<const uint32_t*>(data);
+        workResponseRunCount = runCount;
+    }
+
+    static void parallelTask(void* const ptr, const uint32_t taskIndex)
+    {
+        ProcessingTestPlugin* const self = static_cast<ProcessingTestPlugin*>(ptr);
+        self->parallelTaskCalls[taskIndex].fetch_add(1);
+    }
+
+private:
+    uint64_t fFrame;
+    float fGain;
+    float fSmoothed;
+};
+
+Plugin* createPlugin()
+{
+    return new ProcessingTestPlugin();
+}
+
+END_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+// Host side helpers
+
+USE_NAMESPACE_DISTRHO
+
+struct TestHost {
+    PluginExporter plugin;
+    ProcessingTestPlugin* instance;
+    float input[kBufferSize];
+    float output0[kBufferSize];
+    float output1[kBufferSize];
+
+    TestHost()
+        : plugin(nullptr, nullptr, nullptr, nullptr),
+          instance(static_cast<ProcessingTestPlugin*>(static_cast<Plugin*>(plugin.getInstancePointer())))
+    {
+        std::memset(input, 0, sizeof(input));
+        std::memset(output0, 0, sizeof(output0));
+        std::memset(output1, 0, sizeof(output1));
+    }
+
+    void run(const uint32_t frames, const MidiEvent* const midiEvents = nullptr, const uint32_t midiEventCount = 0)
+    {
+        const float* inputs[DISTRHO_PLUGIN_NUM_INPUTS] = { input };
+        float* outputs[DISTRHO_PLUGIN_NUM_OUTPUTS] = { output0, output1 };
+        plugin.run(inputs, outputs, frames, midiEvents, midiEventCount);
+    }
+};
+
+static void setupMidiEvent(MidiEvent& midiEvent, const uint32_t frame, const uint8_t note)
+{
+    midiEvent.frame = frame;
+    midiEvent.size = 3;
+    midiEvent.data[0] = 0x90;
+    midiEvent.data[1] = note;
+    midiEvent.data[2] = 100;
+    midiEvent.data[3] = 0;
+    midiEvent.dataExt = nullptr;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE == 0
+// sample-accurate parameter changes split the plugin run, MIDI events are moved into each split
+static int testSampleAccurateParameters()
+{
+    TestHost host;
+    ProcessingTestPlugin& instance(*host.instance);
+
+    for (uint32_t i=0; i < kBufferSize; ++i)
+        host.input[i] = static_cast<float>(i + 1);
+
+    host.plugin.activate();
+
+    host.run(kBufferSize);
+    DISTRHO_ASSERT_EQUAL(instance.runCount, 1, "plain block is not split");
+    DISTRHO_ASSERT_EQUAL(instance.runs[0].frames, kBufferSize, "plain block runs in full");
+    DISTRHO_ASSERT_SAFE_EQUAL(host.output0[kBufferSize - 1], static_cast<float>(kBufferSize), "default gain applied");
+
+    instance.clearLog();
+
+    MidiEvent midiEvents[3];
+    setupMidiEvent(midiEvents[0], 2, 60);
+    setupMidiEvent(midiEvents[1], 16, 61);
+    setupMidiEvent(midiEvents[2], 50, 62);
+
+    // changes at frame 0 apply right away, they do not need a split
+    host.plugin.setParameterValueAtFrame(0, kParameterGain, 2.f);
+    host.plugin.setParameterValueAtFrame(16, kParameterGain, 0.5f);
+    host.plugin.setParameterValueAtFrame(40, kParameterGain, 0.25f);
+    host.run(kBufferSize, midiEvents, 3);
+
+    DISTRHO_ASSERT_EQUAL(instance.runCount, 3, "block split at each parameter change");
+    DISTRHO_ASSERT_EQUAL(instance.runs[0].frames, 16, "first split ends at the first parameter change");
+    DISTRHO_ASSERT_EQUAL(instance.runs[1].frames, 24, "second split ends at the second parameter change");
+    DISTRHO_ASSERT_EQUAL(instance.runs[2].frames, 24, "last split runs until the end of the block");
+    DISTRHO_ASSERT_EQUAL(instance.runs[0].midiEventCount, 1, "first split gets the events before the change");
+    DISTRHO_ASSERT_EQUAL(instance.runs[1].midiEventCount, 1, "event at the change frame goes into the next split");
+    DISTRHO_ASSERT_EQUAL(instance.runs[2].midiEventCount, 1, "last split gets the remaining events");
+
+    DISTRHO_ASSERT_EQUAL(instance.midiEventCount, 3, "all MIDI events received");
+
+    for (uint32_t i=0; i < 3; ++i)
+    {
+        DISTRHO_ASSERT_EQUAL(instance.midiEvents[i].note, midiEvents[i].data[1], "MIDI events received in order");
+        DISTRHO_ASSERT_EQUAL(instance.midiEvents[i].frame, kBufferSize + midiEvents[i].frame,
+                             "MIDI event frames are relative to each split");
+    }
+
+    for (uint32_t i=0; i < kBufferSize; ++i)
+    {
+        const float gain = i < 16 ? 2.f : i < 40 ? 0.5f : 0.25f;
+        DISTRHO_ASSERT_SAFE_EQUAL(host.output0[i], host.input[i] * gain, "gain changes at the exact frame");
+    }
+
+    // changes past the end of the block are applied after it, and after any earlier change queued later
+    instance.clearLog();
+    host.plugin.setParameterValueAtFrame(kBufferSize + 8, kParameterGain, 1.f);
+    host.plugin.setParameterValueAtFrame(32, kParameterGain, 0.5f);
+    host.run(kBufferSize);
+
+    DISTRHO_ASSERT_EQUAL(instance.runCount, 2, "change past the end does not split the block");
+    DISTRHO_ASSERT_SAFE_EQUAL(host.output0[31], host.input[31] * 0.25f, "earlier change is not applied early");
+    DISTRHO_ASSERT_SAFE_EQUAL(host.output0[kBufferSize - 1], host.input[kBufferSize - 1] * 0.5f,
+                              "change past the end is not applied early");
+    DISTRHO_ASSERT_SAFE_EQUAL(host.plugin.getParameterValue(kParameterGain), 1.f, "change past the end is applied last");
+
+    return 0;
+}
+
+// more MIDI events than a single run can take are split across runs, none are dropped or delayed
+static int testMidiEventSplit()
+{
+    TestHost host;
+    ProcessingTestPlugin& instance(*host.instance);
+
+    static constexpr const uint32_t kEventsPerFrame = kMaxMidiEventsPerRun + kMaxMidiEventsPerRun / 4;
+    static constexpr const uint32_t kEventFrameCount = 3;
+    static constexpr const uint32_t kEventFrames[kEventFrameCount] = { 0, 10, kBufferSize - 1 };
+    static constexpr const uint32_t kEventCount = kEventsPerFrame * kEventFrameCount;
+    static MidiEvent midiEvents[kEventCount];
+
+    // notes must not repeat every kMaxMidiEventsPerRun events, or a repeated event would go unnoticed
+    for (uint32_t i=0; i < kEventCount; ++i)
+        setupMidiEvent(midiEvents[i], kEventFrames[i / kEventsPerFrame], static_cast<uint8_t>((i / 5) & 0x7f));
+
+    host.plugin.activate();
+    host.run(kBufferSize, midiEvents, kEventCount);
+
+    DISTRHO_ASSERT_EQUAL(instance.midiEventCount, kEventCount, "all MIDI events received");
+
+    for (uint32_t i=0; i < kEventCount; ++i)
+    {
+        DISTRHO_ASSERT_EQUAL(instance.midiEvents[i].note, midiEvents[i].data[1], "MIDI events received in order");
+        DISTRHO_ASSERT_EQUAL(instance.midiEvents[i].frame, midiEvents[i].frame, "MIDI events received on their frame");
+    }
+
+    uint32_t frames = 0;
+
+    for (uint32_t i=0; i < instance.runCount; ++i)
+    {
+        DISTRHO_ASSERT_EQUAL((instance.runs[i].midiEventCount <= kMaxMidiEventsPerRun), true,
+                             "no run gets more events than the limit");
+        frames += instance.runs[i].frames;
+    }
+
+    DISTRHO_ASSERT_EQUAL(frames, kBufferSize, "splits cover the whole block");
+
+    return 0;
+}
+
+// smoothed parameters get a linear ramp over their smoothing time, carried across runs
+static int testParameterSmoothing()
+{
+    TestHost host;
+
+    host.plugin.activate();
+    host.run(kBufferSize);
+
+    for (uint32_t i=0; i < kBufferSize; ++i)
+        DISTRHO_ASSERT_SAFE_EQUAL(host.output1[i], 0.f, "ramp starts at the default value");
+
+    // change in the middle of a block, ramp crosses into the next one
+    host.plugin.setParameterValueAtFrame(48, kParameterSmoothed, 1.f);
+    host.run(kBufferSize);
+
+    for (uint32_t i=0; i < 48; ++i)
+        DISTRHO_ASSERT_SAFE_EQUAL(host.output1[i], 0.f, "ramp does not start before the change");
+
+    for (uint32_t i=48; i < kBufferSize; ++i)
+    {
+        const float expected = static_cast<float>(i - 47) / 32.f;
+        DISTRHO_ASSERT_EQUAL((std::fabs(host.output1[i] - expected) < 1e-5f), true, "ramp is linear");
+    }
+
+    host.run(kBufferSize);
+
+    for (uint32_t i=0; i < 16; ++i)
+    {
+        const float expected = static_cast<float>(i + 17) / 32.f;
+        DISTRHO_ASSERT_EQUAL((std::fabs(host.output1[i] - expected) < 1e-5f), true, "ramp continues in next run");
+    }
+
+    for (uint32_t i=16; i < kBufferSize; ++i)
+        DISTRHO_ASSERT_SAFE_EQUAL(host.output1[i], 1.f, "ramp stops at the target value");
+
+    // reactivating starts from the current value, without ramping
+    host.plugin.deactivate();
+    host.plugin.setParameterValue(kParameterSmoothed, 0.5f);
+    host.plugin.activate();
+    host.run(kBufferSize);
+
+    for (uint32_t i=0; i < kBufferSize; ++i)
+        DISTRHO_ASSERT_SAFE_EQUAL(host.output1[i], 0.5f, "no ramp after activation");
+
+    host.plugin.deactivate();
+    return 0;
+}
+#else
+// audio and MIDI are buffered so the plugin always runs with the same number of frames, one block later
+static int testFixedBlockSize()
+{
+    static constexpr const uint32_t kHostFrames = 20;
+    static constexpr const uint32_t kHostRuns = 8;
+
+    TestHost host;
+    ProcessingTestPlugin& instance(*host.instance);
+
+    float output[kHostFrames * kHostRuns];
+
+    host.plugin.setBufferSize(kHostFrames);
+    host.plugin.activate();
+
+    DISTRHO_ASSERT_EQUAL(host.plugin.getLatency(), kFixedBlockSize, "one block of latency is reported");
+
+    MidiEvent midiEvent;
+    setupMidiEvent(midiEvent, 5, 60);
+
+    for (uint32_t r=0; r < kHostRuns; ++r)
+    {
+        for (uint32_t i=0; i < kHostFrames; ++i)
+            host.input[i] = static_cast<float>(r * kHostFrames + i + 1);
+
+        // change gain in the middle of the 3rd host run, which is applied before the next plugin block
+        if (r == 2)
+            host.plugin.setParameterValueAtFrame(10, kParameterGain, 0.5f);
+
+        host.run(kHostFrames, &midiEvent, r == 1 ? 1 : 0);
+        std::memcpy(output + r * kHostFrames, host.output0, sizeof(float) * kHostFrames);
+    }
+
+    DISTRHO_ASSERT_EQUAL(instance.runCount, kHostFrames * kHostRuns / kFixedBlockSize, "plugin runs once per full block");
+
+    for (uint32_t i=0; i < instance.runCount; ++i)
+        DISTRHO_ASSERT_EQUAL(instance.runs[i].frames, kFixedBlockSize, "plugin always runs in fixed blocks");
+
+    DISTRHO_ASSERT_EQUAL(instance.midiEventCount, 1, "MIDI event received");
+    DISTRHO_ASSERT_EQUAL(instance.midiEvents[0].frame, kHostFrames + 5, "MIDI event keeps its position in the stream");
+
+    for (uint32_t i=0; i < kFixedBlockSize; ++i)
+        DISTRHO_ASSERT_SAFE_EQUAL(output[i], 0.f, "first block is silent while buffering");
+
+    for (uint32_t i=kFixedBlockSize; i < kHostFrames * kHostRuns; ++i)
+    {
+        // the plugin block holding host frames [32, 64) runs after the gain change
+        const float gain = i < kFixedBlockSize * 2 ? 1.f : 0.5f;
+        DISTRHO_ASSERT_SAFE_EQUAL(output[i], static_cast<float>(i - kFixedBlockSize + 1) * gain,
+                                  "output is delayed by one block, gain changes between blocks");
+    }
+
+    host.plugin.deactivate();
+    return 0;
+}
+#endif
+
+// work scheduled from run() is done on the worker thread, its response is received before the next run
+static int testWorker()
+{
+    TestHost host;
+    ProcessingTestPlugin& instance(*host.instance);
+
+    host.plugin.activate();
+
+    instance.pendingWork = 21;
+    host.run(kBufferSize);
+    DISTRHO_ASSERT_EQUAL(instance.pendingWork.load(), 0, "work scheduled during run");
+
+    // give the worker thread up to 2 seconds
+    for (int i=0; i < 200 && instance.workResponseValue == 0; ++i)
+    {
+        d_msleep(10);
+        host.run(kBufferSize);
+    }
+
+    DISTRHO_ASSERT_EQUAL(instance.workRequest.load(), 21, "worker received the scheduled data");
+    DISTRHO_ASSERT_EQUAL(instance.workResponseValue, 42, "response received on the audio side");
+    DISTRHO_ASSERT_EQUAL(instance.workResponseRunCount, instance.runCount - kRunsPerBuffer,
+                         "response received before a host run");
+
+    host.plugin.deactivate();
+    return 0;
+}
+
+// parallel tasks are each called once per executeParallel call, with 2 instances using the thread pool at once
+static void runThreadPoolHost(TestHost* const host)
+{
+    for (uint32_t i=0; i < 2000; ++i)
+    {
+        // vary the task count, so late workers from a previous call would see different task data
+        host->instance->parallelTaskCount = 1 + (i % ProcessingTestPlugin::kMaxParallelTasks);
+        host->run(kBufferSize);
+    }
+}
+
+static int testThreadPool()
+{
+    TestHost hosts[2];
+
+    for (TestHost& host : hosts)
+        host.plugin.activate();
+
+    std::thread thread(runThreadPoolHost, &hosts[1]);
+    runThreadPoolHost(&hosts[0]);
+    thread.join();
+
+    for (TestHost& host : hosts)
+    {
+        DISTRHO_ASSERT_EQUAL(host.instance->parallelTaskErrors, 0, "each task called once per execute");
+        host.plugin.deactivate();
+    }
+
+    return 0;
+}
+
+#if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE == 0
+// the plugin runs at a multiple of the host rate, factor changes made while active wait for the next deactivation
+static int testOversampling()
+{
+    static constexpr const uint32_t kFactor = 2;
+
+    TestHost host;
+    ProcessingTestPlugin& instance(*host.instance);
+
+    for (uint32_t i=0; i < kBufferSize; ++i)
+        host.input[i] = 1.f;
+
+    host.plugin.activate();
+    host.run(kBufferSize);
+
+    // nothing changes on the audio thread
+    instance.requestOversamplingFactor(kFactor);
+    instance.clearLog();
+    host.run(kBufferSize);
+
+    DISTRHO_ASSERT_EQUAL(instance.runs[0].frames, kBufferSize, "factor kept while active");
+    DISTRHO_ASSERT_EQUAL(instance.activateCount, 1, "not reactivated while active");
+    DISTRHO_ASSERT_EQUAL(instance.bufferSizeChangeCount, 0, "no buffer size change while active");
+
+    // nor when the host sets buffer size or sample rate while active
+    host.plugin.setBufferSize(kBufferSize, true);
+    host.plugin.setSampleRate(kSampleRate, true);
+    instance.clearLog();
+    host.run(kBufferSize);
+
+    DISTRHO_ASSERT_EQUAL(instance.runs[0].frames, kBufferSize, "factor kept on host changes while active");
+    DISTRHO_ASSERT_EQUAL(instance.activateCount, 1, "not reactivated on host changes while active");
+    DISTRHO_ASSERT_EQUAL(instance.bufferSizeChangeCount, 0, "no buffer size change on host changes while active");
+
+    host.plugin.deactivate();
+    DISTRHO_ASSERT_EQUAL(instance.bufferSizeChangeCount, 1, "buffer size change on deactivation");
+    DISTRHO_ASSERT_EQUAL(instance.sampleRateChangeCount, 1, "sample rate change on deactivation");
+
+    host.plugin.activate();
+    instance.clearLog();
+
+    MidiEvent midiEvents[2];
+    setupMidiEvent(midiEvents[0], 10, 60);
+    setupMidiEvent(midiEvents[1], 20, 61);
+
+    // enough runs for the resampling filters to settle
+    for (uint32_t r=0; r < 8; ++r)
+        host.run(kBufferSize, midiEvents, r == 0 ? 2 : 0);
+
+    DISTRHO_ASSERT_EQUAL(instance.runCount, 8, "one plugin run per host run");
+
+    for (uint32_t i=0; i < instance.runCount; ++i)
+    {
+        DISTRHO_ASSERT_EQUAL(instance.runs[i].frames, kBufferSize * kFactor, "plugin runs with oversampled frames");
+        DISTRHO_ASSERT_SAFE_EQUAL(instance.runs[i].sampleRate, kSampleRate * kFactor, "plugin sees oversampled rate");
+    }
+
+    DISTRHO_ASSERT_EQUAL(instance.midiEventCount, 2, "MIDI events received");
+    DISTRHO_ASSERT_EQUAL(instance.midiEvents[0].frame, 10 * kFactor, "MIDI event frames are scaled");
+    DISTRHO_ASSERT_EQUAL(instance.midiEvents[1].frame, 20 * kFactor, "MIDI event frames are scaled");
+
+    for (uint32_t i=0; i < kBufferSize; ++i)
+        DISTRHO_ASSERT_EQUAL((std::fabs(host.output0[i] - 1.f) < 1e-3f), true, "DC input passes through unchanged");
+
+    // blocks bigger than the buffer size are skipped, with silent output
+    host.plugin.deactivate();
+    host.plugin.setBufferSize(kBufferSize / 2, true);
+    host.plugin.activate();
+    instance.clearLog();
+    host.run(kBufferSize);
+
+    DISTRHO_ASSERT_EQUAL(instance.runCount, 0, "oversized block is not run");
+    DISTRHO_ASSERT_SAFE_EQUAL(host.output0[kBufferSize - 1], 0.f, "oversized block is silent");
+
+    host.plugin.deactivate();
+    return 0;
+}
+#endif
+
+#if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE == 0
+// host changes only reach the plugin at the start of the next run, the last one wins
+static int testPendingParameters()
+{
+    TestHost host;
+    ProcessingTestPlugin& instance(*host.instance);
+
+    for (uint32_t i=0; i < kBufferSize; ++i)
+        host.input[i] = 1.f;
+
+    host.plugin.activate();
+    host.run(kBufferSize);
+
+    const uint32_t parameterChangeCount = instance.parameterChangeCount;
+
+    host.plugin.setParameterValue(kParameterGain, 2.f);
+    host.plugin.setParameterValue(kParameterGain, 0.5f);
+    DISTRHO_ASSERT_EQUAL(instance.parameterChangeCount, parameterChangeCount, "plugin not called outside of run");
+    DISTRHO_ASSERT_SAFE_EQUAL(host.plugin.getParameterValue(kParameterGain), 0.5f, "host sees the pending value");
+
+    host.run(kBufferSize);
+    DISTRHO_ASSERT_EQUAL(instance.parameterChangeCount, parameterChangeCount + 1, "only the last value is applied");
+    DISTRHO_ASSERT_SAFE_EQUAL(host.output0[0], 0.5f, "pending value applied before the run");
+
+    // a timed change from the audio thread is newer than a pending one
+    host.plugin.setParameterValue(kParameterGain, 2.f);
+    host.plugin.setParameterValueAtFrame(16, kParameterGain, 0.25f);
+    host.run(kBufferSize);
+
+    DISTRHO_ASSERT_SAFE_EQUAL(host.output0[15], 0.5f, "pending value dropped");
+    DISTRHO_ASSERT_SAFE_EQUAL(host.output0[16], 0.25f, "timed change applied");
+
+    // values set while inactive reach the plugin on activation
+    host.plugin.deactivate();
+    host.plugin.setParameterValue(kParameterGain, 1.f);
+    host.plugin.activate();
+    DISTRHO_ASSERT_EQUAL(instance.parameterChangeCount, parameterChangeCount + 3, "pending value applied on activation");
+
+    host.plugin.deactivate();
+    return 0;
+}
+#endif
+
+// only outputs that changed since the last check are reported
+static int testOutputParameters()
+{
+    TestHost host;
+    ProcessingTestPlugin& instance(*host.instance);
+
+    // initial values are reported once
+    uint32_t index = 0;
+    DISTRHO_ASSERT_EQUAL(host.plugin.getNextChangedParameter(index), true, "initial value reported");
+    DISTRHO_ASSERT_EQUAL(index, static_cast<uint32_t>(kParameterLevel), "initial value index");
+    ++index;
+    DISTRHO_ASSERT_EQUAL(host.plugin.getNextChangedParameter(index), false, "initial value only reported once");
+
+    host.plugin.activate();
+
+    // same value, nothing to report
+    host.run(kBufferSize);
+    index = 0;
+    DISTRHO_ASSERT_EQUAL(host.plugin.getNextChangedParameter(index), false, "unchanged output");
+
+    instance.outputLevel = 0.5f;
+    host.run(kBufferSize);
+    index = 0;
+    DISTRHO_ASSERT_EQUAL(host.plugin.getNextChangedParameter(index), true, "changed output reported");
+    DISTRHO_ASSERT_EQUAL(index, static_cast<uint32_t>(kParameterLevel), "changed output index");
+    DISTRHO_ASSERT_SAFE_EQUAL(host.plugin.getParameterValue(kParameterLevel), 0.5f, "changed output value");
+    ++index;
+    DISTRHO_ASSERT_EQUAL(host.plugin.getNextChangedParameter(index), false, "changed output only reported once");
+
+    host.plugin.deactivate();
+    return 0;
+}
+
+// parameter symbols resolve to their index, unknown ones do not
+static int testParameterSymbols()
+{
+    TestHost host;
+
+    uint32_t index = kParameterCount;
+    DISTRHO_ASSERT_EQUAL(host.plugin.getParameterIndexForSymbol("gain", index), true, "first symbol found");
+    DISTRHO_ASSERT_EQUAL(index, static_cast<uint32_t>(kParameterGain), "first symbol index");
+    DISTRHO_ASSERT_EQUAL(host.plugin.getParameterIndexForSymbol("smoothed", index), true, "middle symbol found");
+    DISTRHO_ASSERT_EQUAL(index, static_cast<uint32_t>(kParameterSmoothed), "middle symbol index");
+    DISTRHO_ASSERT_EQUAL(host.plugin.getParameterIndexForSymbol("level", index), true, "output symbol found");
+    DISTRHO_ASSERT_EQUAL(index, static_cast<uint32_t>(kParameterLevel), "output symbol index");
+
+    // sorted before, after and in between the known symbols
+    DISTRHO_ASSERT_EQUAL(host.plugin.getParameterIndexForSymbol("a", index), false, "symbol before first");
+    DISTRHO_ASSERT_EQUAL(host.plugin.getParameterIndexForSymbol("z", index), false, "symbol after last");
+    DISTRHO_ASSERT_EQUAL(host.plugin.getParameterIndexForSymbol("gai", index), false, "symbol prefix");
+    DISTRHO_ASSERT_EQUAL(host.plugin.getParameterIndexForSymbol("", index), false, "empty symbol");
+
+    return 0;
+}
+
+// every host block is timed against its real-time budget
+static int testDspLoad()
+{
+    TestHost host;
+    ProcessingTestPlugin& instance(*host.instance);
+
+    DISTRHO_ASSERT_EQUAL(host.plugin.getDspLoad().blockCount, 0, "nothing measured before processing");
+
+    // at least 1ms for a 64 frames block at 48kHz, which has a budget of 1.33ms
+    instance.runSleepTime = 1000;
+
+    host.plugin.activate();
+
+    for (uint32_t i=0; i < 8; ++i)
+        host.run(kBufferSize);
+
+    const DspLoad dspLoad(host.plugin.getDspLoad());
+    DISTRHO_ASSERT_EQUAL(dspLoad.blockCount, 8, "one measurement per host block");
+    DISTRHO_ASSERT_EQUAL((dspLoad.minimum >= 0.7f), true, "time spent in run is measured");
+    DISTRHO_ASSERT_EQUAL((dspLoad.minimum <= dspLoad.average), true, "average above minimum");
+    DISTRHO_ASSERT_EQUAL((dspLoad.average <= dspLoad.maximum), true, "average below maximum");
+    DISTRHO_ASSERT_EQUAL((dspLoad.minimum <= dspLoad.p99 && dspLoad.p99 <= dspLoad.maximum), true, "p99 within range");
+
+    // measurements start over on activation
+    host.plugin.deactivate();
+    host.plugin.activate();
+    DISTRHO_ASSERT_EQUAL(host.plugin.getDspLoad().blockCount, 0, "reset on activation");
+
+    host.plugin.deactivate();
+    return 0;
+}
+
+// only the first of several instances fills in the parameters, all share them
+static int testSharedParameters()
+{
+    {
+        TestHost host1;
+        DISTRHO_ASSERT_EQUAL(host1.instance->initParameterCount, kParameterCount, "first instance fills in");
+
+        TestHost host2;
+        DISTRHO_ASSERT_EQUAL(host2.instance->initParameterCount, 0, "second instance reuses");
+        DISTRHO_ASSERT_EQUAL(&host2.plugin.getParameterSymbol(kParameterLevel),
+                             &host1.plugin.getParameterSymbol(kParameterLevel), "same parameter data");
+        DISTRHO_ASSERT_EQUAL(host2.plugin.isParameterOutput(kParameterLevel), true, "shared hints");
+
+        uint32_t index = kParameterCount;
+        DISTRHO_ASSERT_EQUAL(host2.plugin.getParameterIndexForSymbol("level", index), true, "shared symbol index");
+        DISTRHO_ASSERT_EQUAL(index, static_cast<uint32_t>(kParameterLevel), "shared symbol index value");
+
+        // values stay per instance
+        host1.plugin.activate();
+        host2.plugin.activate();
+        host1.plugin.setParameterValue(kParameterGain, 0.5f);
+        host1.run(kBufferSize);
+        host2.run(kBufferSize);
+        DISTRHO_ASSERT_SAFE_EQUAL(host2.plugin.getParameterValue(kParameterGain), 1.f, "separate values");
+        host1.plugin.deactivate();
+        host2.plugin.deactivate();
+    }
+
+    // filled in again once all previous instances are gone
+    TestHost host;
+    DISTRHO_ASSERT_EQUAL(host.instance->initParameterCount, kParameterCount, "new first instance fills in");
+
+    return 0;
+}
+
+// 64-bit buffers go through the plugin's double run without losing precision
+static int testDoublePrecision()
+{
+    TestHost host;
+    ProcessingTestPlugin& instance(*host.instance);
+
+    // not representable as float
+    const double value = 1.0 + 1e-12;
+
+    double input[kBufferSize];
+    double output0[kBufferSize];
+    double output1[kBufferSize];
+
+    for (uint32_t i=0; i < kBufferSize; ++i)
+        input[i] = value;
+
+    const double* inputs[DISTRHO_PLUGIN_NUM_INPUTS] = { input };
+    double* outputs[DISTRHO_PLUGIN_NUM_OUTPUTS] = { output0, output1 };
+
+    host.plugin.activate();
+
+    // enough runs for the fixed block size latency to be gone
+    for (uint32_t i=0; i < 3; ++i)
+        host.plugin.run(inputs, outputs, kBufferSize, nullptr, 0);
+
+    DISTRHO_ASSERT_EQUAL(instance.doubleRunCount, instance.runCount, "only the double run is used");
+    DISTRHO_ASSERT_EQUAL(instance.runCount, kRunsPerBuffer * 3, "double run called for every block");
+
+    for (uint32_t i=0; i < kBufferSize; ++i)
+    {
+        DISTRHO_ASSERT_EQUAL(output0[i], value, "double precision kept");
+    }
+
+    host.plugin.deactivate();
+    return 0;
+}
+
+// host changes made together reach the plugin as a single batch
+static int testParameterBatches()
+{
+    TestHost host;
+    ProcessingTestPlugin& instance(*host.instance);
+
+    host.plugin.activate();
+    host.run(kBufferSize);
+
+    const uint32_t parameterChangeCount = instance.parameterChangeCount;
+    const uint32_t parameterBatchCount = instance.parameterBatchCount;
+
+    const uint32_t indexes[2] = { kParameterGain, kParameterSmoothed };
+    const float values[2] = { 0.5f, 0.25f };
+    host.plugin.setParameterValues(indexes, values, 2);
+
+    // separate changes from the host are batched too
+    host.plugin.setParameterValue(kParameterGain, 0.75f);
+
+    host.run(kBufferSize);
+    DISTRHO_ASSERT_EQUAL(instance.parameterBatchCount, parameterBatchCount + 1, "single batch");
+    DISTRHO_ASSERT_EQUAL(instance.parameterChangeCount, parameterChangeCount + 2, "one change per parameter");
+    DISTRHO_ASSERT_SAFE_EQUAL(host.plugin.getParameterValue(kParameterGain), 0.75f, "last value applied");
+    DISTRHO_ASSERT_SAFE_EQUAL(host.plugin.getParameterValue(kParameterSmoothed), 0.25f, "batched value applied");
+
+    // nothing pending, nothing sent
+    host.run(kBufferSize);
+    DISTRHO_ASSERT_EQUAL(instance.parameterBatchCount, parameterBatchCount + 1, "no empty batch");
+
+    host.plugin.deactivate();
+    return 0;
+}
+
+// scratch buffers are aligned, do not overlap and reuse the same memory on every run
+static int testScratchBuffers()
+{
+    TestHost host;
+    ProcessingTestPlugin& instance(*host.instance);
+
+    host.plugin.activate();
+    host.run(kBufferSize);
+
+    float* const buffer0 = instance.scratchBuffers[0];
+    float* const buffer1 = instance.scratchBuffers[1];
+
+    DISTRHO_ASSERT_EQUAL((buffer0 != nullptr && buffer1 != nullptr), true, "scratch buffers available");
+    DISTRHO_ASSERT_EQUAL(reinterpret_cast<uintptr_t>(buffer0) % 64, 0, "scratch buffers are aligned");
+    DISTRHO_ASSERT_EQUAL(reinterpret_cast<uintptr_t>(buffer1) % 64, 0, "scratch buffers are aligned");
+    DISTRHO_ASSERT_EQUAL((buffer1 >= buffer0 + instance.scratchBufferSize), true, "scratch buffers do not overlap");
+    DISTRHO_ASSERT_EQUAL(instance.scratchBuffers[2], static_cast<float*>(nullptr), "no buffer bigger than the arena");
+
+    host.run(kBufferSize);
+    DISTRHO_ASSERT_EQUAL(instance.scratchBuffers[0], buffer0, "memory reused on the next run");
+    DISTRHO_ASSERT_EQUAL(instance.scratchBuffers[1], buffer1, "memory reused on the next run");
+
+    host.plugin.deactivate();
+    return 0;
+}
+
+// offline mode is visible from run(), the plugin is only told about actual changes
+static int testOfflineMode()
+{
+    TestHost host;
+    ProcessingTestPlugin& instance(*host.instance);
+
+    host.plugin.activate();
+    host.run(kBufferSize);
+    DISTRHO_ASSERT_EQUAL(instance.runOffline, false, "realtime by default");
+
+    host.plugin.setOffline(true, true);
+    host.plugin.setOffline(true, true);
+    host.run(kBufferSize);
+    DISTRHO_ASSERT_EQUAL(instance.runOffline, true, "offline seen in run");
+    DISTRHO_ASSERT_EQUAL(instance.processModeChangeCount, 1, "same mode does not trigger the callback again");
+
+    host.plugin.setOffline(false, true);
+    host.run(kBufferSize);
+    DISTRHO_ASSERT_EQUAL(instance.runOffline, false, "back to realtime");
+    DISTRHO_ASSERT_EQUAL(instance.processModeChangeCount, 2, "callback on each change");
+
+    host.plugin.deactivate();
+    return 0;
+}
+
+// a host-provided thread pool installed before activation is used instead of DPF's own one
+static bool hostExecuteParallel(void* const ptr, const uint32_t taskCount,
+                                const Plugin::ParallelTaskFunc callback, void* const callbackPtr)
+{
+    ++*static_cast<uint32_t*>(ptr);
+
+    for (uint32_t i=0; i < taskCount; ++i)
+        callback(callbackPtr, i);
+
+    return true;
+}
+
+static int testHostThreadPool()
+{
+    TestHost host;
+    uint32_t hostCalls = 0;
+
+    host.plugin.setThreadPoolCallback(&hostCalls, hostExecuteParallel);
+    host.plugin.activate();
+
+    host.instance->parallelTaskCount = 8;
+    host.run(kBufferSize);
+
+    DISTRHO_ASSERT_EQUAL(hostCalls, kRunsPerBuffer, "host thread pool used");
+    DISTRHO_ASSERT_EQUAL(host.instance->parallelTaskErrors, 0, "each task called once per execute");
+
+    host.plugin.deactivate();
+    return 0;
+}
+
+// the plugin is only idle once its input has been silent for the whole tail, even if its output is silent earlier
+static int testSilenceDetection()
+{
+    TestHost host;
+    ProcessingTestPlugin& instance(*host.instance);
+
+    instance.tailLength = kBufferSize + kBufferSize / 2;
+    host.plugin.activate();
+
+    host.input[0] = 1.f;
+    host.run(kBufferSize);
+    DISTRHO_ASSERT_EQUAL(host.plugin.isIdle(), false, "not idle with non-silent input");
+
+    host.input[0] = 0.f;
+    host.run(kBufferSize);
+    DISTRHO_ASSERT_EQUAL(host.plugin.isOutputSilent(), true, "output is silent");
+    DISTRHO_ASSERT_EQUAL(host.plugin.isIdle(), false, "not idle while the tail is still playing");
+
+    host.run(kBufferSize);
+    DISTRHO_ASSERT_EQUAL(host.plugin.isIdle(), true, "idle once the tail has played");
+
+    // MIDI counts as input
+    MidiEvent midiEvent;
+    setupMidiEvent(midiEvent, 0, 60);
+    host.run(kBufferSize, &midiEvent, 1);
+    DISTRHO_ASSERT_EQUAL(host.plugin.isIdle(), false, "MIDI input restarts the tail");
+
+    // infinite tail never goes idle
+    instance.tailLength = UINT32_MAX;
+    for (uint32_t i=0; i < 4; ++i)
+        host.run(kBufferSize);
+    DISTRHO_ASSERT_EQUAL(host.plugin.isIdle(), false, "infinite tail is never idle");
+
+    // no tail goes idle right away
+    instance.tailLength = 0;
+    host.run(kBufferSize, &midiEvent, 1);
+    host.run(kBufferSize);
+    DISTRHO_ASSERT_EQUAL(host.plugin.isIdle(), true, "no tail is idle after one silent run");
+
+    host.plugin.deactivate();
+    return 0;
+}
+
+// every ISA variant of a kernel gives the same result as the generic one
+static int testCpuDispatch()
+{
+    const CpuDispatchLevel level = d_getCpuDispatchLevel();
+    DISTRHO_ASSERT_EQUAL((level >= kCpuDispatchLevelGeneric && level <= kCpuDispatchLevelAVX512), true,
+                         "valid dispatch level");
+
+    float input[kBufferSize];
+    float output[kBufferSize];
+    for (uint32_t i=0; i < kBufferSize; ++i)
+        input[i] = static_cast<float>(i) * 0.1f;
+
+    // automatic dispatch, whatever variant the loader picked
+    applyGain(input, output, kBufferSize, 0.5f);
+    for (uint32_t i=0; i < kBufferSize; ++i)
+    {
+        DISTRHO_ASSERT_SAFE_EQUAL(output[i], input[i] * 0.5f, "dispatched kernel");
+    }
+
+   #if DISTRHO_CPU_TARGETS_AVAILABLE
+    // manual dispatch, only where supported by the running CPU
+    if (level >= kCpuDispatchLevelAVX2)
+    {
+        applyGainAVX2(input, output, kBufferSize, 0.5f);
+        for (uint32_t i=0; i < kBufferSize; ++i)
+        {
+            DISTRHO_ASSERT_SAFE_EQUAL(output[i], input[i] * 0.5f, "AVX2 kernel");
+        }
+    }
+   #endif
+
+    return 0;
+}
+
+#ifdef DPF_RT_SAFETY_CHECKS
+// nothing done by DPF or the test plugin in all the runs above allocated memory, must be the last test
+static int testRealtimeSafety()
+{
+    DISTRHO_ASSERT_EQUAL(d_isRealtimeThread(), false, "not realtime outside of run");
+    DISTRHO_ASSERT_EQUAL(d_getRealtimeAllocationCount(), 0, "no allocations during run");
+
+   #if DISTRHO_RT_SAFETY_HOOKS
+    // make sure allocations are actually detected, this prints a violation report
+    {
+        const ScopedRealtimeThread srt;
+        // volatile so the compiler cannot elide the allocation
+        int* volatile ptr = new int(0);
+        delete ptr;
+    }
+    DISTRHO_ASSERT_EQUAL((d_getRealtimeAllocationCount() != 0), true, "allocations are detected");
+   #endif
+
+    return 0;
+}
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    d_nextBufferSize = kBufferSize;
+    d_nextSampleRate = kSampleRate;
+
+   #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE == 0
+    if (const int ret = testSampleAccurateParameters())
+        return ret;
+
+    if (const int ret = testMidiEventSplit())
+        return ret;
+
+    if (const int ret = testParameterSmoothing())
+        return ret;
+   #else
+    if (const int ret = testFixedBlockSize())
+        return ret;
+   #endif
+
+    if (const int ret = testWorker())
+        return ret;
+
+    if (const int ret = testThreadPool())
+        return ret;
+
+   #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE == 0
+    if (const int ret = testOversampling())
+        return ret;
+   #endif
+
+   #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE == 0
+    if (const int ret = testPendingParameters())
+        return ret;
+   #endif
+
+    if (const int ret = testParameterSymbols())
+        return ret;
+
+    if (const int ret = testDspLoad())
+        return ret;
+
+    if (const int ret = testSharedParameters())
+        return ret;
+
+    if (const int ret = testDoublePrecision())
+        return ret;
+
+    if (const int ret = testOutputParameters())
+        return ret;
+
+    if (const int ret = testParameterBatches())
+        return ret;
+
+    if (const int ret = testScratchBuffers())
+        return ret;
+
+    if (const int ret = testOfflineMode())
+        return ret;
+
+    if (const int ret = testHostThreadPool())
+        return ret;
+
+    if (const int ret = testSilenceDetection())
+        return ret;
+
+    if (const int ret = testCpuDispatch())
+        return ret;
+
+   #ifdef DPF_RT_SAFETY_CHECKS
+    if (const int ret = testRealtimeSafety())
+        return ret;
+   #endif
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
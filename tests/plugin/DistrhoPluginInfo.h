@@ -0,0 +1,51 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef DISTRHO_PLUGIN_INFO_H_INCLUDED
+#define DISTRHO_PLUGIN_INFO_H_INCLUDED
+
+// plugin used by the PluginProcessing test, with the processing features under test turned on
+// DISTRHO_PLUGIN_FIXED_BLOCK_SIZE is set from the command line by the ".fixed" test variant
+
+#define DISTRHO_PLUGIN_BRAND   "DISTRHO"
+#define DISTRHO_PLUGIN_NAME    "PluginProcessing"
+#define DISTRHO_PLUGIN_URI     "http://distrho.sf.net/tests/PluginProcessing"
+#define DISTRHO_PLUGIN_CLAP_ID "studio.kx.distrho.tests.plugin-processing"
+
+#define DISTRHO_PLUGIN_BRAND_ID  Dstr
+#define DISTRHO_PLUGIN_UNIQUE_ID dTpp
+
+#define DISTRHO_PLUGIN_HAS_UI        0
+#define DISTRHO_PLUGIN_IS_RT_SAFE    1
+#define DISTRHO_PLUGIN_NUM_INPUTS    1
+#define DISTRHO_PLUGIN_NUM_OUTPUTS   2
+
+#define DISTRHO_PLUGIN_WANT_MIDI_INPUT                 1
+#define DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS 1
+#define DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION           1
+#define DISTRHO_PLUGIN_WANT_DSP_LOAD                   1
+#define DISTRHO_PLUGIN_WANT_WORKER                     1
+#define DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION         1
+#define DISTRHO_PLUGIN_WANT_SILENCE_DETECTION          1
+#define DISTRHO_PLUGIN_WANT_OVERSAMPLING               1
+#define DISTRHO_PLUGIN_OVERSAMPLING_FACTOR             1
+#define DISTRHO_PLUGIN_WANT_PARAMETER_SMOOTHING        1
+#define DISTRHO_PLUGIN_SCRATCH_BUFFER_COUNT            2
+#define DISTRHO_PLUGIN_WANT_THREAD_SAFE_PARAMETERS     1
+#define DISTRHO_PLUGIN_WANT_PARAMETER_OUTPUT_TRACKING  1
+#define DISTRHO_PLUGIN_WANT_SHARED_PARAMETERS          1
+
+#endif // DISTRHO_PLUGIN_INFO_H_INCLUDED